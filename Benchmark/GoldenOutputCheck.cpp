@@ -0,0 +1,159 @@
+// Renders fixed inputs through every reverb algorithm and compares them with reference renders from a known-good build
+
+#include "GoldenOutputCheck.h"
+#include "GoldenRenders.h"
+
+#include <iostream>
+
+namespace
+{
+struct Tolerances
+{
+    // largest sample difference, relative to the reference peak
+    double differenceDb = -60.0;
+    // largest difference in any octave band level, for bands within bandRangeDb of the loudest, since near-empty bands
+    // are all rounding noise
+    double bandDb = 0.5;
+    double bandRangeDb = 60.0;
+    // largest relative difference in the T30 estimate
+    double rt60Ratio = 0.05;
+};
+
+//==============================================================================
+// raw float32 in native byte order, one channel after another
+bool writeReference(const juce::File& file, const juce::AudioBuffer<float>& buffer)
+{
+    file.deleteFile();
+    juce::FileOutputStream stream(file);
+    if (!stream.openedOk())
+        return false;
+
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        stream.write(buffer.getReadPointer(channel), sizeof(float) * static_cast<size_t>(buffer.getNumSamples()));
+
+    stream.flush();
+    return stream.getStatus().wasOk();
+}
+
+bool readReference(const juce::File& file, juce::AudioBuffer<float>& buffer)
+{
+    juce::MemoryBlock data;
+    if (!file.loadFileAsData(data) ||
+        data.getSize() != sizeof(float) * static_cast<size_t>(buffer.getNumChannels() * buffer.getNumSamples()))
+        return false;
+
+    auto* samples = static_cast<const float*>(data.getData());
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        buffer.copyFrom(channel, 0, samples + channel * buffer.getNumSamples(), buffer.getNumSamples());
+
+    return true;
+}
+
+//==============================================================================
+double getDifferenceDb(const juce::AudioBuffer<float>& reference, const juce::AudioBuffer<float>& output)
+{
+    float peak = reference.getMagnitude(0, reference.getNumSamples());
+    float maxDifference = 0;
+
+    for (int channel = 0; channel < reference.getNumChannels(); ++channel)
+        for (int sample = 0; sample < reference.getNumSamples(); ++sample)
+            maxDifference = std::max(maxDifference, std::abs(reference.getSample(channel, sample) -
+                                                             output.getSample(channel, sample)));
+
+    if (peak <= 0.0f)
+        return maxDifference > 0.0f ? 0.0 : -200.0;
+
+    return juce::Decibels::gainToDecibels(static_cast<double>(maxDifference / peak), -200.0);
+}
+
+double getBandDifferenceDb(const juce::AudioBuffer<float>& reference, const juce::AudioBuffer<float>& output,
+                           double bandRangeDb)
+{
+    auto referenceLevels = GoldenRenders::getOctaveBandLevels(reference);
+    auto outputLevels = GoldenRenders::getOctaveBandLevels(output);
+    double loudestBand = *std::max_element(referenceLevels.begin(), referenceLevels.end());
+
+    double maxDifference = 0;
+    for (size_t band = 0; band < referenceLevels.size(); ++band)
+        if (referenceLevels[band] > loudestBand - bandRangeDb)
+            maxDifference = std::max(maxDifference, std::abs(referenceLevels[band] - outputLevels[band]));
+
+    return maxDifference;
+}
+} // namespace
+
+void runGoldenOutputCheck(const juce::ArgumentList& args)
+{
+    bool writing = args.containsOption("--write");
+    if (writing == args.containsOption("--check"))
+        juce::ConsoleApplication::fail("Give one of --write=<folder> or --check=<folder>");
+
+    auto folder = args.getFileForOption(writing ? "--write" : "--check");
+    if (writing && folder.createDirectory().failed())
+        juce::ConsoleApplication::fail("Couldn't create " + folder.getFullPathName());
+
+    Tolerances tolerances;
+    if (args.containsOption("--tolerance"))
+        tolerances.differenceDb = args.getValueForOption("--tolerance").getDoubleValue();
+
+    auto processorNames = GoldenRenders::getProcessorNames();
+    int numRenders = 0;
+    int numFailures = 0;
+
+    for (int type = 0; type < processorNames.size(); ++type)
+    {
+        for (const auto& setting : GoldenRenders::getSettings())
+        {
+            for (const auto& inputName : GoldenRenders::getInputNames())
+            {
+                auto processor = GoldenRenders::createProcessor(type);
+                auto output =
+                    GoldenRenders::render(*processor, setting.params, GoldenRenders::makeInput(inputName));
+                auto file = folder.getChildFile(processorNames[type] + "_" + setting.name + "_" + inputName + ".f32");
+                ++numRenders;
+
+                if (writing)
+                {
+                    if (!writeReference(file, output))
+                        juce::ConsoleApplication::fail("Couldn't write " + file.getFullPathName());
+
+                    std::cout << "wrote " << file.getFileName() << std::endl;
+                    continue;
+                }
+
+                juce::AudioBuffer<float> reference(output.getNumChannels(), output.getNumSamples());
+                if (!readReference(file, reference))
+                {
+                    std::cout << "MISSING " << file.getFileName() << std::endl;
+                    ++numFailures;
+                    continue;
+                }
+
+                double differenceDb = getDifferenceDb(reference, output);
+                double bandDb = getBandDifferenceDb(reference, output, tolerances.bandRangeDb);
+                double referenceRT60 = GoldenRenders::getRT60(reference);
+                double outputRT60 = GoldenRenders::getRT60(output);
+
+                // a render that decays by 35 dB must still do so, and at about the same rate
+                bool rt60Matches = referenceRT60 < 0.0
+                                       ? outputRT60 < 0.0
+                                       : outputRT60 >= 0.0 && std::abs(outputRT60 - referenceRT60) <=
+                                                                  tolerances.rt60Ratio * referenceRT60;
+                bool passed =
+                    differenceDb <= tolerances.differenceDb && bandDb <= tolerances.bandDb && rt60Matches;
+
+                if (!passed)
+                    ++numFailures;
+
+                std::cout << (passed ? "ok   " : "FAIL ") << file.getFileNameWithoutExtension() << ": difference "
+                          << juce::String(differenceDb, 1) << " dB, bands " << juce::String(bandDb, 2) << " dB, RT60 "
+                          << juce::String(referenceRT60, 2) << " -> " << juce::String(outputRT60, 2) << " s"
+                          << std::endl;
+            }
+        }
+    }
+
+    if (!writing && numFailures > 0)
+        juce::ConsoleApplication::fail(juce::String(numFailures) + " of " + juce::String(numRenders) +
+                                       " renders diverged from " + folder.getFullPathName());
+}
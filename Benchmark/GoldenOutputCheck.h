@@ -0,0 +1,7 @@
+// Renders fixed inputs through every reverb algorithm and compares them with reference renders from a known-good build
+
+#pragma once
+
+#include <JuceHeader.h>
+
+void runGoldenOutputCheck(const juce::ArgumentList& args);
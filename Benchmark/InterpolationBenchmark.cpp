@@ -0,0 +1,79 @@
+// Cost per tap of each DelayLineWithSampleAccess read
+
+#include "InterpolationBenchmark.h"
+#include "CustomDelays.h"
+
+#include <iostream>
+
+namespace
+{
+constexpr int delayLength = 65536;
+
+// reads numTaps taps per sample for numSamples samples; returns ns per tap
+template <typename ReadTaps> double timeReads(int numSamples, int numTaps, ReadTaps&& readTaps)
+{
+    DelayLineWithSampleAccess<float> delayLine(delayLength);
+    delayLine.prepare({44100.0, 512, 1});
+
+    juce::Random random(1);
+    for (int sample = 0; sample < delayLength; ++sample)
+        delayLine.pushSample(0, random.nextFloat() * 2.0f - 1.0f);
+
+    // spread the taps over the whole line so they don't share cache lines
+    std::vector<float> delays(static_cast<size_t>(numTaps));
+    for (auto& delay : delays)
+        delay = 1.0f + random.nextFloat() * (delayLength - 8);
+
+    // drawn before timing starts, so only the pushes and reads are timed
+    std::vector<float> input(static_cast<size_t>(numSamples));
+    for (auto& value : input)
+        value = random.nextFloat();
+
+    std::vector<float> output(static_cast<size_t>(numTaps));
+    float sum = 0.0f;
+
+    auto start = juce::Time::getHighResolutionTicks();
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        delayLine.pushSample(0, input[static_cast<size_t>(sample)]);
+        readTaps(delayLine, delays.data(), output.data(), numTaps);
+        for (float value : output)
+            sum += value;
+    }
+    auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+    // every tap feeds the sum, so none of the reads can be optimised away
+    if (sum == 12345.0f)
+        std::cout << "";
+
+    return elapsed * 1.0e9 / (static_cast<double>(numSamples) * numTaps);
+}
+} // namespace
+
+void runInterpolationBenchmark(const juce::ArgumentList& args)
+{
+    int numSamples = args.containsOption("--samples") ? args.getValueForOption("--samples").getIntValue() : 1 << 20;
+
+    std::cout << "ns per tap over " << numSamples << " samples" << std::endl;
+    std::cout << "taps\tinteger\tlinear\tlagrange\tallpass" << std::endl;
+
+    for (int numTaps : {1, 4, 8, 16, 32})
+    {
+        double integerRead = timeReads(numSamples, numTaps, [](auto& delayLine, auto* delays, auto* output, int taps) {
+            for (int tap = 0; tap < taps; ++tap)
+                output[tap] = delayLine.getSampleAtDelay(0, static_cast<int>(delays[tap]));
+        });
+
+        std::vector<float> allpassState(static_cast<size_t>(numTaps));
+        auto interpolatedRead = [&](DelayInterpolation interpolation) {
+            return timeReads(numSamples, numTaps, [&](auto& delayLine, auto* delays, auto* output, int taps) {
+                delayLine.getSamplesAtDelays(0, delays, output, taps, interpolation, allpassState.data());
+            });
+        };
+
+        std::cout << numTaps << "\t" << juce::String(integerRead, 2) << "\t"
+                  << juce::String(interpolatedRead(DelayInterpolation::linear), 2) << "\t"
+                  << juce::String(interpolatedRead(DelayInterpolation::lagrange3rd), 2) << "\t\t"
+                  << juce::String(interpolatedRead(DelayInterpolation::allpass), 2) << std::endl;
+    }
+}
@@ -0,0 +1,7 @@
+// Cost per tap of each DelayLineWithSampleAccess read
+
+#pragma once
+
+#include <JuceHeader.h>
+
+void runInterpolationBenchmark(const juce::ArgumentList& args);
@@ -0,0 +1,53 @@
+// Headless benchmarks for the reverb DSP
+
+#include <JuceHeader.h>
+
+#include "GoldenOutputCheck.h"
+#include "InterpolationBenchmark.h"
+#include "ProcessorBenchmark.h"
+#include "StorageBenchmark.h"
+#include "TailBenchmark.h"
+
+int main(int argc, char* argv[])
+{
+    juce::ConsoleApplication app;
+
+    app.addHelpCommand("--help|-h", "Usage:", true);
+    app.addCommand({"--interpolation", "--interpolation [--samples=<n>]",
+                    "Cost per tap of integer, linear, Lagrange and allpass delay reads", juce::String(),
+                    [](const juce::ArgumentList& args) { runInterpolationBenchmark(args); }});
+    app.addCommand({"--processors",
+                    "--processors [--sample-rates=<list>] [--block-sizes=<list>] [--channels=<list>] "
+                    "[--rate-factors=<list>] [--channel-threads] [--quality-tiers] [--seconds=<s>] [--json=<file>]",
+                    "ns/sample, real-time factor and throughput of every reverb algorithm, as JSON",
+                    "Lists are comma-separated. Defaults are 44.1-192 kHz, 16-4096 sample blocks, 1 and 2 channels "
+                    "and 1 second of audio per run. --rate-factors runs the algorithms at the host rate over each "
+                    "factor (1, 2 or 4; default 1) as the Internal Rate parameter does. --channel-threads runs "
+                    "each channel on its own thread, as the Channel Threads parameter does, whatever the block size. "
+                    "--quality-tiers runs every quality tier of each algorithm, rather than only the top one. "
+                    "JSON goes to stdout unless --json is given; progress goes to stderr.",
+                    [](const juce::ArgumentList& args) { runProcessorBenchmark(args); }});
+    app.addCommand({"--golden", "--golden (--write=<folder> | --check=<folder>) [--tolerance=<dB>]",
+                    "Renders every reverb algorithm and compares it with reference renders",
+                    "--write renders impulse and noise inputs through every algorithm and the early reflections at "
+                    "three settings, into the folder. --check renders them again and exits with an error if any "
+                    "differs from the reference by more than --tolerance (default -60 dB relative to its peak), by "
+                    "more than 0.5 dB in any octave band, or by more than 5% in RT60.",
+                    [](const juce::ArgumentList& args) { runGoldenOutputCheck(args); }});
+    app.addCommand({"--storage", "--storage [--instances=<n>] [--seconds=<s>]",
+                    "Cost, memory and noise floor of float, fp16 and bf16 delay-line storage",
+                    "Runs --instances (default 48) stereo feedback delays side by side with each storage type, so "
+                    "their histories overflow the caches, and reports KiB, ns per sample per channel and the level "
+                    "of the difference from the float render.",
+                    [](const juce::ArgumentList& args) { runStorageBenchmark(args); }});
+    app.addCommand({"--tail", "--tail [--seconds=<s>] [--sample-rate=<hz>] [--block-size=<n>] [--json=<file>]",
+                    "CPU cost of every reverb algorithm through a decaying tail, with and without flush-to-zero",
+                    "Renders a second of noise and then --seconds (default 60) of silence through every algorithm at "
+                    "--sample-rate (default 48000) in blocks of --block-size (default 512), timing each second. Each "
+                    "algorithm runs once with flush-to-zero on, as the plugin runs it, and once with it off, as when "
+                    "a host turns it off; the difference shows what subnormal tail state costs. JSON goes to stdout "
+                    "unless --json is given; progress goes to stderr.",
+                    [](const juce::ArgumentList& args) { runTailBenchmark(args); }});
+
+    return app.findAndRunCommand(argc, argv);
+}
@@ -0,0 +1,216 @@
+// CPU cost of every reverb algorithm over a matrix of sample rates, block sizes and channel counts
+
+#include "ProcessorBenchmark.h"
+#include "ChannelWorkerPool.h"
+#include "EarlyReflections.h"
+#include "MultirateReverb.h"
+#include "ProcessorFactory.h"
+#include "QualityTiers.h"
+
+#include <iostream>
+
+namespace
+{
+struct BenchmarkResult
+{
+    double nsPerSample = 0;
+    double realTimeFactor = 0;
+    double samplesPerSecond = 0;
+};
+
+// comma-separated list option, e.g. --block-sizes=64,512
+std::vector<double> getListOption(const juce::ArgumentList& args, const juce::String& option,
+                                  std::vector<double> defaultValues)
+{
+    if (!args.containsOption(option))
+        return defaultValues;
+
+    std::vector<double> values;
+    for (const auto& token : juce::StringArray::fromTokens(args.getValueForOption(option), ",", ""))
+        if (token.trim().isNotEmpty())
+            values.push_back(token.getDoubleValue());
+
+    return values;
+}
+
+// the plugin's default parameter values, mapped as PluginProcessor::processBlock maps them
+ReverbProcessorParameters getDefaultParameters()
+{
+    ReverbProcessorParameters params;
+    params.damping = scale(0.5f * -1.0f + 1.0f, 0.0f, 1.0f, 200.0f, 20000.0f);
+    params.decayTime = 0.35f;
+    params.diffusion = 0.67f;
+    params.modDepth = 0.5f;
+    params.modRate = 2.25f;
+    params.roomSize = 0.5f;
+    return params;
+}
+
+BenchmarkResult timeProcessor(ReverbProcessorBase& processor, const ReverbProcessorParameters& params,
+                              double sampleRate, int blockSize, int numChannels, double seconds,
+                              ChannelWorkerPool* channelWorkers, int qualityTier)
+{
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate = sampleRate;
+    spec.maximumBlockSize = static_cast<juce::uint32>(blockSize);
+    spec.numChannels = static_cast<juce::uint32>(numChannels);
+
+    processor.prepare(spec);
+    processor.setParameters(params);
+    processor.setChannelWorkers(channelWorkers);
+    processor.setQualityTier(qualityTier);
+
+    // the plugin's callback runs the algorithms with flush-to-zero on
+    juce::ScopedNoDenormals noDenormals;
+
+    // white noise input, refilled before every block so the reverbs never settle into silence
+    juce::AudioBuffer<float> input(numChannels, blockSize);
+    juce::Random random(1);
+    for (int channel = 0; channel < numChannels; ++channel)
+        for (int sample = 0; sample < blockSize; ++sample)
+            input.setSample(channel, sample, random.nextFloat() * 0.5f - 0.25f);
+
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::MidiBuffer midiMessages;
+
+    // untimed blocks so first-use allocations aren't counted, nor a lower tier's fade from the top one
+    int numWarmUpBlocks =
+        qualityTier > 0 ? static_cast<int>(std::ceil(TierFade::fadeSeconds * sampleRate / blockSize)) + 1 : 1;
+    for (int block = 0; block < numWarmUpBlocks; ++block)
+    {
+        buffer.makeCopyOf(input, true);
+        processor.processBlock(buffer, midiMessages);
+    }
+
+    int numBlocks = juce::jmax(1, static_cast<int>(std::ceil(seconds * sampleRate / blockSize)));
+    juce::int64 ticks = 0;
+
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        buffer.makeCopyOf(input, true);
+
+        auto start = juce::Time::getHighResolutionTicks();
+        processor.processBlock(buffer, midiMessages);
+        ticks += juce::Time::getHighResolutionTicks() - start;
+    }
+
+    double elapsed = juce::Time::highResolutionTicksToSeconds(ticks);
+    double numFrames = static_cast<double>(numBlocks) * blockSize;
+
+    BenchmarkResult result;
+    result.nsPerSample = elapsed * 1.0e9 / numFrames;
+    result.realTimeFactor = (numFrames / sampleRate) / elapsed;
+    result.samplesPerSecond = numFrames * numChannels / elapsed;
+    return result;
+}
+} // namespace
+
+void runProcessorBenchmark(const juce::ArgumentList& args)
+{
+    auto sampleRates = getListOption(args, "--sample-rates", {44100, 48000, 88200, 96000, 176400, 192000});
+    auto blockSizes = getListOption(args, "--block-sizes", {16, 32, 64, 128, 256, 512, 1024, 2048, 4096});
+    auto channelCounts = getListOption(args, "--channels", {1, 2});
+    auto rateFactors = getListOption(args, "--rate-factors", {1});
+    double seconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 1.0;
+    bool channelThreads = args.containsOption("--channel-threads");
+    bool qualityTiers = args.containsOption("--quality-tiers");
+
+    // every factory entry, then the early reflections, which the plugin runs alongside whichever one is selected
+    ProcessorFactory processorFactory;
+    auto processorNames = ProcessorFactory::getProcessorNames();
+    processorNames.add("EarlyReflections");
+
+    auto params = getDefaultParameters();
+    ReverbProcessorParameters earlyParams;
+    earlyParams.decayTime = 0.35f;
+    earlyParams.roomSize = 0.5f;
+
+    // with --channel-threads, a worker for every channel beyond the first, as the plugin has
+    ChannelWorkerPool channelWorkers;
+
+    juce::Array<juce::var> results;
+
+    for (int type = 0; type < processorNames.size(); ++type)
+    {
+        for (auto sampleRate : sampleRates)
+        {
+            for (auto blockSize : blockSizes)
+            {
+                for (auto numChannels : channelCounts)
+                {
+                    for (auto rateFactor : rateFactors)
+                    {
+                        // a fresh instance for every run, as the plugin creates one when the algorithm changes; the
+                        // early reflections always run at the host rate
+                        bool isEarlyReflections = type >= processorFactory.getNumProcessors();
+                        if (isEarlyReflections && rateFactor != 1)
+                            continue;
+
+                        auto createProcessor = [&]() {
+                            std::unique_ptr<ReverbProcessorBase> processor =
+                                isEarlyReflections ? std::make_unique<EarlyReflections>()
+                                                   : processorFactory.create(type);
+                            if (rateFactor > 1)
+                                processor = std::make_unique<MultirateReverb>(std::move(processor),
+                                                                              static_cast<int>(rateFactor));
+                            return processor;
+                        };
+
+                        if (channelThreads)
+                            channelWorkers.prepare(static_cast<int>(numChannels) - 1);
+
+                        // with --quality-tiers, every tier the algorithm has, each on its own instance
+                        auto processor = createProcessor();
+                        int numTiers = qualityTiers ? processor->getNumQualityTiers() : 1;
+
+                        for (int tier = 0; tier < numTiers; ++tier)
+                        {
+                            if (tier > 0)
+                                processor = createProcessor();
+
+                            auto result = timeProcessor(*processor, isEarlyReflections ? earlyParams : params,
+                                                        sampleRate, static_cast<int>(blockSize),
+                                                        static_cast<int>(numChannels), seconds,
+                                                        channelThreads ? &channelWorkers : nullptr, tier);
+
+                            auto* entry = new juce::DynamicObject();
+                            entry->setProperty("processor", processorNames[type]);
+                            entry->setProperty("sampleRate", sampleRate);
+                            entry->setProperty("blockSize", static_cast<int>(blockSize));
+                            entry->setProperty("channels", static_cast<int>(numChannels));
+                            entry->setProperty("rateFactor", static_cast<int>(rateFactor));
+                            entry->setProperty("qualityTier", tier);
+                            entry->setProperty("nsPerSample", result.nsPerSample);
+                            entry->setProperty("realTimeFactor", result.realTimeFactor);
+                            entry->setProperty("samplesPerSecond", result.samplesPerSecond);
+                            results.add(juce::var(entry));
+
+                            std::cerr << processorNames[type] << " " << sampleRate << " Hz / " << rateFactor
+                                      << ", tier " << tier << ", " << blockSize << " samples, " << numChannels
+                                      << " ch: " << juce::String(result.nsPerSample, 1) << " ns/sample, "
+                                      << juce::String(result.realTimeFactor, 1) << "x real time" << std::endl;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    auto* report = new juce::DynamicObject();
+    report->setProperty("secondsPerRun", seconds);
+    report->setProperty("channelThreads", channelThreads);
+    report->setProperty("qualityTiers", qualityTiers);
+    report->setProperty("results", results);
+    auto json = juce::JSON::toString(juce::var(report));
+
+    if (args.containsOption("--json"))
+    {
+        auto file = args.getFileForOption("--json");
+        if (!file.replaceWithText(json))
+            juce::ConsoleApplication::fail("Couldn't write " + file.getFullPathName());
+    }
+    else
+    {
+        std::cout << json << std::endl;
+    }
+}
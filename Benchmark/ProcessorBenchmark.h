@@ -0,0 +1,7 @@
+// CPU cost of every reverb algorithm over a matrix of sample rates, block sizes and channel counts
+
+#pragma once
+
+#include <JuceHeader.h>
+
+void runProcessorBenchmark(const juce::ArgumentList& args);
@@ -0,0 +1,123 @@
+// Cost, memory and noise floor of float, Float16 and BFloat16 delay-line storage
+
+#include "StorageBenchmark.h"
+#include "CustomDelays.h"
+
+#include <iostream>
+
+namespace
+{
+constexpr double sampleRate = 44100.0;
+constexpr int numChannels = 2;
+constexpr int maxDelay = 22050;
+constexpr int numTaps = 4;
+constexpr float feedbackGain = 0.85f;
+
+struct NetworkResult
+{
+    double nsPerSample = 0;
+    size_t memoryBytes = 0;
+    std::vector<float> output;
+};
+
+/*
+numInstances multi-tap feedback combs, each with as long a line as the reverbs use, run side by side so that their
+histories together are far larger than the caches, as they are when a session has many reverbs open. The output is
+the first channel summed over every instance.
+*/
+template <typename StorageType> NetworkResult runNetwork(int numInstances, int numSamples)
+{
+    using DelayLine = DelayLineWithSampleAccess<float, StorageType>;
+
+    std::vector<std::unique_ptr<DelayLine>> delayLines;
+    std::vector<std::array<float, numTaps>> delays;
+    juce::Random random(1);
+
+    NetworkResult result;
+    for (int instance = 0; instance < numInstances; ++instance)
+    {
+        delayLines.push_back(std::make_unique<DelayLine>(maxDelay));
+        delayLines.back()->prepare({sampleRate, 512, static_cast<juce::uint32>(numChannels)});
+        result.memoryBytes += delayLines.back()->getMemoryUsage();
+
+        std::array<float, numTaps> instanceDelays;
+        for (auto& delay : instanceDelays)
+            delay = 1000.0f + random.nextFloat() * (maxDelay - 1010);
+        delays.push_back(instanceDelays);
+    }
+
+    // half a second of noise, then the tail
+    std::vector<float> input(static_cast<size_t>(numSamples));
+    for (int sample = 0; sample < std::min(numSamples, static_cast<int>(sampleRate / 2)); ++sample)
+        input[static_cast<size_t>(sample)] = random.nextFloat() - 0.5f;
+
+    result.output.resize(static_cast<size_t>(numSamples));
+
+    auto start = juce::Time::getHighResolutionTicks();
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        float sum = 0.0f;
+        for (int instance = 0; instance < numInstances; ++instance)
+        {
+            auto& delayLine = *delayLines[static_cast<size_t>(instance)];
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                float feedback = delayLine.getInterpolatedSum(channel, delays[static_cast<size_t>(instance)].data(),
+                                                              numTaps, feedbackGain / numTaps);
+                float output = input[static_cast<size_t>(sample)] + feedback;
+                delayLine.pushSample(channel, output);
+
+                if (channel == 0)
+                    sum += output;
+            }
+        }
+        result.output[static_cast<size_t>(sample)] = sum;
+    }
+    auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+    result.nsPerSample = elapsed * 1.0e9 / (static_cast<double>(numSamples) * numInstances * numChannels);
+    return result;
+}
+
+// level of the difference from the float render, relative to the float render, in dB
+double getErrorDb(const std::vector<float>& reference, const std::vector<float>& output)
+{
+    double referenceSquares = 0;
+    double errorSquares = 0;
+    for (size_t sample = 0; sample < reference.size(); ++sample)
+    {
+        double error = static_cast<double>(output[sample]) - reference[sample];
+        referenceSquares += static_cast<double>(reference[sample]) * reference[sample];
+        errorSquares += error * error;
+    }
+
+    if (errorSquares == 0)
+        return -200.0;
+
+    return 10.0 * std::log10(errorSquares / referenceSquares);
+}
+} // namespace
+
+void runStorageBenchmark(const juce::ArgumentList& args)
+{
+    int numInstances =
+        args.containsOption("--instances") ? args.getValueForOption("--instances").getIntValue() : 48;
+    double seconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 4.0;
+    int numSamples = static_cast<int>(seconds * sampleRate);
+
+    auto floatResult = runNetwork<float>(numInstances, numSamples);
+    auto float16Result = runNetwork<Float16>(numInstances, numSamples);
+    auto bfloat16Result = runNetwork<BFloat16>(numInstances, numSamples);
+
+    std::cout << numInstances << " stereo " << numTaps << "-tap feedback delays of " << maxDelay << " samples, "
+              << seconds << " s" << (RSAV_HAS_F16C ? ", F16C" : ", software fp16") << std::endl;
+    std::cout << "storage\tKiB\tns/sample\terror re float (dB)" << std::endl;
+
+    for (auto [name, result] : {std::pair<const char*, const NetworkResult*>{"float", &floatResult},
+                                {"fp16", &float16Result},
+                                {"bf16", &bfloat16Result}})
+    {
+        std::cout << name << "\t" << result->memoryBytes / 1024 << "\t" << juce::String(result->nsPerSample, 2)
+                  << "\t\t" << juce::String(getErrorDb(floatResult.output, result->output), 1) << std::endl;
+    }
+}
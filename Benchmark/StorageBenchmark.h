@@ -0,0 +1,7 @@
+// Cost, memory and noise floor of float, Float16 and BFloat16 delay-line storage
+
+#pragma once
+
+#include <JuceHeader.h>
+
+void runStorageBenchmark(const juce::ArgumentList& args);
@@ -0,0 +1,166 @@
+// CPU cost of every reverb algorithm through a long decaying tail, with and without flush-to-zero
+
+#include "TailBenchmark.h"
+#include "Denormals.h"
+#include "ProcessorFactory.h"
+
+#include <iostream>
+#include <numeric>
+#include <optional>
+
+namespace
+{
+constexpr int numChannels = 2;
+
+struct TailResult
+{
+    // per second of audio, the first being the noise burst
+    std::vector<double> nsPerSample;
+    std::vector<int> subnormals;
+};
+
+// the plugin's default parameter values, mapped as PluginProcessor::processBlock maps them
+ReverbProcessorParameters getDefaultParameters()
+{
+    ReverbProcessorParameters params;
+    params.damping = scale(0.5f * -1.0f + 1.0f, 0.0f, 1.0f, 200.0f, 20000.0f);
+    params.decayTime = 0.35f;
+    params.diffusion = 0.67f;
+    params.modDepth = 0.5f;
+    params.modRate = 2.25f;
+    params.roomSize = 0.5f;
+    return params;
+}
+
+/*
+A second of white noise, then tailSeconds of silence, timed a second at a time. Without flush-to-zero the tail's
+state decays into the subnormal range within a few seconds, and the seconds after that show what it costs; the
+subnormal count is of the output, so state that's subnormal inside the algorithm only shows in the timings.
+*/
+TailResult runTail(ReverbProcessorBase& processor, double sampleRate, int blockSize, double tailSeconds,
+                   bool flushToZero)
+{
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate = sampleRate;
+    spec.maximumBlockSize = static_cast<juce::uint32>(blockSize);
+    spec.numChannels = static_cast<juce::uint32>(numChannels);
+
+    processor.prepare(spec);
+    processor.setParameters(getDefaultParameters());
+
+    // the plugin's callback, or a host that has turned flush-to-zero off on the audio thread
+    std::optional<juce::ScopedNoDenormals> noDenormals;
+    if (flushToZero)
+        noDenormals.emplace();
+
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::MidiBuffer midiMessages;
+    juce::Random random(1);
+
+    int blocksPerSecond = juce::jmax(1, static_cast<int>(sampleRate / blockSize));
+    int numSeconds = 1 + juce::jmax(1, static_cast<int>(std::ceil(tailSeconds)));
+
+    TailResult result;
+    for (int second = 0; second < numSeconds; ++second)
+    {
+        juce::int64 ticks = 0;
+        int subnormals = 0;
+
+        for (int block = 0; block < blocksPerSecond; ++block)
+        {
+            if (second == 0)
+            {
+                for (int channel = 0; channel < numChannels; ++channel)
+                    for (int sample = 0; sample < blockSize; ++sample)
+                        buffer.setSample(channel, sample, random.nextFloat() * 0.5f - 0.25f);
+            }
+            else
+            {
+                buffer.clear();
+            }
+
+            // as the plugin feeds the algorithm; only adds anything when built with RSAV_DENORMAL_NOISE=1
+            addDenormalNoise(buffer, blockSize);
+
+            auto start = juce::Time::getHighResolutionTicks();
+            processor.processBlock(buffer, midiMessages);
+            ticks += juce::Time::getHighResolutionTicks() - start;
+
+            subnormals += countSubnormals(buffer, blockSize);
+        }
+
+        double numFrames = static_cast<double>(blocksPerSecond) * blockSize;
+        result.nsPerSample.push_back(juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e9 / numFrames);
+        result.subnormals.push_back(subnormals);
+    }
+
+    return result;
+}
+} // namespace
+
+void runTailBenchmark(const juce::ArgumentList& args)
+{
+    double sampleRate =
+        args.containsOption("--sample-rate") ? args.getValueForOption("--sample-rate").getDoubleValue() : 48000.0;
+    int blockSize = args.containsOption("--block-size") ? args.getValueForOption("--block-size").getIntValue() : 512;
+    double tailSeconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 60.0;
+
+    ProcessorFactory processorFactory;
+    auto processorNames = ProcessorFactory::getProcessorNames();
+
+    juce::Array<juce::var> results;
+
+    for (int type = 0; type < processorFactory.getNumProcessors(); ++type)
+    {
+        for (bool flushToZero : {true, false})
+        {
+            // a fresh instance for each run, so neither starts with the other's tail
+            auto processor = processorFactory.create(type);
+            if (processor == nullptr)
+                continue;
+
+            auto result = runTail(*processor, sampleRate, blockSize, tailSeconds, flushToZero);
+
+            // the worst second of the tail against the burst, which has no subnormals to slow it
+            double burstNsPerSample = result.nsPerSample.front();
+            double worstTailNsPerSample = *std::max_element(result.nsPerSample.begin() + 1, result.nsPerSample.end());
+            int totalSubnormals = std::accumulate(result.subnormals.begin(), result.subnormals.end(), 0);
+
+            juce::Array<juce::var> nsPerSecond;
+            for (auto nsPerSample : result.nsPerSample)
+                nsPerSecond.add(nsPerSample);
+
+            auto* entry = new juce::DynamicObject();
+            entry->setProperty("processor", processorNames[type]);
+            entry->setProperty("flushToZero", flushToZero);
+            entry->setProperty("nsPerSample", nsPerSecond);
+            entry->setProperty("worstTailRatio", worstTailNsPerSample / burstNsPerSample);
+            entry->setProperty("subnormalSamples", totalSubnormals);
+            results.add(juce::var(entry));
+
+            std::cerr << processorNames[type] << (flushToZero ? ", flush-to-zero: " : ", no flush-to-zero: ")
+                      << juce::String(burstNsPerSample, 1) << " ns/sample during the burst, worst tail second "
+                      << juce::String(worstTailNsPerSample / burstNsPerSample, 2) << "x, " << totalSubnormals
+                      << " subnormal output samples" << std::endl;
+        }
+    }
+
+    auto* report = new juce::DynamicObject();
+    report->setProperty("sampleRate", sampleRate);
+    report->setProperty("blockSize", blockSize);
+    report->setProperty("tailSeconds", tailSeconds);
+    report->setProperty("denormalNoise", RSAV_DENORMAL_NOISE != 0);
+    report->setProperty("results", results);
+    auto json = juce::JSON::toString(juce::var(report));
+
+    if (args.containsOption("--json"))
+    {
+        auto file = args.getFileForOption("--json");
+        if (!file.replaceWithText(json))
+            juce::ConsoleApplication::fail("Couldn't write " + file.getFullPathName());
+    }
+    else
+    {
+        std::cout << json << std::endl;
+    }
+}
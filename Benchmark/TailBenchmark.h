@@ -0,0 +1,7 @@
+// CPU cost of every reverb algorithm through a long decaying tail, with and without flush-to-zero
+
+#pragma once
+
+#include <JuceHeader.h>
+
+void runTailBenchmark(const juce::ArgumentList& args);
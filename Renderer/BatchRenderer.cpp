@@ -0,0 +1,125 @@
+// Renders many files concurrently, one OfflineRenderer per worker thread
+
+#include "BatchRenderer.h"
+
+namespace
+{
+// state shared between the workers and the thread reporting progress
+struct BatchState
+{
+    explicit BatchState(const std::vector<RenderJob>& batchJobs) : jobs(batchJobs)
+    {
+    }
+
+    const std::vector<RenderJob>& jobs;
+
+    // files are claimed one at a time, so a long file never holds up the queue behind it
+    std::atomic<int> nextJob{0};
+
+    std::atomic<int> jobsFinished{0};
+    std::atomic<juce::int64> audioMicrosecondsRendered{0};
+
+    juce::CriticalSection failureLock;
+    juce::StringArray failures;
+};
+} // namespace
+
+//==============================================================================
+class BatchRenderer::Worker : public juce::Thread
+{
+  public:
+    Worker(const RenderSettings& settings, BatchState& batchState, juce::TimeSliceThread& readThread,
+           juce::TimeSliceThread& writeThread)
+        : juce::Thread("RSAlgorithmicVerb render worker"), renderer(settings), state(batchState)
+    {
+        renderer.setIOThreads(&readThread, &writeThread);
+        renderer.onBlockRendered = [this](double seconds) {
+            state.audioMicrosecondsRendered += static_cast<juce::int64>(seconds * 1.0e6);
+        };
+    }
+
+    ~Worker() override
+    {
+        stopThread(-1);
+    }
+
+    void run() override
+    {
+        // the same renderer, and so the same processor, is reused for every job this worker takes
+        for (int job = state.nextJob++; job < static_cast<int>(state.jobs.size()) && !threadShouldExit();
+             job = state.nextJob++)
+        {
+            const auto& renderJob = state.jobs[static_cast<size_t>(job)];
+            auto result = renderer.render(renderJob.inputFile, renderJob.outputFile);
+
+            if (result.failed())
+            {
+                const juce::ScopedLock lock(state.failureLock);
+                state.failures.add(renderJob.inputFile.getFullPathName() + ": " + result.getErrorMessage());
+            }
+
+            ++state.jobsFinished;
+        }
+    }
+
+  private:
+    OfflineRenderer renderer;
+    BatchState& state;
+};
+
+//==============================================================================
+BatchRenderer::BatchRenderer(RenderSettings renderSettings, int numberOfWorkers)
+    : settings(std::move(renderSettings)),
+      numWorkers(numberOfWorkers > 0 ? numberOfWorkers : juce::SystemStats::getNumCpus())
+{
+}
+
+BatchRenderer::~BatchRenderer() = default;
+
+juce::StringArray BatchRenderer::render(const std::vector<RenderJob>& jobs,
+                                        std::function<void(const BatchProgress&)> onProgress)
+{
+    BatchState state(jobs);
+
+    readThread.startThread();
+    writeThread.startThread();
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int i = 0; i < juce::jmin(numWorkers, static_cast<int>(jobs.size())); ++i)
+    {
+        workers.push_back(std::make_unique<Worker>(settings, state, readThread, writeThread));
+        workers.back()->startThread();
+    }
+
+    auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    auto reportProgress = [&]() {
+        if (onProgress == nullptr)
+            return;
+
+        BatchProgress progress;
+        progress.numJobs = static_cast<int>(jobs.size());
+        progress.jobsFinished = state.jobsFinished;
+        progress.audioSecondsRendered = state.audioMicrosecondsRendered * 1.0e-6;
+        progress.elapsedSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+        {
+            const juce::ScopedLock lock(state.failureLock);
+            progress.jobsFailed = state.failures.size();
+        }
+        onProgress(progress);
+    };
+
+    while (state.jobsFinished < static_cast<int>(jobs.size()))
+    {
+        juce::Thread::sleep(250);
+        reportProgress();
+    }
+
+    workers.clear();
+
+    // the writers flushed their queues when their jobs finished, so nothing is left for these threads
+    readThread.stopThread(1000);
+    writeThread.stopThread(1000);
+
+    return state.failures;
+}
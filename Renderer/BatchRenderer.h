@@ -0,0 +1,45 @@
+// Renders many files concurrently, one OfflineRenderer per worker thread
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "OfflineRenderer.h"
+
+struct RenderJob
+{
+    juce::File inputFile;
+    juce::File outputFile;
+};
+
+struct BatchProgress
+{
+    int numJobs = 0;
+    int jobsFinished = 0;
+    int jobsFailed = 0;
+    double audioSecondsRendered = 0;
+    double elapsedSeconds = 0;
+};
+
+class BatchRenderer
+{
+  public:
+    // numWorkers <= 0 uses one worker per CPU core
+    BatchRenderer(RenderSettings renderSettings, int numWorkers);
+
+    ~BatchRenderer();
+
+    // blocks until every job has finished, calling onProgress on this thread a few times a second; returns one
+    // message per failed job
+    juce::StringArray render(const std::vector<RenderJob>& jobs, std::function<void(const BatchProgress&)> onProgress);
+
+  private:
+    class Worker;
+
+    RenderSettings settings;
+    int numWorkers = 1;
+
+    // shared by the workers, so file I/O overlaps with rendering
+    juce::TimeSliceThread readThread{"RSAlgorithmicVerb reader"};
+    juce::TimeSliceThread writeThread{"RSAlgorithmicVerb writer"};
+};
@@ -0,0 +1,139 @@
+// Command-line renderer: runs audio files through the plugin's processing chain offline
+
+#include <JuceHeader.h>
+
+#include "BatchRenderer.h"
+#include "OfflineRenderer.h"
+
+#include <iostream>
+
+namespace
+{
+RenderSettings getRenderSettings(const juce::ArgumentList& args)
+{
+    RenderSettings settings;
+
+    if (args.containsOption("--preset"))
+        settings.presetFile = args.getExistingFileForOption("--preset");
+
+    // --param=<id>=<value>, may be repeated
+    for (const auto& arg : args.arguments)
+    {
+        if (arg.isLongOption("param"))
+        {
+            auto assignment = arg.getLongOptionValue();
+            if (!assignment.contains("="))
+                juce::ConsoleApplication::fail("Expected --param=<id>=<value>, got " + arg.text);
+
+            settings.parameterValues.emplace_back(assignment.upToFirstOccurrenceOf("=", false, false).trim(),
+                                                  assignment.fromFirstOccurrenceOf("=", false, false).trim());
+        }
+    }
+
+    if (args.containsOption("--tail"))
+        settings.tailSeconds = juce::jmax(0.0, args.getValueForOption("--tail").getDoubleValue());
+
+    if (args.containsOption("--block-size"))
+        settings.blockSize = juce::jmax(1, args.getValueForOption("--block-size").getIntValue());
+
+    if (args.containsOption("--bits"))
+        settings.bitsPerSample = args.getValueForOption("--bits").getIntValue();
+
+    return settings;
+}
+
+void renderFile(const juce::File& inputFile, const juce::File& outputFile, RenderSettings settings)
+{
+    OfflineRenderer renderer(std::move(settings));
+    auto result = renderer.render(inputFile, outputFile);
+
+    if (result.failed())
+        juce::ConsoleApplication::fail(result.getErrorMessage());
+
+    std::cout << "Rendered " << outputFile.getFullPathName() << std::endl;
+}
+
+// every readable file in inputFolder goes to a file with the same name in outputFolder
+void renderFolder(const juce::File& inputFolder, const juce::File& outputFolder, RenderSettings settings,
+                  int numWorkers)
+{
+    if (outputFolder == inputFolder)
+        juce::ConsoleApplication::fail("The output folder must be different from the input folder");
+
+    if (!outputFolder.createDirectory())
+        juce::ConsoleApplication::fail("Couldn't create " + outputFolder.getFullPathName());
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::vector<RenderJob> jobs;
+    for (const auto& file :
+         inputFolder.findChildFiles(juce::File::findFiles, false, formatManager.getWildcardForAllFormats()))
+        jobs.push_back({file, outputFolder.getChildFile(file.getFileName())});
+
+    if (jobs.empty())
+        juce::ConsoleApplication::fail("No audio files in " + inputFolder.getFullPathName());
+
+    BatchRenderer batchRenderer(std::move(settings), numWorkers);
+    auto failures = batchRenderer.render(jobs, [](const BatchProgress& progress) {
+        std::cout << "\r" << progress.jobsFinished << "/" << progress.numJobs << " files, "
+                  << juce::String(progress.audioSecondsRendered, 1) << " s of audio, "
+                  << juce::String(progress.audioSecondsRendered / juce::jmax(progress.elapsedSeconds, 0.001), 1)
+                  << "x real time" << std::flush;
+    });
+    std::cout << std::endl;
+
+    for (const auto& failure : failures)
+        std::cerr << failure << std::endl;
+
+    if (!failures.isEmpty())
+        juce::ConsoleApplication::fail(juce::String(failures.size()) + " of " + juce::String(jobs.size()) +
+                                       " files failed");
+}
+
+void render(const juce::ArgumentList& args)
+{
+    args.failIfOptionIsMissing("--input");
+    args.failIfOptionIsMissing("--output");
+
+    auto input = args.getFileForOption("--input");
+    auto output = args.getFileForOption("--output");
+
+    if (input.isDirectory())
+    {
+        int numWorkers = args.containsOption("--jobs") ? args.getValueForOption("--jobs").getIntValue() : 0;
+        renderFolder(input, output, getRenderSettings(args), numWorkers);
+    }
+    else if (input.existsAsFile())
+    {
+        renderFile(input, output, getRenderSettings(args));
+    }
+    else
+    {
+        juce::ConsoleApplication::fail("Couldn't find " + input.getFullPathName());
+    }
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    // the processor's parameter tree expects JUCE's message manager to exist
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ConsoleApplication app;
+
+    app.addHelpCommand("--help|-h", "Usage:", true);
+    app.addCommand({"--list-parameters", "--list-parameters", "Lists the parameter IDs accepted by --param",
+                    juce::String(),
+                    [](const juce::ArgumentList&) { std::cout << OfflineRenderer::describeParameters(); }});
+    app.addDefaultCommand({"--input",
+                           "--input=<file|folder> --output=<file|folder> [--preset=<file>] "
+                           "[--param=<id>=<value> ...] [--tail=<seconds>] [--block-size=<n>] [--bits=<n>] [--jobs=<n>]",
+                           "Renders a WAV, AIFF or FLAC file, or every such file in a folder, through the reverb",
+                           "The preset is plugin state XML; --param values are applied after it. The output format "
+                           "follows the output file's extension. Folders are rendered on --jobs worker threads, one "
+                           "per CPU core by default.",
+                           [](const juce::ArgumentList& args) { render(args); }});
+
+    return app.findAndRunCommand(argc, argv);
+}
@@ -0,0 +1,219 @@
+// Renders audio files offline through the full plugin processing chain
+
+#include "OfflineRenderer.h"
+
+OfflineRenderer::OfflineRenderer(RenderSettings renderSettings) : settings(std::move(renderSettings))
+{
+    formatManager.registerBasicFormats();
+}
+
+OfflineRenderer::~OfflineRenderer() = default;
+
+juce::Result OfflineRenderer::render(const juce::File& inputFile, const juce::File& outputFile)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(inputFile));
+    if (reader == nullptr)
+        return juce::Result::fail("Couldn't read " + inputFile.getFullPathName());
+
+    // the file's own layout when it names one the plugin supports (a WAV's channel mask), otherwise the usual layout
+    // for its channel count; four untagged channels are taken as quadraphonic, so first-order ambisonic files need to
+    // be WAVs marked as B-format
+    auto layout = reader->getChannelLayout();
+    if (!SurroundSpread::isLayoutSupported(layout))
+        layout = juce::AudioChannelSet::canonicalChannelSet(static_cast<int>(reader->numChannels));
+
+    int numChannels = layout.size();
+    if (numChannels != static_cast<int>(reader->numChannels) || !SurroundSpread::isLayoutSupported(layout))
+        return juce::Result::fail(inputFile.getFileName() + " has " + juce::String(reader->numChannels) +
+                                  " channels, which don't make a layout the plugin supports (mono, stereo, surround "
+                                  "and immersive up to 7.1.4, or first-order ambisonics)");
+
+    auto writer = createWriter(outputFile, *reader, layout);
+    if (writer == nullptr)
+        return juce::Result::fail("Couldn't create " + outputFile.getFullPathName());
+
+    if (readThread != nullptr)
+    {
+        // wait for data rather than returning silence if the read thread falls behind
+        auto bufferingReader = std::make_unique<juce::BufferingAudioReader>(reader.release(), *readThread,
+                                                                            readAheadSamples);
+        bufferingReader->setReadTimeout(-1);
+        reader = std::move(bufferingReader);
+    }
+
+    std::unique_ptr<juce::AudioFormatWriter::ThreadedWriter> threadedWriter;
+    if (writeThread != nullptr)
+        threadedWriter = std::make_unique<juce::AudioFormatWriter::ThreadedWriter>(writer.release(), *writeThread,
+                                                                                   writeQueueSamples);
+
+    if (processor == nullptr)
+    {
+        processor = std::make_unique<RSAlgorithmicVerbAudioProcessor>();
+        processor->setNonRealtime(true);
+
+        auto result = applySettings(*processor);
+        if (result.failed())
+        {
+            processor.reset();
+            return result;
+        }
+    }
+
+    juce::AudioProcessor::BusesLayout buses;
+    buses.inputBuses.add(layout);
+    buses.outputBuses.add(layout);
+    if (!processor->setBusesLayout(buses))
+        return juce::Result::fail("Couldn't set a " + layout.getDescription() + " layout");
+
+    processor->setRateAndBufferSizeDetails(reader->sampleRate, settings.blockSize);
+
+    processor->prepareToPlay(reader->sampleRate, settings.blockSize);
+    processor->reset();
+
+    juce::AudioBuffer<float> buffer(numChannels, settings.blockSize);
+    juce::MidiBuffer midiMessages;
+
+    // the estimate only depends on the parameters, which are all set by now
+    double tailSeconds = settings.tailSeconds < 0.0 ? processor->getTailLengthSeconds() : settings.tailSeconds;
+    auto tailSamples = static_cast<juce::int64>(std::ceil(tailSeconds * reader->sampleRate));
+    // the first latencySamples of output come before the input, so they're rendered but not written
+    int latencySamples = processor->getLatencySamples();
+    auto totalSamples = reader->lengthInSamples + tailSamples + latencySamples;
+
+    for (juce::int64 position = 0; position < totalSamples; position += settings.blockSize)
+    {
+        int numSamples = static_cast<int>(juce::jmin<juce::int64>(settings.blockSize, totalSamples - position));
+        juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), numChannels, numSamples);
+
+        // the reader zero-fills past the end of the file, which feeds silence in during the tail
+        reader->read(&block, 0, numSamples, position, true, true);
+        processor->processBlock(block, midiMessages);
+
+        int skipSamples = static_cast<int>(juce::jlimit<juce::int64>(0, numSamples, latencySamples - position));
+        int numWriteSamples = numSamples - skipSamples;
+        juce::AudioBuffer<float> writeBlock(block.getArrayOfWritePointers(), numChannels, skipSamples,
+                                            numWriteSamples);
+
+        if (numWriteSamples > 0)
+        {
+            if (threadedWriter != nullptr)
+            {
+                // the queue only refuses blocks while it's full, so wait for the write thread to drain it
+                while (!threadedWriter->write(writeBlock.getArrayOfReadPointers(), numWriteSamples))
+                    juce::Thread::sleep(1);
+            }
+            else if (!writer->writeFromAudioSampleBuffer(writeBlock, 0, numWriteSamples))
+            {
+                return juce::Result::fail("Couldn't write to " + outputFile.getFullPathName());
+            }
+        }
+
+        if (onBlockRendered != nullptr)
+            onBlockRendered(numWriteSamples / reader->sampleRate);
+    }
+
+    processor->releaseResources();
+
+    return juce::Result::ok();
+}
+
+void OfflineRenderer::setIOThreads(juce::TimeSliceThread* newReadThread, juce::TimeSliceThread* newWriteThread)
+{
+    readThread = newReadThread;
+    writeThread = newWriteThread;
+}
+
+juce::String OfflineRenderer::describeParameters()
+{
+    RSAlgorithmicVerbAudioProcessor processor;
+    juce::String description;
+
+    for (auto* param : processor.getParameters())
+    {
+        auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(param);
+        if (ranged == nullptr)
+            continue;
+
+        description << ranged->paramID << " (" << ranged->getName(64) << "): ";
+
+        if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(ranged))
+        {
+            description << choice->choices.joinIntoString(", ");
+        }
+        else
+        {
+            const auto& range = ranged->getNormalisableRange();
+            description << range.start << " to " << range.end << ", default "
+                        << ranged->getText(ranged->getDefaultValue(), 64);
+        }
+
+        description << juce::newLine;
+    }
+
+    return description;
+}
+
+juce::Result OfflineRenderer::applySettings(RSAlgorithmicVerbAudioProcessor& processor) const
+{
+    if (settings.presetFile.existsAsFile())
+    {
+        auto xml = juce::parseXML(settings.presetFile);
+        if (xml == nullptr)
+            return juce::Result::fail("Couldn't parse preset " + settings.presetFile.getFullPathName());
+
+        juce::MemoryBlock state;
+        juce::AudioProcessor::copyXmlToBinary(*xml, state);
+        processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+    }
+
+    for (const auto& [paramID, valueText] : settings.parameterValues)
+    {
+        juce::RangedAudioParameter* param = nullptr;
+        for (auto* candidate : processor.getParameters())
+        {
+            auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(candidate);
+            if (ranged != nullptr && ranged->paramID == paramID)
+                param = ranged;
+        }
+
+        if (param == nullptr)
+            return juce::Result::fail("Unknown parameter " + paramID);
+
+        // choices are given by name, everything else as a plain value
+        if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(param))
+            if (!choice->choices.contains(valueText))
+                return juce::Result::fail(valueText + " isn't one of " + choice->choices.joinIntoString(", "));
+
+        param->setValueNotifyingHost(param->getValueForText(valueText));
+    }
+
+    return juce::Result::ok();
+}
+
+std::unique_ptr<juce::AudioFormatWriter> OfflineRenderer::createWriter(const juce::File& outputFile,
+                                                                       const juce::AudioFormatReader& reader,
+                                                                       const juce::AudioChannelSet& layout) const
+{
+    auto* format = formatManager.findFormatForFileExtension(outputFile.getFileExtension());
+    if (format == nullptr)
+        return nullptr;
+
+    int bitsPerSample = settings.bitsPerSample > 0 ? settings.bitsPerSample : static_cast<int>(reader.bitsPerSample);
+    auto possibleBitDepths = format->getPossibleBitDepths();
+    if (!possibleBitDepths.contains(bitsPerSample))
+        bitsPerSample = possibleBitDepths.contains(24) ? 24 : possibleBitDepths.getLast();
+
+    outputFile.deleteFile();
+    std::unique_ptr<juce::OutputStream> stream = outputFile.createOutputStream();
+    if (stream == nullptr)
+        return nullptr;
+
+    std::unique_ptr<juce::AudioFormatWriter> writer(
+        format->createWriterFor(stream.get(), reader.sampleRate, layout, bitsPerSample, {}, 0));
+
+    // the writer owns the stream once it has been created
+    if (writer != nullptr)
+        stream.release();
+
+    return writer;
+}
@@ -0,0 +1,66 @@
+// Renders audio files offline through the full plugin processing chain
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "PluginProcessor.h"
+
+struct RenderSettings
+{
+    // plugin state XML, as written by getStateInformation
+    juce::File presetFile;
+
+    // parameter ID and value text pairs, applied after the preset
+    std::vector<std::pair<juce::String, juce::String>> parameterValues;
+
+    // silence rendered after the end of the input so the reverb can decay; negative uses the processor's own estimate
+    double tailSeconds = -1.0;
+
+    int blockSize = 512;
+
+    // 0 keeps the input's bit depth when the output format supports it
+    int bitsPerSample = 0;
+};
+
+class OfflineRenderer
+{
+  public:
+    explicit OfflineRenderer(RenderSettings renderSettings);
+
+    ~OfflineRenderer();
+
+    // streams inputFile through the processor block by block, so memory use doesn't depend on the file's length; the
+    // processor is created on the first call and reset for each later one
+    juce::Result render(const juce::File& inputFile, const juce::File& outputFile);
+
+    // when set, reading is buffered ahead and writing queued on these threads instead of blocking the render; the
+    // threads must outlive any render() calls
+    void setIOThreads(juce::TimeSliceThread* newReadThread, juce::TimeSliceThread* newWriteThread);
+
+    // called after each block with the length of audio it rendered, in seconds
+    std::function<void(double)> onBlockRendered;
+
+    // parameter IDs with their ranges or choices, for --list-parameters
+    static juce::String describeParameters();
+
+  private:
+    juce::Result applySettings(RSAlgorithmicVerbAudioProcessor& processor) const;
+
+    // the layout is written to the file where the format can store it, such as a WAV's channel mask
+    std::unique_ptr<juce::AudioFormatWriter> createWriter(const juce::File& outputFile,
+                                                          const juce::AudioFormatReader& reader,
+                                                          const juce::AudioChannelSet& layout) const;
+
+    static constexpr int readAheadSamples = 65536;
+    static constexpr int writeQueueSamples = 65536;
+
+    RenderSettings settings;
+
+    juce::AudioFormatManager formatManager;
+
+    std::unique_ptr<RSAlgorithmicVerbAudioProcessor> processor;
+
+    juce::TimeSliceThread* readThread = nullptr;
+    juce::TimeSliceThread* writeThread = nullptr;
+};
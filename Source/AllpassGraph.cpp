@@ -0,0 +1,190 @@
+// Data-driven allpass loop topologies, each built into its own per-sample kernel at compile time
+
+#include "AllpassGraph.h"
+
+AllpassGraphReverb::AllpassGraphReverb(AllpassGraphProgram graphProgram) : program(std::move(graphProgram))
+{
+    delayTimesMs.resize(static_cast<size_t>(program.numDelays));
+    delayModulated.resize(static_cast<size_t>(program.numDelays));
+    for (const auto& step : program.steps)
+    {
+        if (step.delayIndex >= 0 && step.type != AllpassGraphStep::Type::nestedEnd)
+        {
+            delayTimesMs[static_cast<size_t>(step.delayIndex)] = step.delayMs;
+            delayModulated[static_cast<size_t>(step.delayIndex)] = step.modulation != AllpassGraphModulation::none;
+        }
+    }
+}
+
+AllpassGraphReverb::~AllpassGraphReverb() = default;
+
+void AllpassGraphReverb::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = spec.sampleRate;
+
+    // a mono copy of every delay, the damping filter and the LFO for each channel; delays are sized for the largest
+    // room at this sample rate
+    juce::dsp::ProcessSpec monoSpec = spec;
+    monoSpec.numChannels = 1;
+
+    float samplesPerMs = sampleRate / 1000;
+
+    lfoParameters.frequency_Hz = 0.25;
+    lfoParameters.waveform = generatorWaveform::sin;
+
+    channels.resize(spec.numChannels);
+    for (auto& channel : channels)
+    {
+        channel.delays.clear();
+        channel.delays.reserve(delayTimesMs.size());
+        for (size_t del = 0; del < delayTimesMs.size(); ++del)
+        {
+            float maxDelay = delayTimesMs[del] * samplesPerMs * program.maxRoomSize +
+                             program.channelDelayOffset * delayScale;
+            if (delayModulated[del])
+                maxDelay += modulationDepthSamples * delayScale;
+
+            channel.delays.emplace_back(static_cast<int>(std::ceil(maxDelay)) + 1);
+            channel.delays.back().prepare(monoSpec);
+        }
+
+        channel.delayTimes.resize(delayTimesMs.size());
+
+        channel.dampingFilter.prepare(monoSpec);
+        channel.dampingFilter.setType(juce::dsp::FirstOrderTPTFilterType::lowpass);
+
+        channel.lfo.setParameters(lfoParameters);
+        channel.lfo.reset(spec.sampleRate);
+    }
+
+    modulationFade.prepare(spec.sampleRate);
+
+    reset();
+}
+
+void AllpassGraphReverb::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    // lengths are worked out at the host rate, then scaled to the rate this runs at
+    float hostSamplesPerMs = sampleRate / delayScale / 1000;
+
+    for (auto& channel : channels)
+    {
+        channel.dampingFilter.setCutoffFrequency(parameters.damping);
+
+        lfoParameters = channel.lfo.getParameters();
+        lfoParameters.frequency_Hz = parameters.modRate;
+        channel.lfo.setParameters(lfoParameters);
+    }
+
+    // quality tier
+    modulationFade.setOn(qualityTier < 1);
+    modulationFade.advance(buffer.getNumSamples());
+
+    AllpassGraphBlock block;
+    block.numSamples = buffer.getNumSamples();
+    block.decayTime = parameters.decayTime;
+    block.modulationDepth = modulationDepthSamples * delayScale * parameters.modDepth;
+    block.modulationFade = &modulationFade;
+
+    auto processChannel = [&](int channelIndex) {
+        auto& channel = channels[static_cast<size_t>(channelIndex)];
+
+        for (size_t del = 0; del < channel.delays.size(); ++del)
+        {
+            channel.delayTimes[del] = scaleDelay(delayTimesMs[del] * hostSamplesPerMs * parameters.roomSize +
+                                                 program.channelDelayOffset * (channelIndex % 2));
+            channel.delays[del].setDelay(channel.delayTimes[del]);
+        }
+
+        AllpassGraphBlock channelBlock = block;
+        channelBlock.data = buffer.getWritePointer(channelIndex);
+        program.processChannel(channel, channelBlock);
+    };
+
+    forEachChannel(buffer.getNumChannels(), processChannel);
+}
+
+void AllpassGraphReverb::reset()
+{
+    for (auto& channel : channels)
+    {
+        for (auto& delay : channel.delays)
+            delay.reset();
+
+        channel.dampingFilter.reset();
+        channel.feedback = 0.0f;
+    }
+
+    modulationFade.finishFade();
+}
+
+int AllpassGraphReverb::getNumQualityTiers()
+{
+    return 2;
+}
+
+ReverbProcessorParameters& AllpassGraphReverb::getParameters()
+{
+    return parameters;
+}
+
+void AllpassGraphReverb::setParameters(const ReverbProcessorParameters& params)
+{
+    if (!(params == parameters))
+    {
+        parameters = params;
+        parameters.roomSize = scale(parameters.roomSize, 0.0f, 1.0f, program.minRoomSize, program.maxRoomSize);
+    }
+}
+
+double AllpassGraphReverb::getTailLengthSeconds()
+{
+    // a trip round the loop is scaled by the fixed gains, and by decayTime at each decay gain and at the feedback send.
+    // Nested allpasses only pass the scaled feedback term into their delay, so they let through at most g / (1 - g);
+    // but at the frequencies where they do, the signal also goes round their own loop, through every delay nested in
+    // it, so the trip is taken as passing every delay in the graph. Counting only the outermost delays had the Large
+    // Room's tail short by half at the top of the feedback range. Each allpass can ring on for longer when decayTime is
+    // low, and a nested one rings through all the delays nested in it too
+    double loopSeconds = 0;
+    double loopGain = parameters.decayTime;
+    double allpassDecay = 0;
+    std::array<double, allpassGraphMaxNestingDepth> nestedSeconds{};
+
+    for (const auto& step : program.steps)
+    {
+        double delaySeconds = 0;
+        if (step.type == AllpassGraphStep::Type::delay || step.type == AllpassGraphStep::Type::allpass ||
+            step.type == AllpassGraphStep::Type::nestedAllpass)
+            delaySeconds = step.delayMs * parameters.roomSize / 1000.0;
+
+        loopSeconds += delaySeconds;
+        for (int depth = 0; depth < step.depth; ++depth)
+            nestedSeconds[static_cast<size_t>(depth)] += delaySeconds;
+
+        switch (step.type)
+        {
+        case AllpassGraphStep::Type::allpass:
+            allpassDecay = std::max(allpassDecay, loopDecayTime(step.gain, delaySeconds));
+            break;
+        case AllpassGraphStep::Type::nestedAllpass:
+            nestedSeconds[static_cast<size_t>(step.depth)] = delaySeconds;
+            if (step.depth == 0)
+                loopGain *= step.gain / (1.0 - step.gain);
+            break;
+        case AllpassGraphStep::Type::nestedEnd:
+            allpassDecay =
+                std::max(allpassDecay, loopDecayTime(step.gain, nestedSeconds[static_cast<size_t>(step.depth)]));
+            break;
+        case AllpassGraphStep::Type::gain:
+            loopGain *= step.gain;
+            break;
+        case AllpassGraphStep::Type::decayGain:
+            loopGain *= parameters.decayTime;
+            break;
+        default:
+            break;
+        }
+    }
+
+    return loopSeconds + std::max(loopDecayTime(loopGain, loopSeconds), allpassDecay);
+}
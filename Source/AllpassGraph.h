@@ -0,0 +1,401 @@
+// Data-driven allpass loop topologies, each built into its own per-sample kernel at compile time
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "LFO.h"
+#include "ProcessorBase.h"
+#include "QualityTiers.h"
+#include "Utilities.h"
+
+/*
+A topology is a struct deriving from AllpassGraphTopology, with its steps in a static constexpr std::array in the order
+the signal passes through them:
+
+    struct Room : AllpassGraphTopology
+    {
+        static constexpr int channelDelayOffset = 7;
+        static constexpr std::array steps{AllpassGraphStep::input(), AllpassGraphStep::feedbackReturn(), ...};
+    };
+
+AllpassGraphKernel<Room> works out each step's delay line and nesting at compile time, and instantiates the per-sample
+loop with every step inlined in order, so nothing is looked up or dispatched per step at run time. AllpassGraphReverb
+runs the result; a new room is a new topology, with no new processing code.
+
+The Concert Hall isn't one of these: its two loops cross-feed each other in a figure eight, its outputs are taps from
+inside the loop delays, and its allpasses scale their delayed signal by the decay time and run a one-pole filter inside
+the innermost loop, none of which a single loop of steps per channel can say.
+*/
+
+// LFO output used to modulate a delay's read position
+enum class AllpassGraphModulation
+{
+    none,
+    normal,
+    quadPhase
+};
+
+// one step of a loop topology; delay times are in ms at roomSize 1
+struct AllpassGraphStep
+{
+    enum class Type
+    {
+        input,          // add the dry input sample into the loop
+        feedbackReturn, // add the damped loop feedback
+        delay,          // plain delay
+        allpass,        // single allpass
+        nestedAllpass,  // allpass whose delay holds the steps up to the matching nestedEnd
+        nestedEnd,      // closes the innermost open nested allpass
+        gain,           // fixed gain
+        decayGain,      // gain set by the decay time parameter
+        outputTap,      // mix the current signal into the output
+        feedbackSend    // damp the current signal and send it back to feedbackReturn
+    };
+
+    static constexpr AllpassGraphStep input()
+    {
+        return {Type::input};
+    }
+
+    static constexpr AllpassGraphStep feedbackReturn()
+    {
+        return {Type::feedbackReturn};
+    }
+
+    static constexpr AllpassGraphStep delay(float delayMs,
+                                            AllpassGraphModulation modulation = AllpassGraphModulation::none)
+    {
+        return {Type::delay, delayMs, 0.0f, modulation};
+    }
+
+    static constexpr AllpassGraphStep allpass(float delayMs, float gain,
+                                              AllpassGraphModulation modulation = AllpassGraphModulation::none)
+    {
+        return {Type::allpass, delayMs, gain, modulation};
+    }
+
+    // as in Gardner's rooms, only the outer feedback term is passed through the nested steps
+    static constexpr AllpassGraphStep nestedAllpass(float delayMs, float gain)
+    {
+        return {Type::nestedAllpass, delayMs, gain};
+    }
+
+    static constexpr AllpassGraphStep nestedEnd()
+    {
+        return {Type::nestedEnd};
+    }
+
+    static constexpr AllpassGraphStep fixedGain(float gain)
+    {
+        return {Type::gain, 0.0f, gain};
+    }
+
+    static constexpr AllpassGraphStep decayGain()
+    {
+        return {Type::decayGain};
+    }
+
+    static constexpr AllpassGraphStep outputTap(float gain)
+    {
+        return {Type::outputTap, 0.0f, gain};
+    }
+
+    static constexpr AllpassGraphStep feedbackSend()
+    {
+        return {Type::feedbackSend};
+    }
+
+    Type type = Type::delay;
+    float delayMs = 0;
+    float gain = 0;
+    AllpassGraphModulation modulation = AllpassGraphModulation::none;
+
+    // worked out by AllpassGraphKernel: the step's delay line, how many nested allpasses it's inside, and for a
+    // nestedEnd the delay line and gain of the allpass it closes
+    int delayIndex = -1;
+    int depth = 0;
+};
+
+// the settings every topology has, with their defaults
+struct AllpassGraphTopology
+{
+    // added to every delay on odd channels to decorrelate them, in samples at the host rate
+    static constexpr int channelDelayOffset = 0;
+
+    // range the 0-1 roomSize parameter is scaled to
+    static constexpr float minRoomSize = 0.25f;
+    static constexpr float maxRoomSize = 1.75f;
+};
+
+constexpr int allpassGraphMaxNestingDepth = 4;
+
+// false if the nested allpasses don't all close, or go deeper than allpassGraphMaxNestingDepth
+template <size_t numSteps> constexpr bool isAllpassGraphBalanced(const std::array<AllpassGraphStep, numSteps>& steps)
+{
+    int depth = 0;
+    for (const auto& step : steps)
+    {
+        if (step.type == AllpassGraphStep::Type::nestedAllpass && ++depth > allpassGraphMaxNestingDepth)
+            return false;
+        if (step.type == AllpassGraphStep::Type::nestedEnd && --depth < 0)
+            return false;
+    }
+    return depth == 0;
+}
+
+// the steps with their delay lines, in step order, and nesting filled in
+template <size_t numSteps>
+constexpr std::array<AllpassGraphStep, numSteps> resolveAllpassGraph(std::array<AllpassGraphStep, numSteps> steps)
+{
+    std::array<size_t, allpassGraphMaxNestingDepth> open{};
+    int depth = 0;
+    int numDelays = 0;
+
+    for (size_t index = 0; index < numSteps; ++index)
+    {
+        auto& step = steps[index];
+        switch (step.type)
+        {
+        case AllpassGraphStep::Type::delay:
+        case AllpassGraphStep::Type::allpass:
+            step.delayIndex = numDelays++;
+            step.depth = depth;
+            break;
+        case AllpassGraphStep::Type::nestedAllpass:
+            step.delayIndex = numDelays++;
+            step.depth = depth;
+            open[static_cast<size_t>(depth++)] = index;
+            break;
+        case AllpassGraphStep::Type::nestedEnd:
+            --depth;
+            step.delayIndex = steps[open[static_cast<size_t>(depth)]].delayIndex;
+            step.gain = steps[open[static_cast<size_t>(depth)]].gain;
+            step.depth = depth;
+            break;
+        default:
+            step.depth = depth;
+            break;
+        }
+    }
+
+    return steps;
+}
+
+template <size_t numSteps> constexpr int countAllpassGraphDelays(const std::array<AllpassGraphStep, numSteps>& steps)
+{
+    int numDelays = 0;
+    for (const auto& step : steps)
+        numDelays = std::max(numDelays, step.delayIndex + 1);
+    return numDelays;
+}
+
+// one channel's state; the channels share none, so they can run on separate threads
+struct AllpassGraphChannel
+{
+    // one per step with a delay, in step order, and their lengths in samples for this block
+    std::vector<juce::dsp::DelayLine<float>> delays;
+    std::vector<float> delayTimes;
+
+    juce::dsp::FirstOrderTPTFilter<float> dampingFilter;
+    LFO lfo;
+    float feedback = 0;
+};
+
+// what a kernel needs for one channel's block, other than the channel
+struct AllpassGraphBlock
+{
+    float* data = nullptr;
+    int numSamples = 0;
+    float decayTime = 0;
+    float modulationDepth = 0;
+    const TierFade* modulationFade = nullptr;
+};
+
+// a topology built for AllpassGraphReverb: its resolved steps, and the kernel that runs them over a channel's block
+struct AllpassGraphProgram
+{
+    using ProcessChannel = void (*)(AllpassGraphChannel&, const AllpassGraphBlock&);
+
+    std::vector<AllpassGraphStep> steps;
+    int numDelays = 0;
+    int channelDelayOffset = 0;
+    float minRoomSize = 0;
+    float maxRoomSize = 0;
+    ProcessChannel processChannel = nullptr;
+};
+
+//==============================================================================
+template <typename Topology> class AllpassGraphKernel
+{
+  public:
+    static AllpassGraphProgram getProgram()
+    {
+        return {{steps.begin(), steps.end()},
+                countAllpassGraphDelays(steps),
+                Topology::channelDelayOffset,
+                Topology::minRoomSize,
+                Topology::maxRoomSize,
+                &processChannel};
+    }
+
+  private:
+    static constexpr size_t numSteps = std::tuple_size<decltype(Topology::steps)>::value;
+
+    static_assert(isAllpassGraphBalanced(Topology::steps),
+                  "every nestedAllpass needs a nestedEnd, at most allpassGraphMaxNestingDepth deep");
+
+    static constexpr std::array<AllpassGraphStep, numSteps> steps = resolveAllpassGraph(Topology::steps);
+
+    template <typename Callback, size_t... indices>
+    static void forEachStep(Callback& callback, std::index_sequence<indices...>)
+    {
+        (callback(std::integral_constant<size_t, indices>()), ...);
+    }
+
+    static void processChannel(AllpassGraphChannel& channel, const AllpassGraphBlock& block)
+    {
+        auto* delays = channel.delays.data();
+        const float* delayTimes = channel.delayTimes.data();
+        auto& dampingFilter = channel.dampingFilter;
+        float feedbackSignal = channel.feedback;
+
+        // allpass output and feedforward for each open nested allpass; the nestedAllpass step always writes its
+        // depth's values before the matching nestedEnd reads them, so they needn't be cleared
+        std::array<float, allpassGraphMaxNestingDepth> allpassOutput;
+        std::array<float, allpassGraphMaxNestingDepth> feedforward;
+
+        for (int sample = 0; sample < block.numSamples; ++sample)
+        {
+            // LFO, as read offsets for normal and quadPhase
+            SignalGenData lfoOutput = renderModulation(channel.lfo, *block.modulationFade, sample, block.numSamples);
+            const double modulationOffsets[2] = {lfoOutput.normalOutput * block.modulationDepth,
+                                                 lfoOutput.quadPhaseOutput_pos * block.modulationDepth};
+
+            float signal = 0.0f;
+            float output = 0.0f;
+
+            // the allpass's write, given what its delay read; returns its output
+            auto processAllpass = [](juce::dsp::DelayLine<float>& delay, float delayOutput, float input, float gain) {
+                float allpassFeedforward = input * -gain;
+                delay.pushSample(0, input + (delayOutput + allpassFeedforward) * gain);
+                return delayOutput + allpassFeedforward;
+            };
+
+            // each step is its own instantiation, so only its own case is compiled in
+            auto processStep = [&](auto stepIndex) {
+                constexpr AllpassGraphStep step = steps[decltype(stepIndex)::value];
+                constexpr size_t modulationIndex = step.modulation == AllpassGraphModulation::quadPhase ? 1 : 0;
+
+                if constexpr (step.type == AllpassGraphStep::Type::input)
+                {
+                    signal += block.data[sample];
+                }
+                else if constexpr (step.type == AllpassGraphStep::Type::feedbackReturn)
+                {
+                    signal += feedbackSignal;
+                }
+                else if constexpr (step.type == AllpassGraphStep::Type::delay)
+                {
+                    auto& delay = delays[step.delayIndex];
+                    delay.pushSample(0, signal);
+                    if constexpr (step.modulation == AllpassGraphModulation::none)
+                        signal = delay.popSample(0);
+                    else
+                        signal = delay.popSample(0, delayTimes[step.delayIndex] + modulationOffsets[modulationIndex]);
+                }
+                else if constexpr (step.type == AllpassGraphStep::Type::allpass)
+                {
+                    auto& delay = delays[step.delayIndex];
+                    if constexpr (step.modulation == AllpassGraphModulation::none)
+                    {
+                        signal = processAllpass(delay, delay.popSample(0), signal, step.gain);
+                    }
+                    else
+                    {
+                        float delayOutput =
+                            delay.popSample(0, delayTimes[step.delayIndex] + modulationOffsets[modulationIndex]);
+                        signal = processAllpass(delay, delayOutput, signal, step.gain);
+                    }
+                }
+                else if constexpr (step.type == AllpassGraphStep::Type::nestedAllpass)
+                {
+                    feedforward[step.depth] = signal;
+                    allpassOutput[step.depth] = delays[step.delayIndex].popSample(0);
+                    signal = (allpassOutput[step.depth] + (signal * -step.gain)) * step.gain;
+                }
+                else if constexpr (step.type == AllpassGraphStep::Type::nestedEnd)
+                {
+                    delays[step.delayIndex].pushSample(0, signal);
+                    signal = allpassOutput[step.depth] + (feedforward[step.depth] * -step.gain);
+                }
+                else if constexpr (step.type == AllpassGraphStep::Type::gain)
+                {
+                    signal *= step.gain;
+                }
+                else if constexpr (step.type == AllpassGraphStep::Type::decayGain)
+                {
+                    signal *= block.decayTime;
+                }
+                else if constexpr (step.type == AllpassGraphStep::Type::outputTap)
+                {
+                    output += signal * step.gain;
+                }
+                else if constexpr (step.type == AllpassGraphStep::Type::feedbackSend)
+                {
+                    feedbackSignal = dampingFilter.processSample(0, signal * block.decayTime);
+                }
+            };
+
+            forEachStep(processStep, std::make_index_sequence<numSteps>());
+
+            block.data[sample] = output;
+        }
+
+        channel.feedback = feedbackSignal;
+    }
+};
+
+//==============================================================================
+class AllpassGraphReverb : public ReverbProcessorBase
+{
+  public:
+    // from AllpassGraphKernel<Topology>::getProgram()
+    explicit AllpassGraphReverb(AllpassGraphProgram graphProgram);
+
+    ~AllpassGraphReverb() override;
+
+    void prepare(const juce::dsp::ProcessSpec& spec) override;
+
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override;
+
+    void reset() override;
+
+    ReverbProcessorParameters& getParameters() override;
+
+    void setParameters(const ReverbProcessorParameters& params) override;
+
+    double getTailLengthSeconds() override;
+
+    // 0: as designed; 1: unmodulated
+    int getNumQualityTiers() override;
+
+  private:
+    static constexpr float modulationDepthSamples = 24.0f;
+
+    AllpassGraphProgram program;
+
+    // each delay's length in ms at roomSize 1, by delay index
+    std::vector<float> delayTimesMs;
+    std::vector<bool> delayModulated;
+
+    std::vector<AllpassGraphChannel> channels;
+
+    // parameter struct
+    ReverbProcessorParameters parameters;
+
+    OscillatorParameters lfoParameters;
+    TierFade modulationFade;
+
+    int sampleRate = 44100;
+};
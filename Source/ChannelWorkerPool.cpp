@@ -0,0 +1,125 @@
+// Runs the channels of a reverb's block on pre-spawned worker threads
+
+#include "ChannelWorkerPool.h"
+#include "WorkerSignal.h"
+
+class ChannelWorkerPool::Worker : public juce::Thread
+{
+  public:
+    Worker(ChannelWorkerPool& owner, int index)
+        : juce::Thread("RSAlgorithmicVerb channel worker " + juce::String(index)), pool(owner), threadIndex(index),
+          seenGeneration(owner.generation.load())
+    {
+    }
+
+    ~Worker() override
+    {
+        stop();
+    }
+
+    void stop()
+    {
+        signalThreadShouldExit();
+        wakeSignal.notify();
+        stopThread(4000);
+    }
+
+    void wake()
+    {
+        wakeSignal.notify();
+    }
+
+    void run() override
+    {
+        // the audio thread's denormal handling doesn't carry over to other threads
+        juce::ScopedNoDenormals noDenormals;
+
+        while (!threadShouldExit())
+        {
+            wakeSignal.waitUntil([&] { return pool.generation.load() != seenGeneration || threadShouldExit(); });
+            if (pool.generation.load() == seenGeneration)
+                continue;
+
+            // the caller waits for every worker, so the generation can only have moved on by one
+            seenGeneration = pool.generation.load();
+            pool.processChannels(threadIndex);
+            pool.numWorkersFinished.fetch_add(1);
+        }
+    }
+
+  private:
+    ChannelWorkerPool& pool;
+    int threadIndex;
+    // taken before the thread starts: a block started before it got going would otherwise be taken as already seen,
+    // and the caller would wait for it forever
+    int seenGeneration;
+    WorkerSignal wakeSignal;
+};
+
+//==============================================================================
+ChannelWorkerPool::ChannelWorkerPool() = default;
+
+ChannelWorkerPool::~ChannelWorkerPool()
+{
+    release();
+}
+
+void ChannelWorkerPool::prepare(int numWorkers)
+{
+    if (numWorkers == getNumWorkers())
+        return;
+
+    release();
+
+    for (int index = 1; index <= numWorkers; ++index)
+    {
+        workers.push_back(std::make_unique<Worker>(*this, index));
+        workers.back()->startThread(juce::Thread::Priority::highest);
+    }
+}
+
+void ChannelWorkerPool::release()
+{
+    for (auto& worker : workers)
+        worker->stop();
+
+    workers.clear();
+}
+
+int ChannelWorkerPool::getNumWorkers() const
+{
+    return static_cast<int>(workers.size());
+}
+
+void ChannelWorkerPool::run(int numChannels, ChannelFunction function, void* context)
+{
+    if (workers.empty() || numChannels < 2)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            function(context, channel);
+        return;
+    }
+
+    channelFunction = function;
+    channelContext = context;
+    numJobChannels = numChannels;
+    numWorkersFinished.store(0);
+    generation.fetch_add(1);
+
+    for (auto& worker : workers)
+        worker->wake();
+
+    processChannels(0);
+
+    // the workers' channels take about as long as this thread's, so the wait is short
+    while (numWorkersFinished.load() < getNumWorkers())
+        juce::Thread::yield();
+}
+
+void ChannelWorkerPool::processChannels(int threadIndex)
+{
+    int numThreads = getNumWorkers() + 1;
+
+    for (int channel = threadIndex; channel < numJobChannels; channel += numThreads)
+        channelFunction(channelContext, channel);
+}
@@ -0,0 +1,60 @@
+// Runs the channels of a reverb's block on pre-spawned worker threads
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*
+For algorithms whose channels share no mutable state. The calling thread takes channel 0, worker 1 channel 1 and so on,
+wrapping round when there are more channels than threads, so no two threads touch the same channel and nothing needs a
+lock. Workers spin for a while after each block in case the next arrives soon, then sleep until woken (see
+WorkerSignal); nothing is allocated on the audio thread, and waking a worker that has gone to sleep is the only system
+call.
+*/
+class ChannelWorkerPool
+{
+  public:
+    // below this many samples per block, handing channels over costs about as much as it saves
+    static constexpr int minimumBlockSize = 256;
+
+    ChannelWorkerPool();
+
+    ~ChannelWorkerPool();
+
+    // stops any running workers and starts numWorkers new ones; not on the audio thread
+    void prepare(int numWorkers);
+
+    void release();
+
+    int getNumWorkers() const;
+
+    // calls processChannel(channel) for each channel, and returns once they have all finished
+    template <typename Callback> void forEachChannel(int numChannels, Callback& processChannel)
+    {
+        run(
+            numChannels, [](void* callback, int channel) { (*static_cast<Callback*>(callback))(channel); },
+            &processChannel);
+    }
+
+  private:
+    class Worker;
+
+    using ChannelFunction = void (*)(void*, int);
+
+    void run(int numChannels, ChannelFunction function, void* context);
+
+    // the channels for one thread; thread 0 is the caller
+    void processChannels(int threadIndex);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    // the job, written before generation is advanced and read after
+    ChannelFunction channelFunction = nullptr;
+    void* channelContext = nullptr;
+    int numJobChannels = 0;
+
+    std::atomic<int> generation{0};
+    std::atomic<int> numWorkersFinished{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChannelWorkerPool)
+};
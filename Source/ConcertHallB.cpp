@@ -62,18 +62,23 @@ void LargeConcertHallB::prepare(const juce::dsp::ProcessSpec& spec)
     lfoParameters.waveform = generatorWaveform::sin;
     lfo.setParameters(lfoParameters);
     lfo.reset(spec.sampleRate);
+    modulationFade.prepare(spec.sampleRate);
 }
 
 void LargeConcertHallB::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
-    juce::ScopedNoDenormals noDenormals;
-
     // set LFO rate
     lfoParameters = lfo.getParameters();
     lfoParameters.frequency_Hz = parameters.modRate;
     lfo.setParameters(lfoParameters);
 
-    // set delays
+    // quality tier
+    modulationFade.setOn(qualityTier < 1);
+    modulationFade.advance(buffer.getNumSamples());
+
+    // set delays, scaled from their lengths at the host rate; the one-sample delays are part of the filters
+    auto tap = [this](int samples) { return static_cast<int>(scaleDelay(static_cast<float>(samples))); };
+
     // filters
     inputBandwidth.setDelay(1);
     feedbackDamping.setDelay(1);
@@ -86,35 +91,35 @@ void LargeConcertHallB::processBlock(juce::AudioBuffer<float>& buffer, juce::Mid
     // delays
     inputZ.setDelay(1);
     // L
-    loopDelayL1.setDelay(2 * parameters.roomSize);
-    loopDelayL2.setDelay(1055 * parameters.roomSize);
-    loopDelayL3.setDelay(344 * parameters.roomSize);
-    loopDelayL4.setDelay(1572 * parameters.roomSize);
+    loopDelayL1.setDelay(scaleDelay(2 * parameters.roomSize));
+    loopDelayL2.setDelay(scaleDelay(1055 * parameters.roomSize));
+    loopDelayL3.setDelay(scaleDelay(344 * parameters.roomSize));
+    loopDelayL4.setDelay(scaleDelay(1572 * parameters.roomSize));
     // R
-    loopDelayR1.setDelay(1 * parameters.roomSize);
-    loopDelayR2.setDelay(1460 * parameters.roomSize);
-    loopDelayR3.setDelay(500 * parameters.roomSize);
-    loopDelayR4.setDelay(16 * parameters.roomSize);
+    loopDelayR1.setDelay(scaleDelay(1 * parameters.roomSize));
+    loopDelayR2.setDelay(scaleDelay(1460 * parameters.roomSize));
+    loopDelayR3.setDelay(scaleDelay(500 * parameters.roomSize));
+    loopDelayR4.setDelay(scaleDelay(16 * parameters.roomSize));
 
     // allpasses
     // L
-    allpassL1.setDelay(239 * parameters.roomSize);
-    allpassL2.setDelay(392 * parameters.roomSize);
-    allpassL3Inner.setDelay(1944 * parameters.roomSize);
-    allpassL3Outer.setDelay(612 * parameters.roomSize);
-    float allpassL4InnermostSize = 1333 * parameters.roomSize;
+    allpassL1.setDelay(scaleDelay(239 * parameters.roomSize));
+    allpassL2.setDelay(scaleDelay(392 * parameters.roomSize));
+    allpassL3Inner.setDelay(scaleDelay(1944 * parameters.roomSize));
+    allpassL3Outer.setDelay(scaleDelay(612 * parameters.roomSize));
+    float allpassL4InnermostSize = scaleDelay(1333 * parameters.roomSize);
     allpassL4Innermost.setDelay(allpassL4InnermostSize); // modulate (1212 + 121)
-    allpassL4Inner.setDelay(819 * parameters.roomSize);
-    allpassL4Outer.setDelay(1264 * parameters.roomSize);
+    allpassL4Inner.setDelay(scaleDelay(819 * parameters.roomSize));
+    allpassL4Outer.setDelay(scaleDelay(1264 * parameters.roomSize));
     // R
-    allpassR1.setDelay(205 * parameters.roomSize);
-    allpassR2.setDelay(329 * parameters.roomSize);
-    allpassR3Inner.setDelay(2032 * parameters.roomSize);
-    allpassR3Outer.setDelay(368 * parameters.roomSize);
-    float allpassR4InnermostSize = 1457 * parameters.roomSize;
+    allpassR1.setDelay(scaleDelay(205 * parameters.roomSize));
+    allpassR2.setDelay(scaleDelay(329 * parameters.roomSize));
+    allpassR3Inner.setDelay(scaleDelay(2032 * parameters.roomSize));
+    allpassR3Outer.setDelay(scaleDelay(368 * parameters.roomSize));
+    float allpassR4InnermostSize = scaleDelay(1457 * parameters.roomSize);
     allpassR4Innermost.setDelay(allpassR4InnermostSize); // modulate (1452 + 5)
-    allpassR4Inner.setDelay(688 * parameters.roomSize);
-    allpassR4Outer.setDelay(1340 * parameters.roomSize);
+    allpassR4Inner.setDelay(scaleDelay(688 * parameters.roomSize));
+    allpassR4Outer.setDelay(scaleDelay(1340 * parameters.roomSize));
 
     juce::AudioBuffer<float> reverbBuffer(1, buffer.getNumSamples());
 
@@ -123,7 +128,7 @@ void LargeConcertHallB::processBlock(juce::AudioBuffer<float>& buffer, juce::Mid
     for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
     {
         //================ render next LFO step ================
-        lfoOutput = lfo.renderAudioOutput();
+        lfoOutput = renderModulation(lfo, modulationFade, sample, buffer.getNumSamples());
 
         //======== take sample in from buffer; add to channel inputs ========
         for (int channel = 0; channel < (buffer.getNumChannels() <= 2 ? buffer.getNumChannels() : 2); ++channel)
@@ -197,9 +202,9 @@ void LargeConcertHallB::processBlock(juce::AudioBuffer<float>& buffer, juce::Mid
         reverbData[sample] = loopDelayL3.popSample(0);
         // start output L
         channelOutput.at(0) =
-            (loopDelayL3.getSampleAtDelay(0, 276) * 0.938) - (loopDelayL3.getSampleAtDelay(0, 312) * 0.438);
+            (loopDelayL3.getSampleAtDelay(0, tap(276)) * 0.938) - (loopDelayL3.getSampleAtDelay(0, tap(312)) * 0.438);
         // output R
-        channelOutput.at(1) += loopDelayL3.getSampleAtDelay(0, 40) * 0.438;
+        channelOutput.at(1) += loopDelayL3.getSampleAtDelay(0, tap(40)) * 0.438;
 
         // nested allpass 4
         // begin outer
@@ -212,9 +217,9 @@ void LargeConcertHallB::processBlock(juce::AudioBuffer<float>& buffer, juce::Mid
         feedbackInner = allpassOutputInner * 0.25 * parameters.diffusion;
         reverbData[sample] += feedbackInner;
         feedforwardInner = reverbData[sample] * -0.25 * parameters.diffusion;
-        // innermost
+        // innermost, modulated
         allpassOutputInnermost = allpassL4Innermost.popSample(
-            0, allpassL4InnermostSize + (lfoOutput.normalOutput * 150.0f * parameters.modDepth)); // modulate
+            0, allpassL4InnermostSize + (lfoOutput.normalOutput * 150.0f * delayScale * parameters.modDepth));
         // one-pole lowpass - rename delays later
         allpassChorusL.pushSample(0, allpassOutputInnermost);
         allpassOutputInnermost *= 0.781;
@@ -239,7 +244,7 @@ void LargeConcertHallB::processBlock(juce::AudioBuffer<float>& buffer, juce::Mid
         reverbData[sample] = loopDelayL4.popSample(0);
         // output R
         channelOutput.at(1) +=
-            (loopDelayL4.getSampleAtDelay(0, 36) * 0.469) + (loopDelayL4.getSampleAtDelay(0, 1572) * 0.125);
+            (loopDelayL4.getSampleAtDelay(0, tap(36)) * 0.469) + (loopDelayL4.getSampleAtDelay(0, tap(1572)) * 0.125);
 
         // feedback *TO* R channel
         channelFeedback.at(1) = reverbData[sample];
@@ -268,7 +273,7 @@ void LargeConcertHallB::processBlock(juce::AudioBuffer<float>& buffer, juce::Mid
         loopDelayR2.pushSample(0, reverbData[sample]);
         reverbData[sample] = loopDelayR2.popSample(0);
         // output L
-        channelOutput.at(0) += loopDelayR2.getSampleAtDelay(0, 625) * 0.938;
+        channelOutput.at(0) += loopDelayR2.getSampleAtDelay(0, tap(625)) * 0.938;
 
         // nested allpass 3
         // begin outer
@@ -291,9 +296,9 @@ void LargeConcertHallB::processBlock(juce::AudioBuffer<float>& buffer, juce::Mid
         loopDelayR3.pushSample(0, reverbData[sample]);
         reverbData[sample] = loopDelayR3.popSample(0);
         // output L
-        channelOutput.at(0) += loopDelayR3.getSampleAtDelay(0, 468) * 0.438;
+        channelOutput.at(0) += loopDelayR3.getSampleAtDelay(0, tap(468)) * 0.438;
         channelOutput.at(1) +=
-            (loopDelayR3.getSampleAtDelay(0, 24) * 0.938) - (loopDelayR3.getSampleAtDelay(0, 192) * 0.438);
+            (loopDelayR3.getSampleAtDelay(0, tap(24)) * 0.938) - (loopDelayR3.getSampleAtDelay(0, tap(192)) * 0.438);
 
         // allpass 4
         // begin outer
@@ -306,9 +311,9 @@ void LargeConcertHallB::processBlock(juce::AudioBuffer<float>& buffer, juce::Mid
         feedbackInner = allpassOutputInner * 0.25 * parameters.diffusion;
         reverbData[sample] += feedbackInner;
         feedforwardInner = reverbData[sample] * -0.25 * parameters.diffusion;
-        // innermost
+        // innermost, modulated
         allpassOutputInnermost = allpassR4Innermost.popSample(
-            0, allpassR4InnermostSize + (lfoOutput.quadPhaseOutput_pos * 150.0f * parameters.modDepth)); // modulate
+            0, allpassR4InnermostSize + (lfoOutput.quadPhaseOutput_pos * 150.0f * delayScale * parameters.modDepth));
         // one-pole lowpass - rename delays later
         allpassChorusR.pushSample(0, allpassOutputInnermost);
         allpassOutputInnermost *= 0.781;
@@ -332,7 +337,7 @@ void LargeConcertHallB::processBlock(juce::AudioBuffer<float>& buffer, juce::Mid
         loopDelayR4.pushSample(0, reverbData[sample]);
         reverbData[sample] = loopDelayR4.popSample(0);
         // output L
-        channelOutput.at(0) += loopDelayR4.getSampleAtDelay(0, 8) * 0.125;
+        channelOutput.at(0) += loopDelayR4.getSampleAtDelay(0, tap(8)) * 0.125;
 
         // feedback *TO* L channel
         channelFeedback.at(0) = reverbData[sample];
@@ -393,6 +398,27 @@ void LargeConcertHallB::reset()
     allpassR4Outer.reset();
 
     lfo.reset(sampleRate);
+
+    modulationFade.finishFade();
+}
+
+int LargeConcertHallB::getNumQualityTiers()
+{
+    return 2;
+}
+
+double LargeConcertHallB::getTailLengthSeconds()
+{
+    // the left and right chains feed each other, so a trip round the loop goes through both; each chain's allpass
+    // outputs are scaled by the same constants, and by decayTime 15 times across the two chains and the feedback inputs
+    double chainGain = 0.844 * 0.906 * (0.938 * 0.844) * (0.938 * 0.938 * 0.844);
+    double loopGain = chainGain * chainGain * std::pow(parameters.decayTime, 15.0f);
+
+    int leftSamples = 2 + 1055 + 344 + 1572 + 239 + 392 + 1944 + 612 + 1333 + 819 + 1264;
+    int rightSamples = 1 + 1460 + 500 + 16 + 205 + 329 + 2032 + 368 + 1457 + 688 + 1340;
+    double loopSeconds = (leftSamples + rightSamples) * parameters.roomSize * delayScale / sampleRate;
+
+    return loopSeconds + loopDecayTime(loopGain, loopSeconds);
 }
 
 ReverbProcessorParameters& LargeConcertHallB::getParameters()
@@ -8,8 +8,10 @@
 #include "CustomDelays.h"
 #include "LFO.h"
 #include "ProcessorBase.h"
+#include "QualityTiers.h"
 #include "Utilities.h"
 
+// written out by hand rather than as an allpass graph topology, as its loops cross-feed; see AllpassGraph.h
 class LargeConcertHallB : public ReverbProcessorBase
 {
   public:
@@ -27,6 +29,11 @@ class LargeConcertHallB : public ReverbProcessorBase
 
     void setParameters(const ReverbProcessorParameters& params) override;
 
+    double getTailLengthSeconds() override;
+
+    // 0: as designed; 1: unmodulated
+    int getNumQualityTiers() override;
+
   private:
     // parameter class
     ReverbProcessorParameters parameters;
@@ -44,14 +51,14 @@ class LargeConcertHallB : public ReverbProcessorBase
     juce::dsp::DelayLine<float> inputZ{4};
     // L
     DelayLineWithSampleAccess<float> loopDelayL1{8};
-    DelayLineWithSampleAccess<float> loopDelayL2{4410};
-    DelayLineWithSampleAccess<float> loopDelayL3{4410};
-    DelayLineWithSampleAccess<float> loopDelayL4{4410};
+    DelayLineWithSampleAccess<float, ReverbDelayStorage> loopDelayL2{4410};
+    DelayLineWithSampleAccess<float, ReverbDelayStorage> loopDelayL3{4410};
+    DelayLineWithSampleAccess<float, ReverbDelayStorage> loopDelayL4{4410};
     // R
     DelayLineWithSampleAccess<float> loopDelayR1{8};
-    DelayLineWithSampleAccess<float> loopDelayR2{4410};
-    DelayLineWithSampleAccess<float> loopDelayR3{4410};
-    DelayLineWithSampleAccess<float> loopDelayR4{4410};
+    DelayLineWithSampleAccess<float, ReverbDelayStorage> loopDelayR2{4410};
+    DelayLineWithSampleAccess<float, ReverbDelayStorage> loopDelayR3{4410};
+    DelayLineWithSampleAccess<float, ReverbDelayStorage> loopDelayR4{4410};
 
     // allpasses
     // L
@@ -74,6 +81,7 @@ class LargeConcertHallB : public ReverbProcessorBase
     OscillatorParameters lfoParameters;
     SignalGenData lfoOutput;
     LFO lfo;
+    TierFade modulationFade;
 
     float allpassOutputInnermost = 0;
     float allpassOutputInner = 0;
@@ -0,0 +1,223 @@
+// Replaces a time-invariant reverb with convolution by its captured impulse response
+
+#include "ConvolutionFastPath.h"
+
+ConvolutionFastPath::ConvolutionFastPath() : juce::Thread("RSAlgorithmicVerb IR capture")
+{
+}
+
+ConvolutionFastPath::~ConvolutionFastPath()
+{
+    stopThread(4000);
+}
+
+void ConvolutionFastPath::setCache(std::unique_ptr<ImpulseResponseCache> newCache)
+{
+    jassert(!isThreadRunning());
+    cache = std::move(newCache);
+}
+
+void ConvolutionFastPath::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    stopThread(4000);
+
+    sampleRate = spec.sampleRate;
+    numChannels = static_cast<int>(spec.numChannels);
+
+    // each engine runs at the full bus width: its input channel copied to every output channel
+    engines.clear();
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        engines.push_back(
+            std::make_unique<juce::dsp::Convolution>(juce::dsp::Convolution::NonUniform{convolutionHeadSize}));
+        engines.back()->prepare(spec);
+    }
+
+    engineBuffer.setSize(numChannels, static_cast<int>(spec.maximumBlockSize));
+    outputBuffer.setSize(numChannels, static_cast<int>(spec.maximumBlockSize));
+
+    // anything captured before was for the old sample rate or layout
+    {
+        const juce::SpinLock::ScopedLockType lock(requestLock);
+        requestedSettings = {};
+        capturedSettings = {};
+    }
+
+    startThread();
+}
+
+void ConvolutionFastPath::reset()
+{
+    for (auto& engine : engines)
+        engine->reset();
+}
+
+void ConvolutionFastPath::requestImpulseResponse(int algorithmIndex, const ReverbProcessorParameters& params)
+{
+    auto settings = makeSettings(algorithmIndex, params);
+
+    {
+        const juce::SpinLock::ScopedLockType lock(requestLock);
+        if (settings == requestedSettings)
+            return;
+
+        requestedSettings = settings;
+    }
+
+    notify();
+}
+
+bool ConvolutionFastPath::isReadyFor(int algorithmIndex, const ReverbProcessorParameters& params) const
+{
+    auto settings = makeSettings(algorithmIndex, params);
+
+    const juce::SpinLock::ScopedLockType lock(requestLock);
+    return settings == capturedSettings;
+}
+
+void ConvolutionFastPath::process(juce::AudioBuffer<float>& buffer)
+{
+    int numSamples = buffer.getNumSamples();
+    int numBusChannels = juce::jmin(buffer.getNumChannels(), numChannels);
+
+    // outputs are accumulated separately, since every engine reads from the buffer being replaced
+    outputBuffer.setSize(numBusChannels, numSamples, false, false, true);
+    outputBuffer.clear();
+    engineBuffer.setSize(numBusChannels, numSamples, false, false, true);
+
+    for (int inputChannel = 0; inputChannel < numBusChannels; ++inputChannel)
+    {
+        for (int channel = 0; channel < numBusChannels; ++channel)
+            engineBuffer.copyFrom(channel, 0, buffer, inputChannel, 0, numSamples);
+
+        juce::dsp::AudioBlock<float> block{engineBuffer};
+        engines[static_cast<size_t>(inputChannel)]->process(juce::dsp::ProcessContextReplacing<float>(block));
+
+        for (int channel = 0; channel < numBusChannels; ++channel)
+            outputBuffer.addFrom(channel, 0, engineBuffer, channel, 0, numSamples);
+    }
+
+    for (int channel = 0; channel < numBusChannels; ++channel)
+        buffer.copyFrom(channel, 0, outputBuffer, channel, 0, numSamples);
+}
+
+void ConvolutionFastPath::run()
+{
+    while (!threadShouldExit())
+    {
+        wait(-1);
+
+        ImpulseResponseSettings settings;
+        {
+            const juce::SpinLock::ScopedLockType lock(requestLock);
+            settings = requestedSettings;
+        }
+
+        // a newer request arriving mid-capture notifies again, so only the latest settings get captured
+        if (settings.algorithmIndex < 0 || settings == capturedSettings)
+            continue;
+
+        std::vector<juce::AudioBuffer<float>> impulseResponses;
+        if (cache == nullptr || !cache->load(settings, impulseResponses))
+        {
+            impulseResponses.clear();
+            for (int inputChannel = 0; inputChannel < settings.numChannels; ++inputChannel)
+            {
+                auto impulseResponse = capture(settings, inputChannel);
+                if (impulseResponse.getNumSamples() == 0)
+                    break;
+
+                impulseResponses.push_back(std::move(impulseResponse));
+            }
+
+            if (static_cast<int>(impulseResponses.size()) < settings.numChannels)
+                continue;
+
+            if (cache != nullptr)
+                cache->store(settings, impulseResponses);
+        }
+
+        // the engines load on their own background thread and crossfade from the previous response
+        for (int inputChannel = 0; inputChannel < settings.numChannels; ++inputChannel)
+            engines[static_cast<size_t>(inputChannel)]->loadImpulseResponse(
+                std::move(impulseResponses[static_cast<size_t>(inputChannel)]), settings.sampleRate,
+                settings.numChannels > 1 ? juce::dsp::Convolution::Stereo::yes : juce::dsp::Convolution::Stereo::no,
+                juce::dsp::Convolution::Trim::no, juce::dsp::Convolution::Normalise::no);
+
+        const juce::SpinLock::ScopedLockType lock(requestLock);
+        capturedSettings = settings;
+    }
+}
+
+ImpulseResponseSettings ConvolutionFastPath::makeSettings(int algorithmIndex,
+                                                          const ReverbProcessorParameters& params) const
+{
+    ImpulseResponseSettings settings;
+    settings.algorithmIndex = algorithmIndex;
+    settings.parameters = params;
+    settings.sampleRate = sampleRate;
+    settings.numChannels = numChannels;
+    return settings;
+}
+
+juce::AudioBuffer<float> ConvolutionFastPath::capture(const ImpulseResponseSettings& settings, int inputChannel)
+{
+    // as processBlock does for the audio thread
+    juce::ScopedNoDenormals noDenormals;
+
+    auto reverb = processorFactory.create(settings.algorithmIndex);
+    if (reverb == nullptr)
+        return {};
+
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate = settings.sampleRate;
+    spec.maximumBlockSize = captureBlockSize;
+    spec.numChannels = static_cast<juce::uint32>(settings.numChannels);
+
+    reverb->prepare(spec);
+    reverb->setParameters(settings.parameters);
+    reverb->reset();
+
+    int maxLength = static_cast<int>(std::ceil(maxImpulseResponseSeconds * settings.sampleRate));
+    int silentLength = static_cast<int>(std::ceil(silenceSeconds * settings.sampleRate));
+
+    juce::AudioBuffer<float> impulseResponse(settings.numChannels, maxLength);
+    juce::AudioBuffer<float> block(settings.numChannels, captureBlockSize);
+    juce::MidiBuffer midiMessages;
+
+    int length = maxLength;
+    int silentSamples = 0;
+    bool started = false;
+
+    for (int position = 0; position < maxLength; position += captureBlockSize)
+    {
+        if (threadShouldExit())
+            return {};
+
+        int numSamples = juce::jmin(captureBlockSize, maxLength - position);
+        block.setSize(settings.numChannels, numSamples, false, false, true);
+        block.clear();
+        if (position == 0)
+            block.setSample(inputChannel, 0, 1.0f);
+
+        reverb->processBlock(block, midiMessages);
+
+        for (int channel = 0; channel < settings.numChannels; ++channel)
+            impulseResponse.copyFrom(channel, position, block, channel, 0, numSamples);
+
+        // don't count the silence before the first arrival
+        if (block.getMagnitude(0, numSamples) > silenceThreshold)
+        {
+            started = true;
+            silentSamples = 0;
+        }
+        else if (started && (silentSamples += numSamples) >= silentLength)
+        {
+            length = position + numSamples;
+            break;
+        }
+    }
+
+    impulseResponse.setSize(settings.numChannels, length, true, false, false);
+    return impulseResponse;
+}
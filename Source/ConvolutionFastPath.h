@@ -0,0 +1,68 @@
+// Replaces a time-invariant reverb with convolution by its captured impulse response
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "ImpulseResponseCache.h"
+#include "ProcessorBase.h"
+#include "ProcessorFactory.h"
+#include "Utilities.h"
+
+class ConvolutionFastPath : private juce::Thread
+{
+  public:
+    ConvolutionFastPath();
+
+    ~ConvolutionFastPath() override;
+
+    // optional; captures are looked up here first and written back after rendering. Call before prepare()
+    void setCache(std::unique_ptr<ImpulseResponseCache> newCache);
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+
+    void reset();
+
+    // asks for the impulse response of this algorithm with these unscaled parameters, captured on a background thread
+    // from a separate instance; cheap enough to call every block, since repeated requests are ignored
+    void requestImpulseResponse(int algorithmIndex, const ReverbProcessorParameters& params);
+
+    // true once the impulse response of this algorithm with exactly these parameters is loaded; after a change, false
+    // until the capture for the new settings replaces the old one, so a stale response is never used
+    bool isReadyFor(int algorithmIndex, const ReverbProcessorParameters& params) const;
+
+    // convolves buffer in place; each input channel has its own impulse response to every output channel
+    void process(juce::AudioBuffer<float>& buffer);
+
+  private:
+    void run() override;
+
+    // the settings a capture of this algorithm and these parameters would have, at the prepared rate and layout
+    ImpulseResponseSettings makeSettings(int algorithmIndex, const ReverbProcessorParameters& params) const;
+
+    // one output channel per bus channel, for a unit impulse into inputChannel; empty if the thread is stopping
+    juce::AudioBuffer<float> capture(const ImpulseResponseSettings& settings, int inputChannel);
+
+    static constexpr int captureBlockSize = 512;
+    static constexpr double maxImpulseResponseSeconds = 10.0;
+    // the capture stops once the response has stayed below this for silenceSeconds
+    static constexpr float silenceThreshold = 1.0e-5f;
+    static constexpr double silenceSeconds = 0.1;
+    static constexpr int convolutionHeadSize = 512;
+
+    ProcessorFactory processorFactory;
+    std::unique_ptr<ImpulseResponseCache> cache;
+
+    // one engine per input channel, each with one impulse response channel per output channel
+    std::vector<std::unique_ptr<juce::dsp::Convolution>> engines;
+    juce::AudioBuffer<float> engineBuffer;
+    juce::AudioBuffer<float> outputBuffer;
+
+    // guards both settings; the capture thread only writes capturedSettings once the engines have its response
+    juce::SpinLock requestLock;
+    ImpulseResponseSettings requestedSettings;
+    ImpulseResponseSettings capturedSettings;
+
+    double sampleRate = 44100.0;
+    int numChannels = 2;
+};
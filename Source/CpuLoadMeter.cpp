@@ -0,0 +1,92 @@
+// Per-callback DSP load as a fraction of the block's real-time budget, passed to the editor through a lock-free FIFO,
+// and the late reverb stage's load, wherever it runs
+
+#include "CpuLoadMeter.h"
+
+CpuLoadMeter::ScopedCallback::ScopedCallback(CpuLoadMeter& owner, int numSamplesInBlock)
+    : meter(owner), numSamples(numSamplesInBlock), startTicks(juce::Time::getHighResolutionTicks())
+{
+}
+
+CpuLoadMeter::ScopedCallback::~ScopedCallback()
+{
+    if (numSamples <= 0 || meter.ticksPerSample <= 0)
+        return;
+
+    auto elapsedTicks = juce::Time::getHighResolutionTicks() - startTicks;
+    meter.push(static_cast<float>(elapsedTicks / (numSamples * meter.ticksPerSample)));
+}
+
+//==============================================================================
+CpuLoadMeter::ScopedLateStage::ScopedLateStage(CpuLoadMeter& owner, int numSamplesInBlock)
+    : meter(owner), numSamples(numSamplesInBlock), startTicks(juce::Time::getHighResolutionTicks())
+{
+}
+
+CpuLoadMeter::ScopedLateStage::~ScopedLateStage()
+{
+    if (numSamples <= 0 || meter.ticksPerSample <= 0)
+        return;
+
+    auto elapsedTicks = juce::Time::getHighResolutionTicks() - startTicks;
+    meter.lastLateStageLoad.store(static_cast<float>(elapsedTicks / (numSamples * meter.ticksPerSample)));
+}
+
+//==============================================================================
+CpuLoadMeter::CpuLoadMeter()
+{
+    fifoBuffer.resize(fifoSize);
+}
+
+void CpuLoadMeter::prepare(double sampleRate)
+{
+    ticksPerSample = static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()) / sampleRate;
+    numOverruns = 0;
+    lastLoad = 0;
+    lastLateStageLoad.store(0);
+}
+
+int CpuLoadMeter::readLoads(float* dest, int maxLoads)
+{
+    const auto scope = fifo.read(std::min(maxLoads, fifo.getNumReady()));
+    int numRead = 0;
+    scope.forEach([this, dest, &numRead](int index) { dest[numRead++] = fifoBuffer[static_cast<size_t>(index)]; });
+    return numRead;
+}
+
+void CpuLoadMeter::discardLoads()
+{
+    fifo.read(fifo.getNumReady());
+}
+
+int CpuLoadMeter::getNumOverruns() const
+{
+    return numOverruns;
+}
+
+float CpuLoadMeter::getLastLoad() const
+{
+    return lastLoad;
+}
+
+float CpuLoadMeter::getLastLateStageLoad() const
+{
+    return lastLateStageLoad.load();
+}
+
+void CpuLoadMeter::resetLateStageLoad()
+{
+    lastLateStageLoad.store(0);
+}
+
+void CpuLoadMeter::push(float load)
+{
+    lastLoad = load;
+    if (load > 1.0f)
+        ++numOverruns;
+
+    // nothing reads the FIFO while the editor is closed, so once it's full new loads are dropped
+    const auto scope = fifo.write(1);
+    if (scope.blockSize1 > 0)
+        fifoBuffer[static_cast<size_t>(scope.startIndex1)] = load;
+}
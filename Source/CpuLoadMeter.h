@@ -0,0 +1,80 @@
+// Per-callback DSP load as a fraction of the block's real-time budget, passed to the editor through a lock-free FIFO,
+// and the late reverb stage's load, wherever it runs
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class CpuLoadMeter
+{
+  public:
+    // times one processBlock call; create at the top of processBlock
+    class ScopedCallback
+    {
+      public:
+        ScopedCallback(CpuLoadMeter& owner, int numSamples);
+        ~ScopedCallback();
+
+      private:
+        CpuLoadMeter& meter;
+        int numSamples;
+        juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedCallback)
+    };
+
+    // times one run of the late reverb stage against the budget of the samples it processes; create at the top of the
+    // stage, on whichever thread runs it. Its channel workers are waited for before it returns, so they're included
+    class ScopedLateStage
+    {
+      public:
+        ScopedLateStage(CpuLoadMeter& owner, int numSamples);
+        ~ScopedLateStage();
+
+      private:
+        CpuLoadMeter& meter;
+        int numSamples;
+        juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedLateStage)
+    };
+
+    CpuLoadMeter();
+
+    // call from prepareToPlay, before any callbacks are timed
+    void prepare(double sampleRate);
+
+    // single consumer, normally the editor's timer; copies up to maxLoads of the oldest loads not yet read into
+    // dest, 1.0 being the whole budget, and returns how many were copied
+    int readLoads(float* dest, int maxLoads);
+
+    // same consumer as readLoads; drops every load not yet read
+    void discardLoads();
+
+    // callbacks that took longer than their budget since prepare(); any thread
+    int getNumOverruns() const;
+
+    // load of the last callback timed; audio thread only
+    float getLastLoad() const;
+
+    // load of the last late stage timed, 0 before the first; any thread. Pipelined, the stage runs on its own thread
+    // and its load doesn't show in the callback's
+    float getLastLateStageLoad() const;
+
+    // forgets the late stage's load, for when it stops running; not while it's running
+    void resetLateStageLoad();
+
+  private:
+    void push(float load);
+
+    static constexpr int fifoSize = 4096;
+
+    juce::AbstractFifo fifo{fifoSize};
+    std::vector<float> fifoBuffer;
+
+    std::atomic<int> numOverruns{0};
+    float lastLoad = 0;
+    std::atomic<float> lastLateStageLoad{0};
+
+    double ticksPerSample = 0;
+};
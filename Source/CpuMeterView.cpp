@@ -0,0 +1,126 @@
+// Editor display of the DSP load: current load, peak-hold, histogram and an overrun-risk light
+
+#include "CpuMeterView.h"
+
+CpuMeterView::CpuMeterView(CpuLoadMeter& meterToShow, std::function<bool()> isIdle)
+    : meter(meterToShow), isProcessingIdle(std::move(isIdle))
+{
+    loads.resize(maxLoadsPerRefresh);
+
+    // whatever piled up while the editor was closed is out of date
+    meter.discardLoads();
+    lastNumOverruns = meter.getNumOverruns();
+
+    startTimerHz(refreshRateHz);
+}
+
+CpuMeterView::~CpuMeterView()
+{
+    stopTimer();
+}
+
+void CpuMeterView::paint(juce::Graphics& g)
+{
+    auto area = getLocalBounds().toFloat();
+
+    // overrun-risk light: red after an overrun, amber when the peak is close to the budget
+    auto light = area.removeFromLeft(area.getHeight()).reduced(area.getHeight() * 0.3f);
+    if (overrunHoldRefreshes > 0)
+        g.setColour(juce::Colours::red);
+    else if (peakLoad > riskThreshold)
+        g.setColour(juce::Colours::orange);
+    else
+        g.setColour(juce::Colours::lightslategrey);
+    g.fillEllipse(light);
+    area.removeFromLeft(8.0f);
+
+    // load bar with the peak-hold marker
+    auto text = area.removeFromBottom(16.0f);
+    auto bar = area.removeFromLeft(area.getWidth() * 0.6f).reduced(0.0f, 4.0f);
+    g.setColour(juce::Colour::fromRGB(68, 81, 96));
+    g.fillRoundedRectangle(bar, 3.0f);
+    g.setColour(currentLoad > riskThreshold ? juce::Colours::orange : juce::Colours::lightsteelblue);
+    g.fillRoundedRectangle(bar.withWidth(bar.getWidth() * juce::jlimit(0.0f, 1.0f, currentLoad)), 3.0f);
+    g.setColour(juce::Colours::aliceblue);
+    float peakX = bar.getX() + bar.getWidth() * juce::jlimit(0.0f, 1.0f, peakLoad);
+    g.drawLine(peakX, bar.getY(), peakX, bar.getBottom(), 2.0f);
+
+    // histogram of every load read since the last reset
+    area.removeFromLeft(8.0f);
+    auto maxCount = *std::max_element(histogram.begin(), histogram.end());
+    if (maxCount > 0)
+    {
+        float binWidth = area.getWidth() / numHistogramBins;
+        for (int bin = 0; bin < numHistogramBins; ++bin)
+        {
+            float height = area.getHeight() * static_cast<float>(histogram[static_cast<size_t>(bin)]) / maxCount;
+            g.setColour(bin == numHistogramBins - 1 ? juce::Colours::red : juce::Colours::lightsteelblue);
+            g.fillRect(area.getX() + bin * binWidth, area.getBottom() - height, binWidth - 1.0f, height);
+        }
+    }
+
+    g.setColour(juce::Colours::aliceblue);
+    g.setFont(13.0f);
+    // while idle the callbacks only run the mixer, so their load says nothing about the reverb's
+    auto load = idle ? juce::String("idle") : juce::String(juce::roundToInt(currentLoad * 100.0f)) + "%";
+    g.drawText("CPU " + load + "  peak " + juce::String(juce::roundToInt(peakLoad * 100.0f)) + "%  overruns " +
+                   juce::String(meter.getNumOverruns()),
+               text, juce::Justification::centredLeft);
+}
+
+void CpuMeterView::mouseDown(const juce::MouseEvent&)
+{
+    peakLoad = 0;
+    peakHoldRefreshes = 0;
+    histogram.fill(0);
+    repaint();
+}
+
+void CpuMeterView::timerCallback()
+{
+    idle = isProcessingIdle();
+
+    int numLoads = meter.readLoads(loads.data(), maxLoadsPerRefresh);
+
+    if (numLoads > 0)
+    {
+        // the display shows the worst callback since the last refresh, which is the one that would glitch
+        float worstLoad = *std::max_element(loads.begin(), loads.begin() + numLoads);
+        currentLoad = worstLoad;
+
+        for (int i = 0; i < numLoads; ++i)
+        {
+            int bin = juce::jlimit(0, numHistogramBins - 1, static_cast<int>(loads[i] * 10.0f));
+            ++histogram[static_cast<size_t>(bin)];
+        }
+
+        if (worstLoad >= peakLoad)
+        {
+            peakLoad = worstLoad;
+            peakHoldRefreshes = juce::roundToInt(peakHoldSeconds * refreshRateHz);
+        }
+    }
+    else
+    {
+        // no callbacks, e.g. the transport's stopped and the host has stopped processing
+        currentLoad = 0;
+    }
+
+    if (peakHoldRefreshes > 0)
+        --peakHoldRefreshes;
+    else
+        peakLoad = std::max(currentLoad, peakLoad - peakReleasePerRefresh);
+
+    int numOverruns = meter.getNumOverruns();
+    if (numOverruns != lastNumOverruns)
+    {
+        lastNumOverruns = numOverruns;
+        overrunHoldRefreshes = juce::roundToInt(peakHoldSeconds * refreshRateHz);
+    }
+    else if (overrunHoldRefreshes > 0)
+    {
+        --overrunHoldRefreshes;
+    }
+
+    repaint();
+}
@@ -0,0 +1,50 @@
+// Editor display of the DSP load: current load, peak-hold, histogram and an overrun-risk light
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "CpuLoadMeter.h"
+
+class CpuMeterView : public juce::Component, private juce::Timer
+{
+  public:
+    // isIdle says whether the plugin has stopped running the reverb for silence; called on the message thread
+    CpuMeterView(CpuLoadMeter& meterToShow, std::function<bool()> isIdle);
+
+    ~CpuMeterView() override;
+
+    void paint(juce::Graphics&) override;
+
+    // clears the peak and histogram
+    void mouseDown(const juce::MouseEvent&) override;
+
+  private:
+    void timerCallback() override;
+
+    static constexpr int refreshRateHz = 15;
+    // loads read per refresh; more than enough for the smallest block sizes
+    static constexpr int maxLoadsPerRefresh = 1024;
+    static constexpr double peakHoldSeconds = 2.0;
+    static constexpr float peakReleasePerRefresh = 0.02f;
+    // loads above this leave little headroom for the rest of the session
+    static constexpr float riskThreshold = 0.7f;
+    // 10% bins, the last collecting everything over budget
+    static constexpr int numHistogramBins = 11;
+
+    CpuLoadMeter& meter;
+    std::function<bool()> isProcessingIdle;
+    std::vector<float> loads;
+
+    bool idle = false;
+
+    float currentLoad = 0;
+    float peakLoad = 0;
+    int peakHoldRefreshes = 0;
+    std::array<juce::int64, numHistogramBins> histogram{};
+
+    int lastNumOverruns = 0;
+    int overrunHoldRefreshes = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CpuMeterView)
+};
@@ -3,65 +3,235 @@
 #include "CustomDelays.h"
 #include "Utilities.h"
 #include <algorithm>
+#include <type_traits>
 
-template <typename SampleType>
-DelayLineWithSampleAccess<SampleType>::DelayLineWithSampleAccess(int maximumDelayInSamples)
+template <typename SampleType, typename StorageType>
+DelayLineWithSampleAccess<SampleType, StorageType>::DelayLineWithSampleAccess(int maximumDelayInSamples)
 {
     jassert(maximumDelayInSamples >= 0);
 
     totalSize = maximumDelayInSamples + 1 > 4 ? maximumDelayInSamples + 1 : 4;
-    delayBuffer.setSize(static_cast<int>(delayBuffer.getNumChannels()), totalSize, false, false, false);
-    delayBuffer.clear();
-    numSamples = delayBuffer.getNumSamples();
+    numSamples = totalSize;
 }
 
-template <typename SampleType> DelayLineWithSampleAccess<SampleType>::~DelayLineWithSampleAccess()
+template <typename SampleType, typename StorageType>
+DelayLineWithSampleAccess<SampleType, StorageType>::~DelayLineWithSampleAccess()
 {
 }
 
-template <typename SampleType> void DelayLineWithSampleAccess<SampleType>::pushSample(int channel, SampleType newValue)
+template <typename SampleType, typename StorageType>
+void DelayLineWithSampleAccess<SampleType, StorageType>::pushSample(int channel, SampleType newValue)
 {
-    delayBuffer.setSample(channel, writePosition[static_cast<size_t>(channel)], newValue);
+    delayBuffer[static_cast<size_t>(channel) * static_cast<size_t>(numSamples) +
+                static_cast<size_t>(writePosition[static_cast<size_t>(channel)])] =
+        DelayStorage<StorageType>::encode(newValue);
     writePosition[static_cast<size_t>(channel)] = (writePosition[static_cast<size_t>(channel)] + 1) % numSamples;
 }
 
-template <typename SampleType> SampleType DelayLineWithSampleAccess<SampleType>::popSample(int channel)
+template <typename SampleType, typename StorageType>
+SampleType DelayLineWithSampleAccess<SampleType, StorageType>::popSample(int channel)
 {
     readPosition[static_cast<size_t>(channel)] =
         wrapInt((writePosition[static_cast<size_t>(channel)] - delayInSamples), numSamples);
-    return delayBuffer.getSample(channel, readPosition[static_cast<size_t>(channel)]);
+    return load(getReadPointer(channel), readPosition[static_cast<size_t>(channel)]);
 }
 
-template <typename SampleType>
-SampleType DelayLineWithSampleAccess<SampleType>::getSampleAtDelay(int channel, int delay) const
+template <typename SampleType, typename StorageType>
+SampleType DelayLineWithSampleAccess<SampleType, StorageType>::getSampleAtDelay(int channel, int delay) const
 {
-    return delayBuffer.getSample(channel, wrapInt((writePosition[static_cast<size_t>(channel)] - delay), numSamples));
+    return load(getReadPointer(channel), wrapInt((writePosition[static_cast<size_t>(channel)] - delay), numSamples));
 }
 
-template <typename SampleType> void DelayLineWithSampleAccess<SampleType>::setDelay(int newLength)
+template <typename SampleType, typename StorageType>
+SampleType DelayLineWithSampleAccess<SampleType, StorageType>::getSampleAtDelay(int channel, SampleType delay,
+                                                                               DelayInterpolation interpolation)
+{
+    SampleType output = 0;
+    getSamplesAtDelays(channel, &delay, &output, 1, interpolation, &v[static_cast<size_t>(channel)]);
+    return output;
+}
+
+template <typename SampleType, typename StorageType>
+void DelayLineWithSampleAccess<SampleType, StorageType>::getSamplesAtDelays(int channel, const SampleType* delays,
+                                                                            SampleType* output, int numTaps,
+                                                                            DelayInterpolation interpolation,
+                                                                            SampleType* allpassState) const
+{
+    jassert(numTaps <= maxGatherTaps);
+
+    const auto* data = getReadPointer(channel);
+
+    alignas(32) int index[maxGatherTaps];
+    alignas(32) SampleType fraction[maxGatherTaps];
+    computeReadPositions(channel, delays, numTaps, interpolation, index, fraction);
+
+    // one loop per interpolator so the choice is made once per call rather than once per tap
+    switch (interpolation)
+    {
+    case DelayInterpolation::linear:
+        for (int tap = 0; tap < numTaps; ++tap)
+        {
+            SampleType newer = load(data, index[tap]);
+            output[tap] = newer + fraction[tap] * (load(data, wrapOlder(index[tap], 1)) - newer);
+        }
+        break;
+    case DelayInterpolation::lagrange3rd:
+        // fraction is in [1, 2) here, so the four points straddle the read position
+        for (int tap = 0; tap < numTaps; ++tap)
+        {
+            SampleType value1 = load(data, index[tap]);
+            SampleType value2 = load(data, wrapOlder(index[tap], 1));
+            SampleType value3 = load(data, wrapOlder(index[tap], 2));
+            SampleType value4 = load(data, wrapOlder(index[tap], 3));
+
+            SampleType d1 = fraction[tap] - 1;
+            SampleType d2 = fraction[tap] - 2;
+            SampleType d3 = fraction[tap] - 3;
+
+            SampleType c1 = -d1 * d2 * d3 / 6;
+            SampleType c2 = d2 * d3 * static_cast<SampleType>(0.5);
+            SampleType c3 = -d1 * d3 * static_cast<SampleType>(0.5);
+            SampleType c4 = d1 * d2 / 6;
+
+            output[tap] = value1 * c1 + fraction[tap] * (value2 * c2 + value3 * c3 + value4 * c4);
+        }
+        break;
+    case DelayInterpolation::allpass:
+        jassert(allpassState != nullptr);
+        // first-order Thiran; fraction is kept in [0.618, 1.618) where the coefficient behaves best
+        for (int tap = 0; tap < numTaps; ++tap)
+        {
+            SampleType value1 = load(data, index[tap]);
+            SampleType value2 = load(data, wrapOlder(index[tap], 1));
+            SampleType alpha = (1 - fraction[tap]) / (1 + fraction[tap]);
+
+            output[tap] = fraction[tap] == 0 ? value1 : value2 + alpha * (value1 - allpassState[tap]);
+            allpassState[tap] = output[tap];
+        }
+        break;
+    }
+}
+
+template <typename SampleType, typename StorageType>
+SampleType DelayLineWithSampleAccess<SampleType, StorageType>::getInterpolatedSum(int channel, const SampleType* delays,
+                                                                                 int numTaps, SampleType gain) const
+{
+    jassert(numTaps <= maxGatherTaps);
+
+    const auto* data = getReadPointer(channel);
+
+    alignas(32) int index[maxGatherTaps];
+    alignas(32) SampleType fraction[maxGatherTaps];
+    computeReadPositions(channel, delays, numTaps, DelayInterpolation::linear, index, fraction);
+
+    // then the gather: two loads per tap, interpolated towards the older sample
+    SampleType sum = 0;
+    int tap = 0;
+#if RSAV_HAS_AVX2
+    // 16-bit history would need widening after the gather, so only float history takes this path
+    if constexpr (std::is_same_v<SampleType, float> && std::is_same_v<StorageType, float>)
+    {
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i length = _mm256_set1_epi32(numSamples);
+        __m256 sums = _mm256_setzero_ps();
+        for (; tap + 8 <= numTaps; tap += 8)
+        {
+            __m256i newerIndex = _mm256_load_si256(reinterpret_cast<const __m256i*>(index + tap));
+            // wrapOlder(index, 1) for all eight
+            __m256i olderIndex = _mm256_sub_epi32(newerIndex, one);
+            olderIndex = _mm256_add_epi32(olderIndex, _mm256_and_si256(_mm256_srai_epi32(olderIndex, 31), length));
+
+            __m256 newer = _mm256_i32gather_ps(data, newerIndex, sizeof(float));
+            __m256 older = _mm256_i32gather_ps(data, olderIndex, sizeof(float));
+            __m256 frac = _mm256_load_ps(fraction + tap);
+            sums = _mm256_add_ps(sums, _mm256_add_ps(newer, _mm256_mul_ps(frac, _mm256_sub_ps(older, newer))));
+        }
+
+        __m128 quad = _mm_add_ps(_mm256_castps256_ps128(sums), _mm256_extractf128_ps(sums, 1));
+        quad = _mm_add_ps(quad, _mm_movehl_ps(quad, quad));
+        sum = _mm_cvtss_f32(_mm_add_ss(quad, _mm_shuffle_ps(quad, quad, 1)));
+    }
+#endif
+
+    // the remaining taps, or all of them without AVX2
+    for (; tap < numTaps; ++tap)
+    {
+        SampleType newer = load(data, index[tap]);
+        sum += newer + fraction[tap] * (load(data, wrapOlder(index[tap], 1)) - newer);
+    }
+
+    return sum * gain;
+}
+
+template <typename SampleType, typename StorageType>
+void DelayLineWithSampleAccess<SampleType, StorageType>::computeReadPositions(int channel, const SampleType* delays,
+                                                                              int numTaps,
+                                                                              DelayInterpolation interpolation,
+                                                                              int* index, SampleType* fraction) const
+{
+    const int writeIndex = writePosition[static_cast<size_t>(channel)];
+
+    // Lagrange and Thiran read one sample newer (when there is one) and add 1 to the fraction below this threshold,
+    // as juce::dsp::DelayLine does; linear never does
+    SampleType recentreBelow = 0;
+    if (interpolation == DelayInterpolation::lagrange3rd)
+        recentreBelow = 1;
+    else if (interpolation == DelayInterpolation::allpass)
+        recentreBelow = static_cast<SampleType>(0.618);
+
+    // branch-free over fixed-size arrays so the compiler can vectorise it
+    for (int tap = 0; tap < numTaps; ++tap)
+    {
+        int wholeDelay = static_cast<int>(delays[tap]);
+        SampleType frac = delays[tap] - static_cast<SampleType>(wholeDelay);
+        int recentre = (wholeDelay >= 1 && frac < recentreBelow) ? 1 : 0;
+        fraction[tap] = frac + static_cast<SampleType>(recentre);
+        int readIndex = writeIndex - (wholeDelay - recentre);
+        index[tap] = readIndex + (readIndex < 0 ? numSamples : 0);
+    }
+}
+
+template <typename SampleType, typename StorageType>
+void DelayLineWithSampleAccess<SampleType, StorageType>::setDelay(int newLength)
 {
     delayInSamples = newLength;
 }
 
-template <typename SampleType>
-void DelayLineWithSampleAccess<SampleType>::setSize(const int numChannels, const int newSize)
+template <typename SampleType, typename StorageType>
+void DelayLineWithSampleAccess<SampleType, StorageType>::setSize(const int newNumChannels, const int newSize)
 {
     totalSize = newSize;
-    delayBuffer.setSize(numChannels, totalSize, false, false, true);
+    numSamples = totalSize;
+    numChannels = newNumChannels;
+    delayBuffer.resize(static_cast<size_t>(numChannels) * static_cast<size_t>(numSamples));
 
     reset();
 }
 
-template <typename SampleType> int DelayLineWithSampleAccess<SampleType>::getNumSamples() const
+template <typename SampleType, typename StorageType>
+void DelayLineWithSampleAccess<SampleType, StorageType>::setMaximumDelayInSamples(int maximumDelayInSamples)
 {
-    return delayBuffer.getNumSamples();
+    jassert(maximumDelayInSamples >= 0);
+
+    setSize(numChannels, maximumDelayInSamples + 1 > 4 ? maximumDelayInSamples + 1 : 4);
 }
 
-template <typename SampleType> void DelayLineWithSampleAccess<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
+template <typename SampleType, typename StorageType>
+int DelayLineWithSampleAccess<SampleType, StorageType>::getNumSamples() const
 {
-    jassert(spec.numChannels > 0);
+    return numSamples;
+}
 
-    delayBuffer.setSize(static_cast<int>(spec.numChannels), totalSize, false, false, true);
+template <typename SampleType, typename StorageType>
+size_t DelayLineWithSampleAccess<SampleType, StorageType>::getMemoryUsage() const
+{
+    return delayBuffer.size() * sizeof(StorageType);
+}
+
+template <typename SampleType, typename StorageType>
+void DelayLineWithSampleAccess<SampleType, StorageType>::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    jassert(spec.numChannels > 0);
 
     writePosition.resize(spec.numChannels);
     readPosition.resize(spec.numChannels);
@@ -69,36 +239,45 @@ template <typename SampleType> void DelayLineWithSampleAccess<SampleType>::prepa
     v.resize(spec.numChannels);
     sampleRate = spec.sampleRate;
 
-    reset();
+    setSize(static_cast<int>(spec.numChannels), totalSize);
 }
 
-template <typename SampleType> void DelayLineWithSampleAccess<SampleType>::reset()
+template <typename SampleType, typename StorageType> void DelayLineWithSampleAccess<SampleType, StorageType>::reset()
 {
     for (auto vec : {&writePosition, &readPosition})
         std::fill(vec->begin(), vec->end(), 0);
 
     std::fill(v.begin(), v.end(), static_cast<SampleType>(0));
 
-    delayBuffer.clear();
+    std::fill(delayBuffer.begin(), delayBuffer.end(), StorageType{});
 }
 
 //============================================================================
 
-template <typename SampleType> Allpass<SampleType>::Allpass() = default;
+template <typename SampleType, typename StorageType> Allpass<SampleType, StorageType>::Allpass() = default;
 
-template <typename SampleType> Allpass<SampleType>::~Allpass() = default;
+template <typename SampleType, typename StorageType> Allpass<SampleType, StorageType>::~Allpass() = default;
 
-template <typename SampleType> void Allpass<SampleType>::setMaximumDelayInSamples(int maxDelayInSamples)
+template <typename SampleType, typename StorageType>
+void Allpass<SampleType, StorageType>::setMaximumDelayInSamples(int newMaxDelayInSamples)
 {
-    delayLine.setMaximumDelayInSamples(maxDelayInSamples);
+    jassert(newMaxDelayInSamples >= 0);
+
+    maxDelayInSamples = newMaxDelayInSamples;
+    delayLine.setMaximumDelayInSamples(maxDelayInSamples + extraSamples);
+    setDelay(delayInSamples);
 }
 
-template <typename SampleType> void Allpass<SampleType>::setDelay(SampleType newDelayInSamples)
+template <typename SampleType, typename StorageType>
+void Allpass<SampleType, StorageType>::setDelay(SampleType newDelayInSamples)
 {
-    delayLine.setDelay(newDelayInSamples);
+    jassert(juce::isPositiveAndNotGreaterThan(newDelayInSamples, static_cast<SampleType>(maxDelayInSamples)));
+
+    delayInSamples = std::clamp<SampleType>(newDelayInSamples, 0, static_cast<SampleType>(maxDelayInSamples));
 }
 
-template <typename SampleType> void Allpass<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
+template <typename SampleType, typename StorageType>
+void Allpass<SampleType, StorageType>::prepare(const juce::dsp::ProcessSpec& spec)
 {
     jassert(spec.numChannels > 0);
 
@@ -119,21 +298,25 @@ template <typename SampleType> void Allpass<SampleType>::prepare(const juce::dsp
     reset();
 }
 
-template <typename SampleType> void Allpass<SampleType>::reset()
+template <typename SampleType, typename StorageType> void Allpass<SampleType, StorageType>::reset()
 {
     delayLine.reset();
 }
 
-template <typename SampleType> void Allpass<SampleType>::pushSample(int channel, SampleType sample)
+template <typename SampleType, typename StorageType>
+void Allpass<SampleType, StorageType>::pushSample(int channel, SampleType sample)
 {
     delayLine.pushSample(channel, sample + feedback[channel]);
     drySample[channel] = sample;
 }
 
-template <typename SampleType>
-SampleType Allpass<SampleType>::popSample(int channel, SampleType delayInSamples, bool updateReadPointer)
+template <typename SampleType, typename StorageType>
+SampleType Allpass<SampleType, StorageType>::popSample(int channel, SampleType newDelayInSamples)
 {
-    delayOutput[channel] = delayLine.popSample(channel, delayInSamples, updateReadPointer);
+    if (newDelayInSamples >= 0)
+        setDelay(newDelayInSamples);
+
+    delayOutput[channel] = readDelay(channel);
 
     feedback[channel] = delayOutput[channel] * gain;
 
@@ -142,15 +325,64 @@ SampleType Allpass<SampleType>::popSample(int channel, SampleType delayInSamples
     return delayOutput[channel] + feedforward[channel];
 }
 
-template <typename SampleType> void Allpass<SampleType>::setGain(SampleType newGain)
+template <typename SampleType, typename StorageType>
+void Allpass<SampleType, StorageType>::processBlock(int channel, SampleType* samples, int numSamples,
+                                                    SampleType baseDelay, const SampleType* modulation,
+                                                    SampleType modulationDepth)
+{
+    // same as pushSample/popSample per sample, with the channel state held in locals for the whole block
+    SampleType channelFeedback = feedback[channel];
+    SampleType dry = drySample[channel];
+    SampleType output = delayOutput[channel];
+    SampleType forward = feedforward[channel];
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        dry = samples[sample];
+        delayLine.pushSample(channel, dry + channelFeedback);
+
+        setDelay(baseDelay + modulation[sample] * modulationDepth);
+        output = readDelay(channel);
+        channelFeedback = output * gain;
+        forward = -dry - output * gain;
+
+        samples[sample] = output + forward;
+    }
+
+    feedback[channel] = channelFeedback;
+    drySample[channel] = dry;
+    delayOutput[channel] = output;
+    feedforward[channel] = forward;
+}
+
+template <typename SampleType, typename StorageType>
+void Allpass<SampleType, StorageType>::setGain(SampleType newGain)
 {
     gain = std::clamp<SampleType>(newGain, 0.0, 1.0);
 }
 
+template <typename SampleType, typename StorageType>
+SampleType Allpass<SampleType, StorageType>::readDelay(int channel) const
+{
+    // the sample just pushed is one sample old to DelayLineWithSampleAccess; the fraction is taken from the delay
+    // itself rather than delay + 1 so it rounds as juce::dsp::DelayLine's does
+    int delayInt = static_cast<int>(delayInSamples);
+    SampleType delayFrac = delayInSamples - static_cast<SampleType>(delayInt);
+
+    SampleType value1 = delayLine.getSampleAtDelay(channel, delayInt + 1);
+    SampleType value2 = delayLine.getSampleAtDelay(channel, delayInt + 2);
+    return value1 + delayFrac * (value2 - value1);
+}
+
 //============================================================================
 
 template class DelayLineWithSampleAccess<float>;
 template class DelayLineWithSampleAccess<double>;
 
+template class DelayLineWithSampleAccess<float, Float16>;
+template class DelayLineWithSampleAccess<float, BFloat16>;
+
 template class Allpass<float>;
 template class Allpass<double>;
+template class Allpass<float, Float16>;
+template class Allpass<float, BFloat16>;
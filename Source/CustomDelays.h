@@ -1,7 +1,8 @@
 /*
 Tapped delay line, Allpass classes
 Delay based on juce::dsp::DelayLine, but allows access to the underlying buffer at specified sample offsets for
-multiple-tap delays.
+multiple-tap delays. StorageType sets how the history is held (see DelayStorage.h); processing is always in
+SampleType.
 */
 
 #pragma once
@@ -9,7 +10,28 @@ multiple-tap delays.
 #include <JuceHeader.h>
 // #include "Utilities.h"
 
-template <typename SampleType> class DelayLineWithSampleAccess
+#include "DelayStorage.h"
+
+#include <algorithm>
+#include <array>
+
+// with AVX2, getInterpolatedSum gathers eight taps' samples at a time from float history
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define RSAV_HAS_AVX2 1
+#else
+#define RSAV_HAS_AVX2 0
+#endif
+
+// interpolation used for fractional tap reads
+enum class DelayInterpolation
+{
+    linear,
+    lagrange3rd,
+    allpass
+};
+
+template <typename SampleType, typename StorageType = SampleType> class DelayLineWithSampleAccess
 {
   public:
     DelayLineWithSampleAccess(int maximumDelayInSamples);
@@ -22,18 +44,61 @@ template <typename SampleType> class DelayLineWithSampleAccess
 
     SampleType getSampleAtDelay(int channel, int delay) const;
 
+    // fractional read; allpass interpolation keeps one state value per channel, so only one allpass-interpolated
+    // read per channel per sample should go through here
+    SampleType getSampleAtDelay(int channel, SampleType delay, DelayInterpolation interpolation);
+
+    // fractional reads at numTaps delays, each in [0, getNumSamples() - 3); read positions for all taps are computed
+    // in one pass before any samples are loaded. Allpass interpolation is recursive and needs one state value per tap
+    // that the caller keeps between samples.
+    void getSamplesAtDelays(int channel, const SampleType* delays, SampleType* output, int numTaps,
+                            DelayInterpolation interpolation, SampleType* allpassState = nullptr) const;
+
+    // sum of linearly interpolated reads at numTaps fractional delays, each in [0, getNumSamples()), times gain
+    SampleType getInterpolatedSum(int channel, const SampleType* delays, int numTaps, SampleType gain) const;
+
     void setDelay(int newLength);
 
-    void setSize(const int numChannels, const int newSize);
+    void setSize(const int newNumChannels, const int newSize);
+
+    // keeps the channel count; clears the history if it has been prepared
+    void setMaximumDelayInSamples(int maximumDelayInSamples);
 
     int getNumSamples() const;
 
+    // bytes of history held across all channels
+    size_t getMemoryUsage() const;
+
     void prepare(const juce::dsp::ProcessSpec& spec);
 
     void reset();
 
+    static constexpr int maxGatherTaps = 32;
+
   private:
-    juce::AudioBuffer<SampleType> delayBuffer;
+    // buffer index of the newer of the samples each tap reads, and the fraction towards the older ones
+    void computeReadPositions(int channel, const SampleType* delays, int numTaps, DelayInterpolation interpolation,
+                              int* index, SampleType* fraction) const;
+
+    int wrapOlder(int index, int offset) const
+    {
+        int olderIndex = index - offset;
+        return olderIndex < 0 ? olderIndex + numSamples : olderIndex;
+    }
+
+    const StorageType* getReadPointer(int channel) const
+    {
+        return delayBuffer.data() + static_cast<size_t>(channel) * static_cast<size_t>(numSamples);
+    }
+
+    static SampleType load(const StorageType* data, int index)
+    {
+        return static_cast<SampleType>(DelayStorage<StorageType>::decode(data[index]));
+    }
+
+    // channels one after another, numSamples each
+    std::vector<StorageType> delayBuffer;
+    int numChannels = 0;
     std::vector<SampleType> v;
     int numSamples = 0;
     std::vector<int> writePosition, readPosition;
@@ -46,7 +111,7 @@ template <typename SampleType> class DelayLineWithSampleAccess
 
 //============================================================================
 
-template <typename SampleType> class Allpass
+template <typename SampleType, typename StorageType = SampleType> class Allpass
 {
   public:
     Allpass();
@@ -63,14 +128,25 @@ template <typename SampleType> class Allpass
 
     void pushSample(int channel, SampleType sample);
 
-    SampleType popSample(int channel, SampleType delayInSamples = -1, bool updateReadPointer = true);
+    SampleType popSample(int channel, SampleType delayInSamples = -1);
+
+    // push/pop a whole block in place; each sample's delay is baseDelay + modulation[sample] * modulationDepth
+    void processBlock(int channel, SampleType* samples, int numSamples, SampleType baseDelay,
+                      const SampleType* modulation, SampleType modulationDepth);
 
     void setGain(SampleType newGain);
 
   private:
-    juce::dsp::DelayLine<SampleType> delayLine{44100};
+    // read as juce::dsp::DelayLine with linear interpolation: after a push, a delay of 0 is the sample just pushed
+    SampleType readDelay(int channel) const;
 
-    int delayInSamples = 4;
+    // one sample more than the longest delay, since reads are one sample older than pushes, and one for interpolation
+    static constexpr int extraSamples = 2;
+
+    DelayLineWithSampleAccess<SampleType, StorageType> delayLine{44100 + extraSamples};
+
+    int maxDelayInSamples = 44100;
+    SampleType delayInSamples = 4;
 
     SampleType gain = 0.5;
 
@@ -81,3 +157,87 @@ template <typename SampleType> class Allpass
 
     SampleType sampleRate = 44100.0;
 };
+
+//============================================================================
+/*
+Fixed-size delay and allpass
+Capacity and channel count are compile-time constants and all state is held in std::arrays, so fixed topologies can
+be fully inlined. The capacity must be a power of two larger than the longest delay used. Delays may be fractional
+(linear interpolation) and are measured as in juce::dsp::DelayLine, so these are drop-in replacements for its
+pop-then-push allpass pattern.
+*/
+
+template <int N, int Channels, typename SampleType = float> class FixedDelay
+{
+  public:
+    static_assert(N >= 4 && (N & (N - 1)) == 0, "FixedDelay capacity must be a power of two");
+    static_assert(Channels > 0, "FixedDelay needs at least one channel");
+
+    void setDelay(SampleType newDelayInSamples)
+    {
+        auto delay = std::clamp<SampleType>(newDelayInSamples, 0, static_cast<SampleType>(N - 2));
+        delayInt = static_cast<int>(delay);
+        delayFrac = delay - static_cast<SampleType>(delayInt);
+    }
+
+    void reset()
+    {
+        for (auto& channelBuffer : buffer)
+            channelBuffer.fill(0);
+        writePosition.fill(0);
+    }
+
+    // read before writing the current sample
+    SampleType read(int channel) const
+    {
+        const auto& channelBuffer = buffer[channel];
+        auto value1 = channelBuffer[(writePosition[channel] - delayInt) & mask];
+        auto value2 = channelBuffer[(writePosition[channel] - delayInt - 1) & mask];
+        return value1 + delayFrac * (value2 - value1);
+    }
+
+    void write(int channel, SampleType newValue)
+    {
+        buffer[channel][writePosition[channel]] = newValue;
+        writePosition[channel] = (writePosition[channel] + 1) & mask;
+    }
+
+  private:
+    static constexpr int mask = N - 1;
+
+    std::array<std::array<SampleType, N>, Channels> buffer{};
+    std::array<int, Channels> writePosition{};
+    int delayInt = 0;
+    SampleType delayFrac = 0;
+};
+
+template <int N, int Channels, typename SampleType = float> class FixedAllpass
+{
+  public:
+    void setDelay(SampleType newDelayInSamples)
+    {
+        delay.setDelay(newDelayInSamples);
+    }
+
+    void setGain(SampleType newGain)
+    {
+        gain = std::clamp<SampleType>(newGain, 0, 1);
+    }
+
+    void reset()
+    {
+        delay.reset();
+    }
+
+    // same feedback/feedforward arrangement as Allpass
+    SampleType processSample(int channel, SampleType input)
+    {
+        auto delayOutput = delay.read(channel);
+        delay.write(channel, input + delayOutput * gain);
+        return delayOutput - input - delayOutput * gain;
+    }
+
+  private:
+    FixedDelay<N, Channels, SampleType> delay;
+    SampleType gain = 0.5;
+};
@@ -8,6 +8,8 @@ DattorroPlate::~DattorroPlate() = default;
 
 void DattorroPlate::prepare(const juce::dsp::ProcessSpec& spec)
 {
+    sampleRate = spec.sampleRate;
+
     // prepare mono processors
     juce::dsp::ProcessSpec monoSpec;
     monoSpec.sampleRate = spec.sampleRate;
@@ -15,10 +17,10 @@ void DattorroPlate::prepare(const juce::dsp::ProcessSpec& spec)
     monoSpec.numChannels = 1;
 
     // prepare allpassses
-    allpass1.prepare(monoSpec);
-    allpass2.prepare(monoSpec);
-    allpass3.prepare(monoSpec);
-    allpass4.prepare(monoSpec);
+    allpass1.reset();
+    allpass2.reset();
+    allpass3.reset();
+    allpass4.reset();
     allpass5.prepare(monoSpec);
     allpass6.prepare(monoSpec);
 
@@ -43,13 +45,17 @@ void DattorroPlate::prepare(const juce::dsp::ProcessSpec& spec)
     lfoParameters.waveform = generatorWaveform::sin;
     lfo.setParameters(lfoParameters);
     lfo.reset(spec.sampleRate);
+    modulationFade.prepare(spec.sampleRate);
+
+    renderingFoa = spec.numChannels == FoaTapEncoder::numChannels;
+    if (renderingFoa)
+        foaEncoder.prepare(numOutputTaps);
+
     reset();
 }
 
 void DattorroPlate::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
-    juce::ScopedNoDenormals noDenormals;
-
     int numSamples = buffer.getNumSamples();
     //    int numChannels = buffer.getNumChannels();
 
@@ -58,26 +64,33 @@ void DattorroPlate::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuf
     lfoParameters.frequency_Hz = parameters.modRate;
     lfo.setParameters(lfoParameters);
 
-    // initialize input chain parameters
+    // quality tier
+    modulationFade.setOn(qualityTier < 1);
+    modulationFade.advance(numSamples);
+
+    // initialize input chain parameters; lengths are in samples at the host rate
     //    preDelay.setDelay(parameters.preDelay);
     inputFilter.setCutoffFrequency(13500);
-    allpass1.setDelay(210 * parameters.roomSize);
-    allpass2.setDelay(158 * parameters.roomSize);
-    allpass3.setDelay(561 * parameters.roomSize);
-    allpass4.setDelay(410 * parameters.roomSize);
-    allpass5.setDelay(3931 * parameters.roomSize);
-    allpass6.setDelay(2664 * parameters.roomSize);
+    allpass1.setDelay(scaleDelay(210 * parameters.roomSize));
+    allpass2.setDelay(scaleDelay(158 * parameters.roomSize));
+    allpass3.setDelay(scaleDelay(561 * parameters.roomSize));
+    allpass4.setDelay(scaleDelay(410 * parameters.roomSize));
+    allpass5.setDelay(scaleDelay(3931 * parameters.roomSize));
+    allpass6.setDelay(scaleDelay(2664 * parameters.roomSize));
 
     // break out parameters so mod can add/subtract 12 samples
-    float modAPF1Delay = 1343 * parameters.roomSize;
-    float modAPF2Delay = 995 * parameters.roomSize;
+    float modAPF1Delay = scaleDelay(1343 * parameters.roomSize);
+    float modAPF2Delay = scaleDelay(995 * parameters.roomSize);
     modulatedAPF1.setDelay(modAPF1Delay);
     modulatedAPF2.setDelay(modAPF2Delay);
 
-    delay1.setDelay(6241 * parameters.roomSize);
-    delay2.setDelay(6590 * parameters.roomSize);
-    delay3.setDelay(4641 * parameters.roomSize);
-    delay4.setDelay(5505 * parameters.roomSize);
+    delay1.setDelay(scaleDelay(6241 * parameters.roomSize));
+    delay2.setDelay(scaleDelay(6590 * parameters.roomSize));
+    delay3.setDelay(scaleDelay(4641 * parameters.roomSize));
+    delay4.setDelay(scaleDelay(5505 * parameters.roomSize));
+
+    // the output taps read between samples anyway, so they're just scaled
+    float tapScale = parameters.roomSize * delayScale;
 
     // mono reverb processing
     juce::AudioBuffer<float> monoBufferA(1, buffer.getNumSamples());
@@ -101,13 +114,23 @@ void DattorroPlate::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuf
     float decayDiffusion2 = 0.67;
     float inputDiffusion1 = 1;
     float inputDiffusion2 = 0.83;
+
+    allpass1.setGain(inputDiffusion1 * parameters.diffusion);
+    allpass2.setGain(inputDiffusion1 * parameters.diffusion);
+    allpass3.setGain(inputDiffusion2 * parameters.diffusion);
+    allpass4.setGain(inputDiffusion2 * parameters.diffusion);
     auto* channelDataA = monoBufferA.getWritePointer(channel);
     auto* channelDataB = monoBufferB.getWritePointer(channel);
 
+    // the input's already summed into the tank, so the taps can be added straight into the buffer
+    float* const* foaOutput = buffer.getArrayOfWritePointers();
+    if (renderingFoa)
+        buffer.clear();
+
     for (int sample = 0; sample < numSamples; ++sample)
     {
         // LFO
-        lfoOutput = lfo.renderAudioOutput();
+        lfoOutput = renderModulation(lfo, modulationFade, sample, numSamples);
 
         // apply filter
         //        preDelay.pushSample(channel, channelDataA[sample]);
@@ -115,36 +138,17 @@ void DattorroPlate::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuf
         channelDataA[sample] = inputFilter.processSample(channel, channelDataA[sample]);
 
         // apply allpasses
-        allpassOutput = allpass1.popSample(channel);
-        feedback = allpassOutput * inputDiffusion1 * parameters.diffusion;
-        feedforward = -channelDataA[sample] - allpassOutput * inputDiffusion1 * parameters.diffusion;
-        allpass1.pushSample(channel, channelDataA[sample] + feedback);
-        channelDataA[sample] = allpassOutput + feedforward;
-
-        allpassOutput = allpass2.popSample(channel);
-        feedback = allpassOutput * inputDiffusion1 * parameters.diffusion;
-        feedforward = -channelDataA[sample] - allpassOutput * inputDiffusion1 * parameters.diffusion;
-        allpass2.pushSample(channel, channelDataA[sample] + feedback);
-        channelDataA[sample] = allpassOutput + feedforward;
-
-        allpassOutput = allpass3.popSample(channel);
-        feedback = allpassOutput * inputDiffusion2 * parameters.diffusion;
-        feedforward = -channelDataA[sample] - allpassOutput * inputDiffusion2 * parameters.diffusion;
-        allpass3.pushSample(channel, channelDataA[sample] + feedback);
-        channelDataA[sample] = allpassOutput + feedforward;
-
-        allpassOutput = allpass4.popSample(channel);
-        feedback = allpassOutput * inputDiffusion2 * parameters.diffusion;
-        feedforward = -channelDataA[sample] - allpassOutput * inputDiffusion2 * parameters.diffusion;
-        allpass4.pushSample(channel, channelDataA[sample] + feedback);
-        channelDataA[sample] = allpassOutput + feedforward;
+        channelDataA[sample] = allpass1.processSample(channel, channelDataA[sample]);
+        channelDataA[sample] = allpass2.processSample(channel, channelDataA[sample]);
+        channelDataA[sample] = allpass3.processSample(channel, channelDataA[sample]);
+        channelDataA[sample] = allpass4.processSample(channel, channelDataA[sample]);
 
         // first fig-8 half
         channelDataA[sample] += summingB * parameters.decayTime;
 
         // modulated APF1
         allpassOutput = modulatedAPF1.popSample(
-            channel, modAPF1Delay + (lfoOutput.normalOutput * 24.0f * parameters.modDepth)); // modulate
+            channel, modAPF1Delay + (lfoOutput.normalOutput * 24.0f * delayScale * parameters.modDepth));
         feedback = allpassOutput * decayDiffusion1 * parameters.diffusion;
         feedforward = -channelDataA[sample] - allpassOutput * decayDiffusion1 * parameters.diffusion;
         modulatedAPF1.pushSample(channel, channelDataA[sample] + feedback);
@@ -157,10 +161,10 @@ void DattorroPlate::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuf
 
         // OUTPUT NODE A
         // L
-        channel0Output = delay1.getSampleAtDelay(channel, 394 * parameters.roomSize) * 0.6;
-        channel0Output += delay1.getSampleAtDelay(channel, 4401 * parameters.roomSize) * 0.6;
+        outputTaps[0] = delay1.getSampleAtDelay(channel, 394 * tapScale, DelayInterpolation::linear) * 0.6;
+        outputTaps[1] = delay1.getSampleAtDelay(channel, 4401 * tapScale, DelayInterpolation::linear) * 0.6;
         // R
-        channel1Output = -delay1.getSampleAtDelay(channel, 3124 * parameters.roomSize) * 0.6;
+        outputTaps[7] = -delay1.getSampleAtDelay(channel, 3124 * tapScale, DelayInterpolation::linear) * 0.6;
 
         // allpass 5
         allpassOutput = allpass5.popSample(channel);
@@ -171,9 +175,11 @@ void DattorroPlate::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuf
 
         // OUTPUT NODE B
         // L
-        channel0Output -= allpass5.getSampleAtDelay(channel, 2831 * parameters.roomSize) * 0.6;
+        outputTaps[2] =
+            -allpass5.getSampleAtDelay(channel, 2831 * tapScale, DelayInterpolation::linear) * 0.6;
         // R
-        channel1Output -= allpass5.getSampleAtDelay(channel, 496 * parameters.roomSize) * 0.6;
+        outputTaps[8] =
+            -allpass5.getSampleAtDelay(channel, 496 * tapScale, DelayInterpolation::linear) * 0.6;
 
         // delay 2
         delay2.pushSample(channel, channelDataA[sample]);
@@ -181,9 +187,9 @@ void DattorroPlate::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuf
 
         // OUTPUT NODE C
         // L
-        channel0Output += delay2.getSampleAtDelay(channel, 2954 * parameters.roomSize) * 0.6;
+        outputTaps[3] = delay2.getSampleAtDelay(channel, 2954 * tapScale, DelayInterpolation::linear) * 0.6;
         // R
-        channel1Output -= delay2.getSampleAtDelay(channel, 179 * parameters.roomSize) * 0.6;
+        outputTaps[9] = -delay2.getSampleAtDelay(channel, 179 * tapScale, DelayInterpolation::linear) * 0.6;
 
         summingA = channelDataA[sample];
 
@@ -192,7 +198,7 @@ void DattorroPlate::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuf
 
         // modulated APF2
         allpassOutput = modulatedAPF2.popSample(
-            channel, modAPF2Delay + (lfoOutput.quadPhaseOutput_pos * 24.0f * parameters.modDepth)); // modulate
+            channel, modAPF2Delay + (lfoOutput.quadPhaseOutput_pos * 24.0f * delayScale * parameters.modDepth));
         feedback = allpassOutput * decayDiffusion2 * parameters.diffusion;
         feedforward = -channelDataB[sample] - allpassOutput * decayDiffusion2 * parameters.diffusion;
         modulatedAPF2.pushSample(channel, channelDataB[sample] + feedback);
@@ -205,10 +211,10 @@ void DattorroPlate::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuf
 
         // OUTPUT NODE D
         // L
-        channel0Output -= delay3.getSampleAtDelay(channel, 2945 * parameters.roomSize) * 0.6;
+        outputTaps[4] = -delay3.getSampleAtDelay(channel, 2945 * tapScale, DelayInterpolation::linear) * 0.6;
         // R
-        channel1Output += delay3.getSampleAtDelay(channel, 522 * parameters.roomSize) * 0.6;
-        channel1Output += delay3.getSampleAtDelay(channel, 5368 * parameters.roomSize) * 0.6;
+        outputTaps[10] = delay3.getSampleAtDelay(channel, 522 * tapScale, DelayInterpolation::linear) * 0.6;
+        outputTaps[11] = delay3.getSampleAtDelay(channel, 5368 * tapScale, DelayInterpolation::linear) * 0.6;
 
         // allpass 6
         allpassOutput = allpass6.popSample(channel);
@@ -219,9 +225,11 @@ void DattorroPlate::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuf
 
         // OUTPUT NODE E
         // L
-        channel0Output -= allpass6.getSampleAtDelay(channel, 277 * parameters.roomSize) * 0.6;
+        outputTaps[5] =
+            -allpass6.getSampleAtDelay(channel, 277 * tapScale, DelayInterpolation::linear) * 0.6;
         // R
-        channel1Output -= allpass6.getSampleAtDelay(channel, 1817 * parameters.roomSize) * 0.6;
+        outputTaps[12] =
+            -allpass6.getSampleAtDelay(channel, 1817 * tapScale, DelayInterpolation::linear) * 0.6;
 
         // delay 4
         delay4.pushSample(channel, channelDataB[sample]);
@@ -231,9 +239,25 @@ void DattorroPlate::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuf
 
         // OUTPUT NODE F
         // L
-        channel0Output -= delay4.getSampleAtDelay(channel, 1578 * parameters.roomSize) * 0.6;
+        outputTaps[6] = -delay4.getSampleAtDelay(channel, 1578 * tapScale, DelayInterpolation::linear) * 0.6;
         // R
-        channel1Output += delay4.getSampleAtDelay(channel, 3956 * parameters.roomSize) * 0.6;
+        outputTaps[13] = delay4.getSampleAtDelay(channel, 3956 * tapScale, DelayInterpolation::linear) * 0.6;
+
+        if (renderingFoa)
+        {
+            for (int tap = 0; tap < numOutputTaps; ++tap)
+                foaEncoder.addTap(tap, static_cast<float>(outputTaps[static_cast<size_t>(tap)]), foaOutput, sample);
+            continue;
+        }
+
+        // summed in the order they were read
+        channel0Output = static_cast<float>(outputTaps[0]);
+        channel1Output = static_cast<float>(outputTaps[7]);
+        for (int tap = 1; tap < numOutputTaps / 2; ++tap)
+        {
+            channel0Output += outputTaps[static_cast<size_t>(tap)];
+            channel1Output += outputTaps[static_cast<size_t>(tap + numOutputTaps / 2)];
+        }
 
         for (int destChannel = 0; destChannel < buffer.getNumChannels(); ++destChannel)
         {
@@ -251,6 +275,59 @@ void DattorroPlate::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuf
 
 void DattorroPlate::reset()
 {
+    allpass1.reset();
+    allpass2.reset();
+    allpass3.reset();
+    allpass4.reset();
+    allpass5.reset();
+    allpass6.reset();
+
+    modulatedAPF1.reset();
+    modulatedAPF2.reset();
+
+    delay1.reset();
+    delay2.reset();
+    delay3.reset();
+    delay4.reset();
+
+    inputFilter.reset();
+    dampingFilter1.reset();
+    dampingFilter2.reset();
+
+    summingA = 0;
+    summingB = 0;
+
+    modulationFade.finishFade();
+}
+
+int DattorroPlate::getNumQualityTiers()
+{
+    return 2;
+}
+
+double DattorroPlate::getTailLengthSeconds()
+{
+    // the tank is one figure-8 loop with five decay gains per trip round it. Its allpasses subtract the input from the
+    // delay output rather than the scaled input, so they peak at 2 / (1 + g) rather than 1, and the loop can run away
+    // once decayTime gets close to 1. Allpass 5, the longest in the tank, can ring on for longer than the loop when
+    // decayTime is low and diffusion high
+    double roomSize = parameters.roomSize * delayScale;
+    double inputSeconds = (210 + 158 + 561 + 410) * roomSize / sampleRate;
+    double loopSeconds = (1343 + 6241 + 3931 + 6590 + 995 + 4641 + 2664 + 5505) * roomSize / sampleRate;
+
+    double allpassPeak1 = 2.0 / (1.0 + 0.93f * parameters.diffusion);
+    double allpassPeak2 = 2.0 / (1.0 + 0.67f * parameters.diffusion);
+    double loopGain = std::pow(parameters.decayTime, 5.0f) * std::pow(allpassPeak1 * allpassPeak2, 2.0);
+
+    double loopDecay = loopDecayTime(loopGain, loopSeconds);
+    double allpassDecay = loopDecayTime(0.93f * parameters.diffusion, 3931 * roomSize / sampleRate);
+
+    return inputSeconds + loopSeconds + std::max(loopDecay, allpassDecay);
+}
+
+bool DattorroPlate::supportsFoaOutput()
+{
+    return true;
 }
 
 ReverbProcessorParameters& DattorroPlate::getParameters()
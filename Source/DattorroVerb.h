@@ -6,8 +6,10 @@
 
 // #include "DelayLineWithSampleAccess.h"
 #include "CustomDelays.h"
+#include "FoaTapEncoder.h"
 #include "LFO.h"
 #include "ProcessorBase.h"
+#include "QualityTiers.h"
 #include "Utilities.h"
 
 class DattorroPlate : public ReverbProcessorBase
@@ -27,26 +29,35 @@ class DattorroPlate : public ReverbProcessorBase
 
     void setParameters(const ReverbProcessorParameters& params) override;
 
+    double getTailLengthSeconds() override;
+
+    // the 14 output taps
+    bool supportsFoaOutput() override;
+
+    // 0: as designed; 1: unmodulated
+    int getNumQualityTiers() override;
+
   private:
     // parameter class
     ReverbProcessorParameters parameters;
 
+    // input diffusers; sized for the largest roomSize (1.75)
+    FixedAllpass<512, 1> allpass1;
+    FixedAllpass<512, 1> allpass2;
+    FixedAllpass<1024, 1> allpass3;
+    FixedAllpass<1024, 1> allpass4;
     // allpasses
-    juce::dsp::DelayLine<float> allpass1{22050};
-    juce::dsp::DelayLine<float> allpass2{22050};
-    juce::dsp::DelayLine<float> allpass3{22050};
-    juce::dsp::DelayLine<float> allpass4{22050};
-    DelayLineWithSampleAccess<float> allpass5{22050};
-    DelayLineWithSampleAccess<float> allpass6{22050};
+    DelayLineWithSampleAccess<float, ReverbDelayStorage> allpass5{22050};
+    DelayLineWithSampleAccess<float, ReverbDelayStorage> allpass6{22050};
     // modulated allpasses
     juce::dsp::DelayLine<float> modulatedAPF1{22050};
     juce::dsp::DelayLine<float> modulatedAPF2{22050};
     // delays
     //    juce::dsp::DelayLine<float> preDelay {22050};
-    DelayLineWithSampleAccess<float> delay1{22050};
-    DelayLineWithSampleAccess<float> delay2{22050};
-    DelayLineWithSampleAccess<float> delay3{22050};
-    DelayLineWithSampleAccess<float> delay4{22050};
+    DelayLineWithSampleAccess<float, ReverbDelayStorage> delay1{22050};
+    DelayLineWithSampleAccess<float, ReverbDelayStorage> delay2{22050};
+    DelayLineWithSampleAccess<float, ReverbDelayStorage> delay3{22050};
+    DelayLineWithSampleAccess<float, ReverbDelayStorage> delay4{22050};
     // lowpass filters
     juce::dsp::FirstOrderTPTFilter<float> inputFilter;
     juce::dsp::FirstOrderTPTFilter<float> dampingFilter1;
@@ -55,6 +66,7 @@ class DattorroPlate : public ReverbProcessorBase
     OscillatorParameters lfoParameters;
     SignalGenData lfoOutput;
     LFO lfo;
+    TierFade modulationFade;
 
     float allpassOutput = 0;
     float feedback = 0;
@@ -64,6 +76,15 @@ class DattorroPlate : public ReverbProcessorBase
     float channel0Output = 0;
     float channel1Output = 0;
 
+    // output taps, the left output's then the right's, in the order they're read; double, as the 0.6 tap gain is
+    static constexpr int numOutputTaps = 14;
+    std::array<double, numOutputTaps> outputTaps{};
+
+    double sampleRate = 44100.0;
+
+    bool renderingFoa = false;
+    FoaTapEncoder foaEncoder;
+
     //    float mPreDelayTime = 441;
     //    float mSize = 1;
     //    float mDecay = 0.25;
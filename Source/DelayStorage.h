@@ -0,0 +1,158 @@
+/*
+Sample storage types for delay lines
+Float16 (IEEE half) and BFloat16 halve the memory a delay line's history takes, at the cost of precision: Float16 keeps
+11 bits of mantissa down to about -84 dBFS and fewer below that, BFloat16 keeps 8 bits over float's whole range.
+Samples are converted to and from float on every write and read; with F16C the Float16 conversions are single
+instructions.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#include <immintrin.h>
+#define RSAV_HAS_F16C 1
+#else
+#define RSAV_HAS_F16C 0
+#endif
+
+struct Float16
+{
+    uint16_t bits = 0;
+};
+
+struct BFloat16
+{
+    uint16_t bits = 0;
+};
+
+// float and double are stored as they are
+template <typename StorageType> struct DelayStorage
+{
+    template <typename SampleType> static StorageType encode(SampleType value)
+    {
+        return static_cast<StorageType>(value);
+    }
+
+    static StorageType decode(StorageType value)
+    {
+        return value;
+    }
+};
+
+template <> struct DelayStorage<Float16>
+{
+    static Float16 encode(float value)
+    {
+#if RSAV_HAS_F16C
+        return {static_cast<uint16_t>(_cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT))};
+#else
+        uint32_t x;
+        std::memcpy(&x, &value, sizeof(x));
+
+        uint32_t sign = (x >> 16) & 0x8000u;
+        uint32_t magnitude = x & 0x7fffffffu;
+
+        // NaN stays NaN, and anything too large for a half becomes infinity
+        if (magnitude > 0x7f800000u)
+            return {static_cast<uint16_t>(sign | 0x7e00u)};
+        if (magnitude >= 0x477ff000u)
+            return {static_cast<uint16_t>(sign | 0x7c00u)};
+
+        // below the smallest normal half, shift into a subnormal, rounding to nearest even
+        if (magnitude < 0x38800000u)
+        {
+            if (magnitude < 0x33000000u)
+                return {static_cast<uint16_t>(sign)};
+
+            uint32_t mantissa = (magnitude & 0x007fffffu) | 0x00800000u;
+            int shift = 126 - static_cast<int>(magnitude >> 23);
+            uint32_t half = mantissa >> shift;
+            uint32_t remainder = mantissa & ((1u << shift) - 1u);
+            uint32_t halfway = 1u << (shift - 1);
+            if (remainder > halfway || (remainder == halfway && (half & 1u)))
+                ++half;
+            return {static_cast<uint16_t>(sign | half)};
+        }
+
+        // rebias the exponent and round the mantissa to 10 bits, to nearest even; a carry rolls into the exponent
+        uint32_t rounded = magnitude - 0x38000000u + 0x0fffu + ((magnitude >> 13) & 1u);
+        return {static_cast<uint16_t>(sign | (rounded >> 13))};
+#endif
+    }
+
+    static float decode(Float16 value)
+    {
+#if RSAV_HAS_F16C
+        return _cvtsh_ss(value.bits);
+#else
+        uint32_t sign = static_cast<uint32_t>(value.bits & 0x8000u) << 16;
+        uint32_t exponent = (value.bits >> 10) & 0x1fu;
+        uint32_t mantissa = value.bits & 0x03ffu;
+        uint32_t x;
+
+        if (exponent == 0x1fu)
+        {
+            x = sign | 0x7f800000u | (mantissa << 13);
+        }
+        else if (exponent != 0)
+        {
+            x = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+        }
+        else if (mantissa != 0)
+        {
+            // subnormal half; normalise it for float
+            exponent = 113;
+            while ((mantissa & 0x0400u) == 0)
+            {
+                mantissa <<= 1;
+                --exponent;
+            }
+            x = sign | (exponent << 23) | ((mantissa & 0x03ffu) << 13);
+        }
+        else
+        {
+            x = sign;
+        }
+
+        float result;
+        std::memcpy(&result, &x, sizeof(result));
+        return result;
+#endif
+    }
+};
+
+template <> struct DelayStorage<BFloat16>
+{
+    // the upper half of the float, rounded to nearest even
+    static BFloat16 encode(float value)
+    {
+        uint32_t x;
+        std::memcpy(&x, &value, sizeof(x));
+
+        if ((x & 0x7fffffffu) > 0x7f800000u)
+            return {static_cast<uint16_t>((x >> 16) | 0x0040u)};
+
+        x += 0x7fffu + ((x >> 16) & 1u);
+        return {static_cast<uint16_t>(x >> 16)};
+    }
+
+    static float decode(BFloat16 value)
+    {
+        uint32_t x = static_cast<uint32_t>(value.bits) << 16;
+        float result;
+        std::memcpy(&result, &x, sizeof(result));
+        return result;
+    }
+};
+
+// storage for the long reverb delays; build with RSAV_DELAY_STORAGE=1 for Float16 or 2 for BFloat16
+#if RSAV_DELAY_STORAGE == 1
+using ReverbDelayStorage = Float16;
+#elif RSAV_DELAY_STORAGE == 2
+using ReverbDelayStorage = BFloat16;
+#else
+using ReverbDelayStorage = float;
+#endif
@@ -0,0 +1,90 @@
+// Keeping the reverbs' feedback state out of the subnormal range, and counting where it gets close anyway
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#ifndef RSAV_DENORMAL_NOISE
+#define RSAV_DENORMAL_NOISE 0
+#endif
+
+/*
+Tails decaying through the subnormal range are slow on most CPUs, as every operation on a subnormal float takes a
+microcode path. The plugin turns on flush-to-zero and denormals-are-zero once per callback, in processBlock, and each
+thread that runs part of the reverb (channel workers, the late reverb pipeline, impulse response captures) does the same
+for itself; the algorithms don't repeat it. Build with RSAV_DENORMAL_NOISE=1 to also add a signal far below anything
+audible to the reverb's input, for hosts or CPUs where flush-to-zero isn't in effect: every feedback loop is fed by the
+input, so none of them decays below it.
+
+Under flush-to-zero nothing subnormal is left to count, so the telemetry counts samples within nearSubnormalLimit of
+zero instead: a tail that quiet reaches the subnormal range a few passes round its loops later wherever flush-to-zero
+isn't in effect. The tail benchmark turns flush-to-zero off, and counts the subnormals themselves.
+*/
+
+// true for a nonzero float with a zero exponent; read from the bits, as comparisons see these as 0 under
+// denormals-are-zero
+inline bool isSubnormal(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x7f800000u) == 0 && (bits & 0x007fffffu) != 0;
+}
+
+inline int countSubnormals(const juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    int count = 0;
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        auto* data = buffer.getReadPointer(channel);
+        for (int sample = 0; sample < numSamples; ++sample)
+            count += isSubnormal(data[sample]) ? 1 : 0;
+    }
+    return count;
+}
+
+// 2^10 times the smallest normal float, about -700 dB; nothing audible gets near it, so a stage whose output does is
+// leaving state to decay into the subnormal range
+constexpr float nearSubnormalLimit = std::numeric_limits<float>::min() * 1024.0f;
+
+// true for a nonzero float of magnitude below nearSubnormalLimit, subnormals included; read from the bits like
+// isSubnormal, so the count is the same whether denormals-are-zero is on or not
+inline bool isNearSubnormal(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    bits &= 0x7fffffffu;
+    return bits != 0 && bits < 0x05800000u;
+}
+
+inline int countNearSubnormals(const juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    int count = 0;
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        auto* data = buffer.getReadPointer(channel);
+        for (int sample = 0; sample < numSamples; ++sample)
+            count += isNearSubnormal(data[sample]) ? 1 : 0;
+    }
+    return count;
+}
+
+// -400 dB; too small to change any sample above about -255 dB when added, and still far above the subnormal range after
+// the loops' filters have taken some of it off
+constexpr float denormalNoiseLevel = 1.0e-20f;
+
+// adds the noise when built with RSAV_DENORMAL_NOISE=1, and does nothing otherwise
+inline void addDenormalNoise(juce::AudioBuffer<float>& buffer, int numSamples)
+{
+#if RSAV_DENORMAL_NOISE
+    // a square wave at a quarter of the sample rate; the DC blockers in the loops would remove a constant, and the
+    // damping lowpasses, with their zero at Nyquist, a signal alternating every sample
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        auto* data = buffer.getWritePointer(channel);
+        for (int sample = 0; sample < numSamples; ++sample)
+            data[sample] += (sample & 2) != 0 ? -denormalNoiseLevel : denormalNoiseLevel;
+    }
+#else
+    juce::ignoreUnused(buffer, numSamples);
+#endif
+}
@@ -8,12 +8,17 @@ EarlyReflections::~EarlyReflections() = default;
 
 void EarlyReflections::prepare(const juce::dsp::ProcessSpec& spec)
 {
+    sampleRate = spec.sampleRate;
+
     juce::dsp::ProcessSpec monoSpec;
     monoSpec.sampleRate = spec.sampleRate;
     monoSpec.maximumBlockSize = spec.maximumBlockSize;
     monoSpec.numChannels = 1;
 
-    earlyReflectionsDelayLine.prepare(monoSpec);
+    // standalone, the taps read the buffer's own recent input
+    if (sharedHistory == nullptr)
+        ownHistory.prepare(static_cast<int>(spec.numChannels), getMaximumTapDelay(),
+                           static_cast<int>(spec.maximumBlockSize));
 
     // leftHRTFDelay.prepare(monoSpec);
     // rightHRTFDelay.prepare(monoSpec);
@@ -37,19 +42,13 @@ void EarlyReflections::prepare(const juce::dsp::ProcessSpec& spec)
 
 void EarlyReflections::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
-    juce::ScopedNoDenormals noDenormals;
     int numSamples = buffer.getNumSamples();
     int numChannels = buffer.getNumChannels();
 
-    juce::AudioBuffer<float> monoBuffer(1, numSamples);
-    monoBuffer.clear();
-
-    monoBuffer.copyFrom(0, 0, buffer, 0, 0, numSamples);
-    if (numChannels > 1)
-    {
-        monoBuffer.addFrom(0, 0, buffer, 1, 0, numSamples);
-        monoBuffer.applyGain(0.5f);
-    }
+    // with a shared history, the caller has already pushed this block's input into it
+    if (sharedHistory == nullptr)
+        ownHistory.push(buffer, numSamples);
+    const auto& history = sharedHistory != nullptr ? *sharedHistory : ownHistory;
 
     // leftHRTFDelay.setDelay(35);
     // rightHRTFDelay.setDelay(35);
@@ -57,20 +56,24 @@ void EarlyReflections::processBlock(juce::AudioBuffer<float>& buffer, juce::Midi
     for (auto& delay : hrtfDelays)
         delay.setDelay(35);
 
-    auto* channelData = monoBuffer.getWritePointer(0);
     for (int sample = 0; sample < numSamples; ++sample)
     {
-        earlyReflectionsDelayLine.pushSample(0, channelData[sample]);
-
         for (int channel = 0; channel < numChannels; ++channel)
         {
             for (int delTime = 0; delTime < hrtfDelayTimes.size(); ++delTime)
             {
                 // sum 3 left/ 3 right taps (interleaved w/ each other)
-                // channel % 2 because could be many channels, but only 2 lists of delay times
-                channelOutputs[channel] = earlyReflectionsDelayLine.getSampleAtDelay(
-                                              0, hrtfDelayTimes[channel % 2][delTime] * parameters.roomSize) *
-                                          initialLevel * pow(parameters.decayTime, delTime);
+                // channel % 2 because could be many channels, but only 2 lists of delay times. Each tap is a sample
+                // short of its listed delay, as it was read from the tapped delay line these used to have
+                int tapDelay =
+                    preDelayWhole + static_cast<int>(hrtfDelayTimes[channel % 2][delTime] * parameters.roomSize) - 1;
+
+                // taps are of the mono mix of the first two channels
+                float tap = history.getSample(0, sample, tapDelay, preDelayFraction);
+                if (numChannels > 1)
+                    tap = (tap + history.getSample(1, sample, tapDelay, preDelayFraction)) * 0.5f;
+
+                channelOutputs[channel] = tap * initialLevel * pow(parameters.decayTime, delTime);
             }
         }
 
@@ -130,7 +133,9 @@ void EarlyReflections::processBlock(juce::AudioBuffer<float>& buffer, juce::Midi
 
 void EarlyReflections::reset()
 {
-    earlyReflectionsDelayLine.reset();
+    // a shared history is the caller's to reset
+    if (sharedHistory == nullptr)
+        ownHistory.reset();
 
     for (auto& delay : hrtfDelays)
         delay.reset();
@@ -153,11 +158,46 @@ void EarlyReflections::setParameters(const ReverbProcessorParameters& params)
     if (!(params == parameters))
     {
         parameters = params;
-        parameters.roomSize = scale(parameters.roomSize, 0.0f, 1.0f, 0.25f, 1.75f);
+        parameters.roomSize = scale(parameters.roomSize, 0.0f, 1.0f, minimumRoomSize, maximumRoomSize);
     }
 }
 
+double EarlyReflections::getTailLengthSeconds()
+{
+    // no feedback, so the tail ends with the latest tap and the cross-channel HRTF delay after it
+    int latestTap = 0;
+    for (const auto& channelDelayTimes : hrtfDelayTimes)
+        latestTap = std::max(latestTap, *std::max_element(channelDelayTimes.begin(), channelDelayTimes.end()));
+
+    return (latestTap * parameters.roomSize + 35) / sampleRate;
+}
+
 void EarlyReflections::setMonoFlag(const bool newMonoFlag)
 {
     monoFlag = newMonoFlag;
 }
+
+void EarlyReflections::setInputHistory(const InputHistory* newHistory)
+{
+    sharedHistory = newHistory;
+    preDelayWhole = 0;
+    preDelayFraction = 0;
+}
+
+void EarlyReflections::setPreDelay(float newPreDelaySamples)
+{
+    jassert(sharedHistory != nullptr);
+
+    // split as InputHistory::read() splits it, so every tap lines up with the pre-delayed signal
+    preDelayWhole = static_cast<int>(std::floor(newPreDelaySamples));
+    preDelayFraction = newPreDelaySamples - static_cast<float>(preDelayWhole);
+}
+
+int EarlyReflections::getMaximumTapDelay() const
+{
+    int latestTap = 0;
+    for (const auto& channelDelayTimes : hrtfDelayTimes)
+        latestTap = std::max(latestTap, *std::max_element(channelDelayTimes.begin(), channelDelayTimes.end()));
+
+    return static_cast<int>(latestTap * maximumRoomSize);
+}
@@ -1,7 +1,6 @@
 // FIR-based early reflections with 6 taps and HRTF for binaural stereo. Based on Dattorro
 /*
  TODO:
- - implement predelay
  - diffusion?
 */
 
@@ -10,7 +9,7 @@
 #include <JuceHeader.h>
 
 // #include "DelayLineWithSampleAccess.h"
-#include "CustomDelays.h"
+#include "InputHistory.h"
 #include "ProcessorBase.h"
 #include "Utilities.h"
 
@@ -31,12 +30,32 @@ class EarlyReflections : public ReverbProcessorBase
 
     void setParameters(const ReverbProcessorParameters& params) override;
 
+    double getTailLengthSeconds() override;
+
     void setMonoFlag(const bool newMonoFlag);
 
+    // taps read history, which the caller pushes each block into, rather than the buffer; before prepare(). Null goes
+    // back to the buffer, through a history of its own
+    void setInputHistory(const InputHistory* newHistory);
+
+    // added to every tap; only read from a history set with setInputHistory()
+    void setPreDelay(float newPreDelaySamples);
+
+    // the latest tap at the largest room size; with the pre-delay, how far back a shared history has to reach
+    int getMaximumTapDelay() const;
+
   private:
+    static constexpr float minimumRoomSize = 0.25f;
+    static constexpr float maximumRoomSize = 1.75f;
+
     ReverbProcessorParameters parameters;
 
-    DelayLineWithSampleAccess<float> earlyReflectionsDelayLine{22050};
+    // the caller's history, or ownHistory without one
+    const InputHistory* sharedHistory = nullptr;
+    InputHistory ownHistory;
+    int preDelayWhole = 0;
+    float preDelayFraction = 0;
+
     std::vector<juce::dsp::DelayLine<float>> hrtfDelays;
     std::vector<juce::dsp::FirstOrderTPTFilter<float>> hrtfFilters;
     // juce::dsp::DelayLine<float> leftHRTFDelay {441};
@@ -55,6 +74,8 @@ class EarlyReflections : public ReverbProcessorBase
     // early reflections mono/stereo - prevents comb filtering on reverbs that mix input to mono; PluginProcessor sets
     // mono/stereo by processor
     bool monoFlag = false;
+
+    double sampleRate = 44100.0;
 };
 
 ////==============================================================================
@@ -2,6 +2,7 @@
 
 #include "FDNs.h"
 #include <cstddef>
+#include <numeric>
 
 GeneralizedFDN::GeneralizedFDN() = default;
 
@@ -46,6 +47,7 @@ GeneralizedFDN::GeneralizedFDN(int order, std::string type)
 
         inDelays = {0, 1};
         modDelays = {3, 7};
+        lowTierDelays = {0, 1, 6, 7};
 
         feedbackScalar = 1.0f;
         break;
@@ -64,6 +66,7 @@ GeneralizedFDN::GeneralizedFDN(int order, std::string type)
 
         inDelays = {0, 1};
         modDelays = {3, 7};
+        lowTierDelays = {0, 1, 6, 7};
 
         feedbackScalar = 1.0f;
         break;
@@ -82,6 +85,7 @@ GeneralizedFDN::GeneralizedFDN(int order, std::string type)
 
         inDelays = {0, 1};
         modDelays = {3, 7};
+        lowTierDelays = {0, 1, 6, 7};
 
         feedbackScalar = 1.0f;
         break;
@@ -96,10 +100,22 @@ GeneralizedFDN::~GeneralizedFDN() = default;
 
 void GeneralizedFDN::prepare(const juce::dsp::ProcessSpec& spec)
 {
+    sampleRate = spec.sampleRate;
+
+    // one network per channel; for FOA, one per channel of the stereo input
+    renderingFoa = spec.numChannels == FoaTapEncoder::numChannels;
+    juce::dsp::ProcessSpec networkSpec = spec;
+    if (renderingFoa)
+    {
+        networkSpec.numChannels = 2;
+        networkInput.setSize(2, static_cast<int>(spec.maximumBlockSize));
+        foaEncoder.prepare(2 * delayCount);
+    }
+
     // initialize feedback/delay matrices to size channels x delays
-    feedbackSigMatrix.resize(spec.numChannels);
-    delayOutputMatrix.resize(spec.numChannels);
-    for (int ch = 0; ch < spec.numChannels; ++ch)
+    feedbackSigMatrix.resize(networkSpec.numChannels);
+    delayOutputMatrix.resize(networkSpec.numChannels);
+    for (int ch = 0; ch < networkSpec.numChannels; ++ch)
     {
         feedbackSigMatrix[ch].resize(delayCount);
         delayOutputMatrix[ch].resize(delayCount);
@@ -107,39 +123,63 @@ void GeneralizedFDN::prepare(const juce::dsp::ProcessSpec& spec)
         std::fill(delayOutputMatrix[ch].begin(), delayOutputMatrix[ch].end(), 0.0f);
     }
 
-    // resize/prepare delays
-    delays.resize(delayCount);
-    for (auto& del : delays)
+    // resize/prepare delays and filters, mono for each channel
+    juce::dsp::ProcessSpec monoSpec = networkSpec;
+    monoSpec.numChannels = 1;
+
+    delays.resize(networkSpec.numChannels);
+    for (auto& channelDelays : delays)
     {
-        del.prepare(spec);
-        del.setMaximumDelayInSamples(22050);
+        channelDelays.resize(delayCount);
+        for (auto& del : channelDelays)
+        {
+            del.prepare(monoSpec);
+            del.setMaximumDelayInSamples(22050);
+        }
     }
 
-    // resize/prepare filters
-    dampingFilters.resize(delayCount);
-    for (auto& filt : dampingFilters)
-        filt.prepare(spec);
+    dampingFilters.resize(networkSpec.numChannels);
+    for (auto& channelFilters : dampingFilters)
+    {
+        channelFilters.resize(delayCount);
+        for (auto& filt : channelFilters)
+            filt.prepare(monoSpec);
+    }
 
     // prepare lfo
     lfoParameters.frequency_Hz = 0.25;
     lfoParameters.waveform = generatorWaveform::sin;
-    lfo.resize(spec.numChannels);
+    lfo.resize(networkSpec.numChannels);
     for (auto& osc : lfo)
     {
         osc.setParameters(lfoParameters);
         osc.reset(spec.sampleRate);
     }
 
+    isLowTierDelay.assign(delayCount, false);
+    for (auto del : lowTierDelays)
+        isLowTierDelay[del] = true;
+
+    modulationFade.prepare(spec.sampleRate);
+    fullNetworkFade.prepare(spec.sampleRate);
+
     reset();
 }
 
 void GeneralizedFDN::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
-    juce::ScopedNoDenormals noDenormals;
-
     int numSamples = buffer.getNumSamples();
     int numChannels = buffer.getNumChannels();
 
+    float* const* foaOutput = buffer.getArrayOfWritePointers();
+    if (renderingFoa)
+    {
+        numChannels = 2;
+        for (int channel = 0; channel < numChannels; ++channel)
+            networkInput.copyFrom(channel, 0, buffer, channel, 0, numSamples);
+        buffer.clear();
+    }
+
     // set LFO rate
     for (auto& osc : lfo)
     {
@@ -148,62 +188,113 @@ void GeneralizedFDN::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBu
         osc.setParameters(lfoParameters);
     }
 
-    // set delay times
-    for (size_t i = 0; i < delayCount; ++i)
-        delays[i].setDelay(delayTimes[i] * parameters.roomSize);
+    // set delay times, from their lengths in samples at the host rate
+    for (auto& channelDelays : delays)
+        for (size_t i = 0; i < delayCount; ++i)
+            channelDelays[i].setDelay(scaleDelay(delayTimes[i] * parameters.roomSize));
 
     // set damping
-    for (auto& filt : dampingFilters)
-        filt.setCutoffFrequency(parameters.damping);
+    for (auto& channelFilters : dampingFilters)
+        for (auto& filt : channelFilters)
+            filt.setCutoffFrequency(parameters.damping);
 
-    for (int channel = 0; channel < numChannels; ++channel)
+    // quality tier; delays coming back into the network start empty
+    modulationFade.setOn(qualityTier < 1);
+    if (fullNetworkFade.setOn(qualityTier < 2))
     {
+        for (size_t channel = 0; channel < delays.size(); ++channel)
+        {
+            for (int del = 0; del < delayCount; ++del)
+            {
+                if (isLowTierDelay[del])
+                    continue;
+
+                delays[channel][del].reset();
+                dampingFilters[channel][del].reset();
+                delayOutputMatrix[channel][del] = 0.0f;
+            }
+        }
+    }
+    modulationFade.advance(numSamples);
+    fullNetworkFade.advance(numSamples);
+
+    // the other delays are only run while they fade out
+    bool runAllDelays = fullNetworkFade.isActive();
+
+    auto processChannel = [&](int channel) {
         auto* channelData = buffer.getWritePointer(channel);
+        const float* inputData = renderingFoa ? networkInput.getReadPointer(channel) : channelData;
 
         for (int sample = 0; sample < numSamples; ++sample)
         {
-            lfoOutput = lfo[channel].renderAudioOutput();
+            SignalGenData lfoOutput = renderModulation(lfo[channel], modulationFade, sample, numSamples);
 
             // reset channel feedback matrix to zeroes for next feedback
             std::fill(feedbackSigMatrix[channel].begin(), feedbackSigMatrix[channel].end(), 0.0f);
 
             // channel feedback matrix multiplication
-            for (int delIn = 0; delIn < delayCount; ++delIn)
+            if (runAllDelays)
             {
-                for (int delOut = 0; delOut < delayCount; ++delOut)
+                for (int delIn = 0; delIn < delayCount; ++delIn)
                 {
-                    // delIn = row; delOut = column
-                    // can += all because feedbackSigMatrix starts with all zeroes
-                    feedbackSigMatrix[channel][delIn] +=
-                        delayOutputMatrix[channel][delOut] * (feedbackMatrix[delIn][delOut] * feedbackScalar);
+                    for (int delOut = 0; delOut < delayCount; ++delOut)
+                    {
+                        // delIn = row; delOut = column
+                        // can += all because feedbackSigMatrix starts with all zeroes
+                        feedbackSigMatrix[channel][delIn] +=
+                            delayOutputMatrix[channel][delOut] * (feedbackMatrix[delIn][delOut] * feedbackScalar);
+                    }
                 }
             }
 
+            // crossfade to the lowest tier's matrix; both are orthogonal, so any mix of them is stable
+            float fullNetworkGain = fullNetworkFade.getGain(sample, numSamples);
+            if (!fullNetworkFade.isFullyOn())
+            {
+                float lowTierFeedback[lowTierDelayCount]{};
+                for (int row = 0; row < lowTierDelayCount; ++row)
+                    for (int column = 0; column < lowTierDelayCount; ++column)
+                        lowTierFeedback[row] +=
+                            delayOutputMatrix[channel][lowTierDelays[column]] * lowTierMatrix[row][column];
+
+                for (auto& feedback : feedbackSigMatrix[channel])
+                    feedback *= fullNetworkGain;
+                for (int row = 0; row < lowTierDelayCount; ++row)
+                    feedbackSigMatrix[channel][lowTierDelays[row]] += lowTierFeedback[row] * (1.0f - fullNetworkGain);
+            }
+
             // signal/feedback into delays
             for (int del = 0; del < delayCount; ++del)
             {
+                if (!runAllDelays && !isLowTierDelay[del])
+                    continue;
+
                 // only include input if this delay is the input for the channel
                 // inDelays is input delay *indices*
                 if (channel < 2 && del == inDelays[channel])
                 {
-                    delays[del].pushSample(channel, channelData[sample] + dampingFilters[del].processSample(
-                                                                              channel, feedbackSigMatrix[channel][del] *
-                                                                                           parameters.decayTime));
+                    delays[channel][del].pushSample(
+                        0, inputData[sample] + dampingFilters[channel][del].processSample(
+                                                   0, feedbackSigMatrix[channel][del] * parameters.decayTime));
                 }
                 else
                 {
-                    delays[del].pushSample(channel,
-                                           dampingFilters[del].processSample(channel, feedbackSigMatrix[channel][del] *
-                                                                                          parameters.decayTime));
+                    delays[channel][del].pushSample(0, dampingFilters[channel][del].processSample(
+                                                            0, feedbackSigMatrix[channel][del] * parameters.decayTime));
                 }
             }
 
-            // zero-out channelData so all loops can use += without including dry signal
-            channelData[sample] = 0;
+            // zero-out channelData so all loops can use += without including dry signal; for FOA the whole buffer
+            // was cleared
+            if (!renderingFoa)
+                channelData[sample] = 0;
 
             // delays into channelData
             for (int del = 0; del < delayCount; ++del)
             {
+                if (!runAllDelays && !isLowTierDelay[del])
+                    continue;
+
                 // apply lfo if this delay is modulated
                 float delayMod = 0;
                 if (del == modDelays[0])
@@ -212,22 +303,47 @@ void GeneralizedFDN::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBu
                     delayMod = lfoOutput.quadPhaseOutput_pos;
 
                 // load delay outputs into output matrix for scaling/feedback
-                delayOutputMatrix[channel][del] = delays[del].popSample(channel, delayTimes[del] + (16.0f * delayMod));
+                delayOutputMatrix[channel][del] =
+                    delays[channel][del].popSample(0, scaleDelay(delayTimes[del]) + (16.0f * delayScale * delayMod));
 
                 // load delay data from matrix to buffer for plugin output
-                channelData[sample] += delayOutputMatrix[channel][del]; // / delayCount;
+                // for FOA, counted from the delay the input goes into
+                // the input goes into one delay and the feedback shares it out among however many are running, so the
+                // kept delays carry the same level without being made louder
+                float outputGain = isLowTierDelay[del] ? 1.0f : fullNetworkGain;
+                if (renderingFoa)
+                    foaEncoder.addTap(channel * delayCount + wrapInt(del - inDelays[channel], delayCount),
+                                      delayOutputMatrix[channel][del] * outputGain, foaOutput, sample);
+                else
+                    channelData[sample] += delayOutputMatrix[channel][del] * outputGain; // / delayCount;
             }
         }
+    };
+
+    // for FOA both networks add into the same four channels, so they take turns
+    if (renderingFoa)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            processChannel(channel);
+    }
+    else
+    {
+        forEachChannel(numChannels, processChannel);
     }
 }
 
 void GeneralizedFDN::reset()
 {
-    for (auto& del : delays)
-        del.reset();
+    for (auto& channelDelays : delays)
+        for (auto& del : channelDelays)
+            del.reset();
+
+    for (auto& channelFilters : dampingFilters)
+        for (auto& filt : channelFilters)
+            filt.reset();
 
-    for (auto& filt : dampingFilters)
-        filt.reset();
+    modulationFade.finishFade();
+    fullNetworkFade.finishFade();
 }
 
 ReverbProcessorParameters& GeneralizedFDN::getParameters()
@@ -244,6 +360,33 @@ void GeneralizedFDN::setParameters(const ReverbProcessorParameters& params)
     }
 }
 
+double GeneralizedFDN::getTailLengthSeconds()
+{
+    // the feedback matrices are orthogonal, so a trip through any delay only loses decayTime, and the mixing spreads the
+    // energy over every delay so it decays at the rate of the mean one; the delays are read at their unscaled lengths,
+    // so roomSize doesn't enter into it
+    double hostSampleRate = sampleRate / delayScale;
+    double meanSeconds =
+        std::accumulate(delayTimes.begin(), delayTimes.end(), 0.0) / delayTimes.size() / hostSampleRate;
+    double longestSeconds = *std::max_element(delayTimes.begin(), delayTimes.end()) / hostSampleRate;
+    return longestSeconds + loopDecayTime(parameters.decayTime, meanSeconds);
+}
+
+bool GeneralizedFDN::isTimeInvariant()
+{
+    return false;
+}
+
+bool GeneralizedFDN::supportsFoaOutput()
+{
+    return true;
+}
+
+int GeneralizedFDN::getNumQualityTiers()
+{
+    return 3;
+}
+
 //===================================================================
 
 // unused matrices
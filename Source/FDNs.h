@@ -4,8 +4,10 @@
 
 #include <JuceHeader.h>
 
+#include "FoaTapEncoder.h"
 #include "LFO.h"
 #include "ProcessorBase.h"
+#include "QualityTiers.h"
 #include "Utilities.h"
 
 class GeneralizedFDN : public ReverbProcessorBase
@@ -27,22 +29,31 @@ class GeneralizedFDN : public ReverbProcessorBase
 
     void setParameters(const ReverbProcessorParameters& params) override;
 
+    double getTailLengthSeconds() override;
+
+    // two delays are always modulated, whatever modDepth is
+    bool isTimeInvariant() override;
+
+    // both channels' networks, every delay a tap
+    bool supportsFoaOutput() override;
+
+    // 0: as designed; 1: unmodulated; 2: also only four of the delays
+    int getNumQualityTiers() override;
+
   private:
     // parameter class
     ReverbProcessorParameters parameters;
 
-    // delays
-    std::vector<juce::dsp::DelayLine<float>> delays{};
-
-    // lowpass filters
-    std::vector<juce::dsp::FirstOrderTPTFilter<float>> dampingFilters{};
+    // delays and lowpass filters, per channel then per delay; no state is shared between the channels' networks, so
+    // they can run on separate threads
+    std::vector<std::vector<juce::dsp::DelayLine<float>>> delays{};
+    std::vector<std::vector<juce::dsp::FirstOrderTPTFilter<float>>> dampingFilters{};
 
     // hold output/feedback signals
     std::vector<std::vector<float>> delayOutputMatrix{};
     std::vector<std::vector<float>> feedbackSigMatrix{};
 
     OscillatorParameters lfoParameters;
-    SignalGenData lfoOutput;
     std::vector<LFO> lfo;
 
     float feedbackScalar = sqrt(2.0f);
@@ -57,6 +68,24 @@ class GeneralizedFDN : public ReverbProcessorBase
     std::vector<int> modDelays{1, 3};
 
     int delayCount = 8;
+
+    // the lowest tier runs only these delays, mixed by a 4x4 Hadamard matrix; both input delays are among them, and the
+    // others are picked to keep the mean delay, which sets the decay rate, close to the whole network's
+    static constexpr int lowTierDelayCount = 4;
+    std::vector<int> lowTierDelays{4, 6, 5, 7};
+    std::vector<bool> isLowTierDelay{};
+    const float lowTierMatrix[lowTierDelayCount][lowTierDelayCount]{
+        {0.5f, 0.5f, 0.5f, 0.5f}, {0.5f, -0.5f, 0.5f, -0.5f}, {0.5f, 0.5f, -0.5f, -0.5f}, {0.5f, -0.5f, -0.5f, 0.5f}};
+
+    TierFade modulationFade;
+    TierFade fullNetworkFade;
+
+    double sampleRate = 44100.0;
+
+    // FOA output; the stereo input is copied out first, since the networks' outputs overwrite it
+    bool renderingFoa = false;
+    FoaTapEncoder foaEncoder;
+    juce::AudioBuffer<float> networkInput;
 };
 
 //===================================================================
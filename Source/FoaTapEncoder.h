@@ -0,0 +1,57 @@
+// First-order ambisonic (AmbiX: ACN channel order, SN3D) encoding of a reverb's delay taps
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*
+Each tap gets a direction of its own. The first half of the taps, the ones a stereo algorithm sums into its left output,
+are spread evenly over the left hemisphere and the second half over the right, so a decoder still hears the stereo
+image. The taps come from different points in the network and are close to uncorrelated, so together they make a
+diffuse field with no extra decorrelation. Taps on a side go in opposite pairs about the left-right axis, so whatever
+they do have in common cancels in X and Z rather than pulling the field towards one direction.
+*/
+class FoaTapEncoder
+{
+  public:
+    static constexpr int numChannels = 4;
+
+    // numTaps is even; half per side, each side's starting with the taps nearest the input
+    void prepare(int numTaps)
+    {
+        gains.resize(static_cast<size_t>(numTaps));
+
+        int tapsPerSide = numTaps / 2;
+        int numPairs = tapsPerSide / 2;
+        for (int tap = 0; tap < tapsPerSide; ++tap)
+        {
+            // pairs on a Fibonacci spiral around the left-right axis, even over the hemisphere, starting nearest the
+            // side, which the taps nearest the input are given; an odd one out points straight to the side
+            int pair = tap / 2;
+            float y = pair < numPairs ? 1.0f - (pair + 0.5f) / numPairs : 1.0f;
+            float radius = std::sqrt(1.0f - y * y);
+            float angle = pair * goldenAngle + (tap % 2) * juce::MathConstants<float>::pi;
+            float x = radius * std::cos(angle);
+            float z = radius * std::sin(angle);
+
+            // the right side is the left turned half a revolution about the front-back axis
+            gains[static_cast<size_t>(tap)] = {tapGain, tapGain * y, tapGain * z, tapGain * x};
+            gains[static_cast<size_t>(tap + tapsPerSide)] = {tapGain, -tapGain * y, -tapGain * z, tapGain * x};
+        }
+    }
+
+    // adds a tap to W, Y, Z and X at this sample
+    void addTap(int tap, float value, float* const* output, int sample) const
+    {
+        const auto& tapGains = gains[static_cast<size_t>(tap)];
+        for (int channel = 0; channel < numChannels; ++channel)
+            output[channel][sample] += tapGains[static_cast<size_t>(channel)] * value;
+    }
+
+  private:
+    static constexpr float goldenAngle = 2.39996323f;
+    // W sums both sides' taps; this keeps it at the level of one stereo output
+    static constexpr float tapGain = 0.70710678f;
+
+    std::vector<std::array<float, numChannels>> gains;
+};
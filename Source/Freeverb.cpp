@@ -8,25 +8,37 @@ Freeverb::~Freeverb() = default;
 
 void Freeverb::prepare(const juce::dsp::ProcessSpec& spec)
 {
-    // 8 combs/damping filters in parallel; 4 allpasses in series
-    combs.resize(combCount);
-    dampingFilters.resize(combCount);
-    allpasses.resize(allpassCount);
+    sampleRate = spec.sampleRate;
 
-    for (auto& comb : combs)
-    {
-        comb.prepare(spec);
-        comb.setMaximumDelayInSamples(spec.sampleRate * 0.5);
-    }
-    for (auto& filter : dampingFilters)
-    {
-        filter.prepare(spec);
-        filter.setType(juce::dsp::FirstOrderTPTFilterType::lowpass);
-    }
-    for (auto& allpass : allpasses)
+    // 8 combs/damping filters in parallel; 4 allpasses in series; mono, for each channel
+    juce::dsp::ProcessSpec monoSpec = spec;
+    monoSpec.numChannels = 1;
+
+    combs.resize(spec.numChannels);
+    dampingFilters.resize(spec.numChannels);
+    allpasses.resize(spec.numChannels);
+
+    for (size_t channel = 0; channel < spec.numChannels; ++channel)
     {
-        allpass.prepare(spec);
-        allpass.setMaximumDelayInSamples(spec.sampleRate * 0.5);
+        combs[channel].resize(combCount);
+        dampingFilters[channel].resize(combCount);
+        allpasses[channel].resize(allpassCount);
+
+        for (auto& comb : combs[channel])
+        {
+            comb.prepare(monoSpec);
+            comb.setMaximumDelayInSamples(spec.sampleRate * 0.5);
+        }
+        for (auto& filter : dampingFilters[channel])
+        {
+            filter.prepare(monoSpec);
+            filter.setType(juce::dsp::FirstOrderTPTFilterType::lowpass);
+        }
+        for (auto& allpass : allpasses[channel])
+        {
+            allpass.prepare(monoSpec);
+            allpass.setMaximumDelayInSamples(spec.sampleRate * 0.5);
+        }
     }
 
     // prepare lfo
@@ -39,13 +51,14 @@ void Freeverb::prepare(const juce::dsp::ProcessSpec& spec)
         osc.reset(spec.sampleRate);
     }
 
+    modulationFade.prepare(spec.sampleRate);
+    extraCombFade.prepare(spec.sampleRate);
+
     reset();
 }
 
 void Freeverb::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
-    juce::ScopedNoDenormals noDenormals;
-
     int numChannels = buffer.getNumChannels();
     int numSamples = buffer.getNumSamples();
 
@@ -58,24 +71,43 @@ void Freeverb::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&
     }
 
     // set up comb damping filters
-    for (int i = 0; i < combCount; ++i)
-        dampingFilters[i].setCutoffFrequency(parameters.damping);
+    for (auto& channelFilters : dampingFilters)
+        for (int i = 0; i < combCount; ++i)
+            channelFilters[i].setCutoffFrequency(parameters.damping);
 
-    for (int channel = 0; channel < numChannels; ++channel)
+    // quality tier
+    modulationFade.setOn(qualityTier < 1);
+    if (extraCombFade.setOn(qualityTier < 2))
     {
-        auto* channelData = buffer.getWritePointer(channel);
+        for (size_t channel = 0; channel < combs.size(); ++channel)
+        {
+            for (int i = lowTierCombCount; i < combCount; ++i)
+            {
+                combs[channel][i].reset();
+                dampingFilters[channel][i].reset();
+            }
+        }
+    }
+    modulationFade.advance(numSamples);
+    extraCombFade.advance(numSamples);
 
-        lfoParameters = lfo[channel].getParameters();
-        lfoParameters.frequency_Hz = parameters.modRate;
-        lfo[channel].setParameters(lfoParameters);
+    // the dropped combs are only run while they fade out
+    int activeCombCount = extraCombFade.isActive() ? static_cast<int>(combCount) : lowTierCombCount;
+
+    auto processChannel = [&](int channel) {
+        auto* channelData = buffer.getWritePointer(channel);
+        auto& channelCombs = combs[channel];
+        auto& channelAllpasses = allpasses[channel];
+        auto& channelFilters = dampingFilters[channel];
 
-        // set up combs - need to be in channel loop to have channel spread
+        // set up combs - need to be in channel loop to have channel spread; the lengths are in samples at the host rate
         for (int i = 0; i < combCount; ++i)
-            combs[i].setDelay(combDelayTimes[i] * parameters.roomSize + (channel * stereoWidth));
+            channelCombs[i].setDelay(scaleDelay(combDelayTimes[i] * parameters.roomSize + (channel * stereoWidth)));
 
         // set up allpasses
         for (int i = 0; i < allpassCount; ++i)
-            allpasses[i].setDelay(allpassDelayTimes[i] * parameters.roomSize + (channel * stereoWidth));
+            channelAllpasses[i].setDelay(
+                scaleDelay(allpassDelayTimes[i] * parameters.roomSize + (channel * stereoWidth)));
 
         // comb processing in parallel
         for (int sample = 0; sample < numSamples; ++sample)
@@ -84,12 +116,17 @@ void Freeverb::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&
 
             float combMix = 0;
 
-            for (int i = 0; i < combCount; ++i)
+            // the combs are close to uncorrelated, so as the extra ones fade out the rest come up by as much as
+            // sqrt(2) to keep the level
+            float extraCombGain = extraCombFade.getGain(sample, numSamples);
+            float keptCombGain = 1.0f + (juce::MathConstants<float>::sqrt2 - 1.0f) * (1.0f - extraCombGain);
+
+            for (int i = 0; i < activeCombCount; ++i)
             {
-                float combOutput = combs[i].popSample(channel);
-                combs[i].pushSample(channel, dampingFilters[i].processSample(
-                                                 channel, channelData[sample] + combOutput * parameters.decayTime));
-                combMix += combOutput;
+                float combOutput = channelCombs[i].popSample(0);
+                channelCombs[i].pushSample(
+                    0, channelFilters[i].processSample(0, channelData[sample] + combOutput * parameters.decayTime));
+                combMix += combOutput * (i < lowTierCombCount ? keptCombGain : extraCombGain);
             }
 
             channelData[sample] = combMix / combCount;
@@ -101,37 +138,69 @@ void Freeverb::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&
         for (int sample = 0; sample < numSamples; ++sample)
         {
             // LFO
-            lfoOutput = lfo[channel].renderAudioOutput();
+            SignalGenData lfoOutput = renderModulation(lfo[channel], modulationFade, sample, numSamples);
 
             for (int i = 0; i < allpassCount; ++i)
             {
                 float delayOutput;
 
                 if (i % 2 == 0)
-                    delayOutput = allpasses[i].popSample(
-                        channel, allpassDelayTimes[i] + (lfoOutput.normalOutput * 12.0f * parameters.modDepth));
+                    delayOutput = channelAllpasses[i].popSample(
+                        0, scaleDelay(allpassDelayTimes[i]) +
+                               (lfoOutput.normalOutput * 12.0f * delayScale * parameters.modDepth));
                 else
-                    delayOutput = allpasses[i].popSample(channel);
+                    delayOutput = channelAllpasses[i].popSample(0);
 
                 float feedback = delayOutput * -allpassFeedbackCoefficient;
                 float vn = channelData[sample] + feedback;
-                allpasses[i].pushSample(channel, vn);
+                channelAllpasses[i].pushSample(0, vn);
                 channelData[sample] = delayOutput + (vn * allpassFeedbackCoefficient);
             }
         }
-    }
+    };
+
+    forEachChannel(numChannels, processChannel);
 }
 
 void Freeverb::reset()
 {
-    for (auto& comb : combs)
-        comb.reset();
+    for (auto& channelCombs : combs)
+        for (auto& comb : channelCombs)
+            comb.reset();
+
+    for (auto& channelFilters : dampingFilters)
+        for (auto& filter : channelFilters)
+            filter.reset();
+
+    for (auto& channelAllpasses : allpasses)
+        for (auto& allpass : channelAllpasses)
+            allpass.reset();
 
-    for (auto& filter : dampingFilters)
-        filter.reset();
+    modulationFade.finishFade();
+    extraCombFade.finishFade();
+}
+
+int Freeverb::getNumQualityTiers()
+{
+    return 3;
+}
+
+double Freeverb::getTailLengthSeconds()
+{
+    // the combs decay in parallel, so the longest one sets the tail; the allpasses after them are fixed at 0.5
+    float longestComb = *std::max_element(combDelayTimes.begin(), combDelayTimes.end());
+    double combSeconds = (longestComb * parameters.roomSize + stereoWidth) * delayScale / sampleRate;
+
+    double allpassSeconds = 0;
+    double allpassDecay = 0;
+    for (auto delayTime : allpassDelayTimes)
+    {
+        double delaySeconds = (delayTime * parameters.roomSize + stereoWidth) * delayScale / sampleRate;
+        allpassSeconds += delaySeconds;
+        allpassDecay = std::max(allpassDecay, loopDecayTime(0.5, delaySeconds));
+    }
 
-    for (auto& allpass : allpasses)
-        allpass.reset();
+    return combSeconds + loopDecayTime(parameters.decayTime, combSeconds) + allpassSeconds + allpassDecay;
 }
 
 ReverbProcessorParameters& Freeverb::getParameters()
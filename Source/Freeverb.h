@@ -7,6 +7,7 @@
 
 #include "LFO.h"
 #include "ProcessorBase.h"
+#include "QualityTiers.h"
 #include "Utilities.h"
 
 class Freeverb : public ReverbProcessorBase
@@ -26,24 +27,36 @@ class Freeverb : public ReverbProcessorBase
 
     void setParameters(const ReverbProcessorParameters& params) override;
 
+    double getTailLengthSeconds() override;
+
+    // 0: as designed; 1: allpasses unmodulated; 2: also only the four longest combs
+    int getNumQualityTiers() override;
+
   private:
     ReverbProcessorParameters parameters;
 
-    std::vector<juce::dsp::DelayLine<float>> combs{};
-    std::vector<juce::dsp::DelayLine<float>> allpasses{};
-    std::vector<juce::dsp::FirstOrderTPTFilter<float>> dampingFilters{};
+    // per channel, then per comb or allpass; the channels share no state, so they can run on separate threads
+    std::vector<std::vector<juce::dsp::DelayLine<float>>> combs{};
+    std::vector<std::vector<juce::dsp::DelayLine<float>>> allpasses{};
+    std::vector<std::vector<juce::dsp::FirstOrderTPTFilter<float>>> dampingFilters{};
 
     OscillatorParameters lfoParameters;
-    SignalGenData lfoOutput;
     std::vector<LFO> lfo;
 
     size_t combCount = 8;
     size_t allpassCount = 4;
 
+    // the combs after the first lowTierCombCount, which are dropped in the lowest tier
+    static constexpr int lowTierCombCount = 4;
+    TierFade modulationFade;
+    TierFade extraCombFade;
+
     std::vector<float> combDelayTimes{1557, 1617, 1491, 1422, 1277, 1356, 1188, 1116};
     std::vector<float> allpassDelayTimes{225, 441, 556, 341};
 
     float stereoWidth = 23;
+
+    double sampleRate = 44100.0;
 };
 
 // class Freeverb : public ProcessorBase
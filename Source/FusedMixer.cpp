@@ -0,0 +1,161 @@
+// Mixes the dry signal into the reverb's input and the plugin's output, from one copy of it
+
+#include "FusedMixer.h"
+
+FusedMixer::FusedMixer(int maximumWetLatencyInSamples) : maximumWetLatency(maximumWetLatencyInSamples)
+{
+}
+
+void FusedMixer::prepare(const juce::dsp::ProcessSpec& spec, int numCoreChannels)
+{
+    sampleRate = spec.sampleRate;
+    maximumBlockSize = static_cast<int>(spec.maximumBlockSize);
+    coreChannels = numCoreChannels;
+    separateCore = numCoreChannels != static_cast<int>(spec.numChannels);
+
+    ringSize = maximumWetLatency + maximumBlockSize;
+    ring.setSize(static_cast<int>(spec.numChannels), ringSize);
+    coreDry.setSize(coreChannels, separateCore ? maximumBlockSize : 0);
+
+    dryRamp.resize(static_cast<size_t>(maximumBlockSize));
+    wetRamp.resize(static_cast<size_t>(maximumBlockSize));
+
+    reset();
+}
+
+void FusedMixer::reset()
+{
+    ring.clear();
+    coreDry.clear();
+    writePosition = 0;
+    blockStart = 0;
+
+    for (auto* gains : {&earlyGains, &outputGains})
+    {
+        gains->dry.reset(sampleRate, rampSeconds);
+        gains->wet.reset(sampleRate, rampSeconds);
+    }
+}
+
+void FusedMixer::setEarlyMixProportion(float proportion)
+{
+    earlyGains.setProportion(proportion);
+}
+
+void FusedMixer::setWetMixProportion(float proportion)
+{
+    outputGains.setProportion(proportion);
+}
+
+void FusedMixer::setWetLatency(int latencySamples)
+{
+    jassert(latencySamples >= 0 && latencySamples <= maximumWetLatency);
+    wetLatency = juce::jlimit(0, maximumWetLatency, latencySamples);
+}
+
+void FusedMixer::pushDrySamples(const juce::AudioBuffer<float>& input, int numSamples)
+{
+    jassert(numSamples <= maximumBlockSize);
+    numSamples = juce::jmin(numSamples, maximumBlockSize);
+
+    blockStart = writePosition;
+    int firstRun = juce::jmin(numSamples, ringSize - writePosition);
+    for (int channel = 0; channel < juce::jmin(input.getNumChannels(), ring.getNumChannels()); ++channel)
+    {
+        ring.copyFrom(channel, writePosition, input, channel, 0, firstRun);
+        if (firstRun < numSamples)
+            ring.copyFrom(channel, 0, input, channel, firstRun, numSamples - firstRun);
+    }
+    writePosition = (writePosition + numSamples) % ringSize;
+}
+
+void FusedMixer::pushCoreDrySamples(const juce::AudioBuffer<float>& core, int numSamples)
+{
+    jassert(separateCore && numSamples <= maximumBlockSize);
+    numSamples = juce::jmin(numSamples, coreDry.getNumSamples());
+
+    for (int channel = 0; channel < juce::jmin(core.getNumChannels(), coreDry.getNumChannels()); ++channel)
+        coreDry.copyFrom(channel, 0, core, channel, 0, numSamples);
+}
+
+void FusedMixer::mixEarlySamples(juce::AudioBuffer<float>& core, int numSamples)
+{
+    jassert(numSamples <= maximumBlockSize);
+    numSamples = juce::jmin(numSamples, maximumBlockSize);
+
+    bool ramping = fillRamps(earlyGains, numSamples);
+    for (int channel = 0; channel < juce::jmin(core.getNumChannels(), coreChannels); ++channel)
+    {
+        if (separateCore)
+            mixChannel(core.getWritePointer(channel), coreDry.getReadPointer(channel), earlyGains, ramping, 0,
+                       numSamples);
+        else
+            mixFromRing(core.getWritePointer(channel), channel, blockStart, earlyGains, ramping, numSamples);
+    }
+}
+
+void FusedMixer::mixWetSamples(juce::AudioBuffer<float>& output, int numSamples)
+{
+    jassert(numSamples <= maximumBlockSize);
+    numSamples = juce::jmin(numSamples, maximumBlockSize);
+
+    bool ramping = fillRamps(outputGains, numSamples);
+
+    // fully wet, the dry signal has nothing to add
+    if (!ramping && outputGains.dry.getCurrentValue() == 0.0f && outputGains.wet.getCurrentValue() == 1.0f)
+        return;
+
+    int dryStart = (blockStart - wetLatency + ringSize) % ringSize;
+    for (int channel = 0; channel < juce::jmin(output.getNumChannels(), ring.getNumChannels()); ++channel)
+        mixFromRing(output.getWritePointer(channel), channel, dryStart, outputGains, ramping, numSamples);
+}
+
+void FusedMixer::Gains::setProportion(float proportion)
+{
+    dry.setTargetValue(1.0f - proportion);
+    wet.setTargetValue(proportion);
+}
+
+bool FusedMixer::fillRamps(Gains& gains, int numSamples)
+{
+    if (!gains.dry.isSmoothing() && !gains.wet.isSmoothing())
+        return false;
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        dryRamp[static_cast<size_t>(sample)] = gains.dry.getNextValue();
+        wetRamp[static_cast<size_t>(sample)] = gains.wet.getNextValue();
+    }
+    return true;
+}
+
+void FusedMixer::mixChannel(float* destination, const float* dry, const Gains& gains, bool ramping, int rampOffset,
+                            int numSamples) const
+{
+    // plain loops over contiguous samples, which the compiler vectorises
+    if (ramping)
+    {
+        const float* wetGain = wetRamp.data() + rampOffset;
+        const float* dryGain = dryRamp.data() + rampOffset;
+        for (int sample = 0; sample < numSamples; ++sample)
+            destination[sample] = destination[sample] * wetGain[sample] + dry[sample] * dryGain[sample];
+    }
+    else
+    {
+        float wetGain = gains.wet.getCurrentValue();
+        float dryGain = gains.dry.getCurrentValue();
+        for (int sample = 0; sample < numSamples; ++sample)
+            destination[sample] = destination[sample] * wetGain + dry[sample] * dryGain;
+    }
+}
+
+void FusedMixer::mixFromRing(float* destination, int channel, int dryStart, const Gains& gains, bool ramping,
+                             int numSamples) const
+{
+    const float* dry = ring.getReadPointer(channel);
+    int firstRun = juce::jmin(numSamples, ringSize - dryStart);
+
+    mixChannel(destination, dry + dryStart, gains, ramping, 0, firstRun);
+    if (firstRun < numSamples)
+        mixChannel(destination + firstRun, dry, gains, ramping, firstRun, numSamples - firstRun);
+}
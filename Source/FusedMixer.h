@@ -0,0 +1,92 @@
+// Mixes the dry signal into the reverb's input and the plugin's output, from one copy of it
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*
+Does the work of two DryWetMixers, one putting the dry signal under the early reflections at the reverb's input and
+one under the wet signal at the output, without either of them copying the block: the dry signal is kept once, in a
+ring long enough to delay it by the wet path's latency, and each mix is one pass over its destination. The gains are
+those of DryWetMixer's linear rule, dry 1 - proportion and wet proportion, each ramped over rampSeconds when the
+proportion changes; the ramps are worked out once per block and shared by every channel.
+Nothing is allocated after prepare(), and blocks can be up to the prepared size.
+*/
+class FusedMixer
+{
+  public:
+    static constexpr double rampSeconds = 0.05;
+
+    explicit FusedMixer(int maximumWetLatencyInSamples);
+
+    // spec is the whole layout's; the early mix is over the first numCoreChannels of it, or over a downmix pushed with
+    // pushCoreDrySamples() when those differ
+    void prepare(const juce::dsp::ProcessSpec& spec, int numCoreChannels);
+
+    // empties the ring and ends any ramps
+    void reset();
+
+    // of early reflections against the dry signal, in the reverb's input
+    void setEarlyMixProportion(float proportion);
+
+    // of the wet signal against the dry signal, in the output
+    void setWetMixProportion(float proportion);
+
+    // the dry signal is delayed by this much in the output, to line up with the wet signal; up to the constructor's
+    // maximum
+    void setWetLatency(int latencySamples);
+
+    // keeps the block's input before the wet path writes over it; once per block, before either mix
+    void pushDrySamples(const juce::AudioBuffer<float>& input, int numSamples);
+
+    // for layouts whose wet path runs on a downmix, the downmix before anything else is done to it
+    void pushCoreDrySamples(const juce::AudioBuffer<float>& core, int numSamples);
+
+    // replaces the early reflections in core with the reverb's input; the dry signal isn't delayed here
+    void mixEarlySamples(juce::AudioBuffer<float>& core, int numSamples);
+
+    // replaces the wet signal in output with the plugin's output
+    void mixWetSamples(juce::AudioBuffer<float>& output, int numSamples);
+
+  private:
+    struct Gains
+    {
+        // fully wet until told otherwise, as DryWetMixer starts
+        juce::SmoothedValue<float> dry{0.0f};
+        juce::SmoothedValue<float> wet{1.0f};
+
+        void setProportion(float proportion);
+    };
+
+    // fills the ramp arrays when either gain is moving; returns false, with the ramps untouched, when both are steady
+    bool fillRamps(Gains& gains, int numSamples);
+
+    // destination = destination * wet + dry * dry gain, over numSamples of one channel; the ramps from rampOffset
+    void mixChannel(float* destination, const float* dry, const Gains& gains, bool ramping, int rampOffset,
+                    int numSamples) const;
+
+    // mixes the ring's samples from dryStart onwards into destination, in up to two runs, as the ring wraps
+    void mixFromRing(float* destination, int channel, int dryStart, const Gains& gains, bool ramping,
+                     int numSamples) const;
+
+    const int maximumWetLatency;
+
+    double sampleRate = 44100;
+    int maximumBlockSize = 0;
+    int coreChannels = 0;
+    bool separateCore = false;
+
+    // every channel's input, ringSize samples of it; blockStart is where this block's went
+    juce::AudioBuffer<float> ring;
+    int ringSize = 0;
+    int writePosition = 0;
+    int blockStart = 0;
+    int wetLatency = 0;
+
+    juce::AudioBuffer<float> coreDry;
+
+    Gains earlyGains;
+    Gains outputGains;
+    std::vector<float> dryRamp;
+    std::vector<float> wetRamp;
+};
@@ -2,547 +2,116 @@
 
 #include "GardnerRooms.h"
 
-GardnerSmallRoom::GardnerSmallRoom() = default;
-
-GardnerSmallRoom::~GardnerSmallRoom() = default;
-
-void GardnerSmallRoom::prepare(const juce::dsp::ProcessSpec& spec)
+namespace
 {
-    sampleRate = spec.sampleRate;
-
-    delay1.prepare(spec);
-    delay2.prepare(spec);
-    delay3.prepare(spec);
-    delay4.prepare(spec);
-    delay5.prepare(spec);
-    delay6.prepare(spec);
-
-    dampingFilter.prepare(spec);
-    dampingFilter.setType(juce::dsp::FirstOrderTPTFilterType::lowpass);
+using Step = AllpassGraphStep;
 
-    // prepare lfo
-    lfoParameters.frequency_Hz = 0.25;
-    lfoParameters.waveform = generatorWaveform::sin;
-    lfo.resize(spec.numChannels);
-    for (auto& osc : lfo)
-    {
-        osc.setParameters(lfoParameters);
-        osc.reset(spec.sampleRate);
-    }
-
-    reset();
-}
-
-void GardnerSmallRoom::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+struct SmallRoomTopology : AllpassGraphTopology
 {
-    juce::ScopedNoDenormals noDenormals;
-
-    float samplesPerMs = sampleRate / 1000;
-
-    dampingFilter.setCutoffFrequency(parameters.damping);
-
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
-    {
-        auto* channelData = buffer.getWritePointer(channel);
-
-        lfoParameters = lfo[channel].getParameters();
-        lfoParameters.frequency_Hz = parameters.modRate;
-        lfo[channel].setParameters(lfoParameters);
-
+    static constexpr int channelDelayOffset = 7;
+    static constexpr std::array steps{
+        Step::input(),
+        Step::feedbackReturn(),
         // segment 1
-        delay1.setDelay(24 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]);
-        float delay2Time = 22 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]; // for modulation
-        delay2.setDelay(delay2Time);
-        delay3.setDelay(8.3 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]);
-        delay4.setDelay(4.7 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]);
-        // segment 2
-        float delay5Time = 30 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]; // for modulation
-        delay5.setDelay(delay5Time);
-        delay6.setDelay(36 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]);
-
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-        {
-            // LFO
-            lfoOutput = lfo[channel].renderAudioOutput();
-
-            channelData[sample] += channelFeedback.at(channel);
-
-            delay1.pushSample(channel, channelData[sample]);
-            channelData[sample] = delay1.popSample(channel);
-
-            // outer 35ms allpass
-            feedforwardOuter = channelData[sample];
-            allpassOutputOuter = delay4.popSample(channel);
-            feedbackOuter = (allpassOutputOuter + (feedforwardOuter * -0.3)) * 0.3;
-            channelData[sample] = feedbackOuter;
-
-            // inner 22ms allpass
-            feedforwardInner = channelData[sample];
-            allpassOutputInner = delay2.popSample(
-                channel, delay2Time + (lfoOutput.normalOutput * 24.0f * parameters.modDepth)); // modulate
-            feedbackInner = (allpassOutputInner + (feedforwardInner * -0.4)) * 0.4;
-            delay2.pushSample(channel, channelData[sample] + feedbackInner);
-            channelData[sample] = allpassOutputInner + (feedforwardInner * -0.4);
-
-            // inner 8.3ms allpass
-            feedforwardInner = channelData[sample];
-            allpassOutputInner = delay3.popSample(channel);
-            feedbackInner = (allpassOutputInner + (feedforwardInner * -0.6)) * 0.6;
-            delay3.pushSample(channel, channelData[sample] + feedbackInner);
-            channelData[sample] = allpassOutputInner + (feedforwardInner * -0.6);
-
-            // finish outer 35ms allpass
-            delay4.pushSample(channel, channelData[sample]);
-            channelData[sample] = allpassOutputOuter + (feedforwardOuter * -0.3);
-
-            // mix into output
-            channelOutput.at(channel) = channelData[sample] * 2.0; // up from 0.5
-
-            // outer 66ms allpass
-            feedforwardOuter = channelData[sample];
-            allpassOutputOuter = delay6.popSample(channel);
-            feedbackOuter = (allpassOutputOuter + (feedforwardOuter * -0.1)) * 0.1;
-            channelData[sample] = feedbackOuter;
-
-            // inner 30ms allpass
-            feedforwardInner = channelData[sample];
-            allpassOutputInner = delay5.popSample(
-                channel, delay5Time + (lfoOutput.quadPhaseOutput_pos * 24.0f * parameters.modDepth)); // modulate
-            feedbackInner = (allpassOutputInner + (feedforwardInner * -0.4)) * 0.4;
-            delay5.pushSample(channel, channelData[sample] + feedbackInner);
-            channelData[sample] = allpassOutputInner + (feedforwardInner * -0.4);
-
-            // finish outer 66ms allpass
-            delay6.pushSample(channel, channelData[sample]);
-            channelData[sample] = allpassOutputOuter + (feedforwardOuter * -0.1);
-
-            // make channel feedback; mix output
-            channelFeedback.at(channel) =
-                dampingFilter.processSample(channel, channelData[sample] * parameters.decayTime);
-            channelOutput.at(channel) += channelData[sample] * 2.0; // up from 0.5
-            channelData[sample] = channelOutput.at(channel);
-        }
-    }
-}
-
-void GardnerSmallRoom::reset()
-{
-    delay1.reset();
-    delay2.reset();
-    delay3.reset();
-    delay4.reset();
-    delay5.reset();
-    delay6.reset();
-
-    dampingFilter.reset();
-}
-
-ReverbProcessorParameters& GardnerSmallRoom::getParameters()
-{
-    return parameters;
-}
-
-void GardnerSmallRoom::setParameters(const ReverbProcessorParameters& params)
-{
-    if (!(params == parameters))
-    {
-        parameters = params;
-        parameters.roomSize = scale(parameters.roomSize, 0.0f, 1.0f, 0.25f, 1.75f);
-    }
-}
-
-//==============================================================================
-GardnerMediumRoom::GardnerMediumRoom() = default;
-
-GardnerMediumRoom::~GardnerMediumRoom() = default;
-
-void GardnerMediumRoom::prepare(const juce::dsp::ProcessSpec& spec)
+        Step::delay(24.0f),
+        // outer 35ms allpass
+        Step::nestedAllpass(4.7f, 0.3f),
+        Step::allpass(22.0f, 0.4f, AllpassGraphModulation::normal),
+        Step::allpass(8.3f, 0.6f),
+        Step::nestedEnd(),
+        Step::outputTap(2.0f), // up from 0.5
+        // segment 2: outer 66ms allpass
+        Step::nestedAllpass(36.0f, 0.1f),
+        Step::allpass(30.0f, 0.4f, AllpassGraphModulation::quadPhase),
+        Step::nestedEnd(),
+        Step::feedbackSend(),
+        Step::outputTap(2.0f), // up from 0.5
+    };
+};
+
+struct MediumRoomTopology : AllpassGraphTopology
 {
-    sampleRate = spec.sampleRate;
-
-    delay1.prepare(spec);
-    delay2.prepare(spec);
-    delay3.prepare(spec);
-    delay4.prepare(spec);
-    delay5.prepare(spec);
-    delay6.prepare(spec);
-    delay7.prepare(spec);
-    delay8.prepare(spec);
-    delay9.prepare(spec);
-    delay10.prepare(spec);
-
-    dampingFilter.prepare(spec);
-    dampingFilter.setType(juce::dsp::FirstOrderTPTFilterType::lowpass);
-
-    // prepare lfo
-    lfoParameters.frequency_Hz = 0.25;
-    lfoParameters.waveform = generatorWaveform::sin;
-    lfo.resize(spec.numChannels);
-    for (auto& osc : lfo)
-    {
-        osc.setParameters(lfoParameters);
-        osc.reset(spec.sampleRate);
-    }
-
-    reset();
-}
-
-void GardnerMediumRoom::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
-{
-    juce::ScopedNoDenormals noDenormals;
-
-    juce::AudioBuffer<float> input2Buffer(buffer.getNumChannels(), buffer.getNumSamples());
-    input2Buffer.clear();
-    input2Buffer.makeCopyOf(buffer, false);
-
-    float samplesPerMs = sampleRate / 1000;
-
-    dampingFilter.setCutoffFrequency(parameters.damping);
-
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
-    {
-        auto* channelData = buffer.getWritePointer(channel);
-        auto* channelData2 = input2Buffer.getWritePointer(channel);
-
-        lfoParameters = lfo[channel].getParameters();
-        lfoParameters.frequency_Hz = parameters.modRate;
-        lfo[channel].setParameters(lfoParameters);
-
-        // input 1
-        delay1.setDelay(8.3 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]);
-        float delay2Time = 22 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]; // for modulation
-        delay2.setDelay(delay2Time);
-        delay3.setDelay(4.7 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]);
+    static constexpr int channelDelayOffset = 15;
+    static constexpr std::array steps{
+        Step::input(),
+        Step::feedbackReturn(),
+        // input 1: outer 35ms allpass
+        Step::nestedAllpass(4.7f, 0.3f),
+        Step::allpass(8.3f, 0.7f),
+        Step::allpass(22.0f, 0.5f, AllpassGraphModulation::normal),
+        Step::nestedEnd(),
+        Step::outputTap(1.0f), // up from 0.5
         // segment 2
-        delay4.setDelay(5 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]);
-        float delay5Time = 30 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]; // for modulation
-        delay5.setDelay(30 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]);
-        delay6.setDelay(67 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]);
+        Step::delay(5.0f),
+        Step::allpass(30.0f, 0.5f, AllpassGraphModulation::quadPhase),
+        Step::delay(67.0f),
+        Step::outputTap(1.0f), // up from 0.5
         // segment 3
-        delay7.setDelay(15 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]);
-        // input 2
-        delay8.setDelay(9.8 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]);
-        delay9.setDelay(29.2 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]);
+        Step::delay(15.0f),
+        Step::decayGain(),
+        // input 2: outer 39ms allpass
+        Step::input(),
+        Step::nestedAllpass(9.8f, 0.3f),
+        Step::allpass(29.2f, 0.6f),
+        Step::nestedEnd(),
+        Step::outputTap(1.0f), // up from 0.5
         // segment 5
-        delay10.setDelay(108 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]);
-
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-        {
-            // LFO
-            lfoOutput = lfo[channel].renderAudioOutput();
-
-            channelData[sample] += channelFeedback.at(channel);
-
-            // outer 35ms allpass
-            feedforwardOuter = channelData[sample];
-            allpassOutputOuter = delay3.popSample(channel);
-            feedbackOuter = (allpassOutputOuter + (feedforwardOuter * -0.3)) * 0.3;
-            channelData[sample] = feedbackOuter;
-
-            // inner 8.3ms allpass
-            feedforwardInner = channelData[sample];
-            allpassOutputInner = delay1.popSample(channel);
-            feedbackInner = (allpassOutputInner + (feedforwardInner * -0.7)) * 0.7;
-            delay1.pushSample(channel, channelData[sample] + feedbackInner);
-            channelData[sample] = allpassOutputInner + (feedforwardInner * -0.7);
-
-            // inner 22ms allpass
-            feedforwardInner = channelData[sample];
-            allpassOutputInner = delay2.popSample(
-                channel, delay2Time + (lfoOutput.normalOutput * 24.0f * parameters.modDepth)); // modulate
-            feedbackInner = (allpassOutputInner + (feedforwardInner * -0.5)) * 0.5;
-            delay2.pushSample(channel, channelData[sample] + feedbackInner);
-            channelData[sample] = allpassOutputInner + (feedforwardInner * -0.5);
-
-            // finish outer 35ms allpass
-            delay3.pushSample(channel, channelData[sample]);
-            channelData[sample] = allpassOutputOuter + (feedforwardOuter * -0.3);
-
-            // output tap 1
-            channelOutput.at(channel) = channelData[sample] * 1.0; // up from 0.5
-
-            delay4.pushSample(channel, channelData[sample]);
-            channelData[sample] = delay4.popSample(channel);
-
-            // single 30ms allpass
-            feedforwardInner = channelData[sample];
-            allpassOutputInner = delay5.popSample(
-                channel, delay5Time + (lfoOutput.quadPhaseOutput_pos * 24.0f * parameters.modDepth)); // modulate
-            feedbackInner = (allpassOutputInner + (feedforwardInner * -0.5)) * 0.5;
-            delay5.pushSample(channel, channelData[sample] + feedbackInner);
-            channelData[sample] = allpassOutputInner + (feedforwardInner * -0.5);
-
-            delay6.pushSample(channel, channelData[sample]);
-            channelData[sample] = delay6.popSample(channel);
+        Step::delay(108.0f),
+        Step::feedbackSend(),
+    };
+};
 
-            // output tap 2
-            channelOutput.at(channel) += channelData[sample] * 1.0; // up from 0.5
-
-            delay7.pushSample(channel, channelData[sample]);
-            channelData[sample] = delay7.popSample(channel);
-            channelData[sample] *= parameters.decayTime;
-
-            // second input to loop
-            channelData[sample] += channelData2[sample];
-
-            // outer 30ms allpass
-            feedforwardOuter = channelData[sample];
-            allpassOutputOuter = delay8.popSample(channel);
-            feedbackOuter = (allpassOutputOuter + (feedforwardOuter * -0.3)) * 0.3;
-            channelData[sample] = feedbackOuter;
-
-            // inner 9.8ms allpass
-            feedforwardInner = channelData[sample];
-            allpassOutputInner = delay9.popSample(channel);
-            feedbackInner = (allpassOutputInner + (feedforwardInner * -0.6)) * 0.6;
-            delay9.pushSample(channel, channelData[sample] + feedbackInner);
-            channelData[sample] = allpassOutputInner + (feedforwardInner * -0.6);
-
-            // finish outer 30ms allpass
-            delay8.pushSample(channel, channelData[sample]);
-            channelData[sample] = allpassOutputOuter + (feedforwardOuter * -0.3);
-
-            // output tap 3
-            channelOutput.at(channel) += channelData[sample] * 1.0; // up from 0.5
-
-            delay10.pushSample(channel, channelData[sample]);
-            channelData[sample] = delay10.popSample(channel);
-
-            channelFeedback.at(channel) =
-                dampingFilter.processSample(channel, channelData[sample] * parameters.decayTime);
-
-            channelData[sample] = channelOutput.at(channel);
-        }
-    }
-}
-
-void GardnerMediumRoom::reset()
+struct LargeRoomTopology : AllpassGraphTopology
 {
-    delay1.reset();
-    delay2.reset();
-    delay3.reset();
-    delay4.reset();
-    delay5.reset();
-    delay6.reset();
-    delay7.reset();
-    delay8.reset();
-    delay9.reset();
-    delay10.reset();
-
-    dampingFilter.reset();
-}
-
-ReverbProcessorParameters& GardnerMediumRoom::getParameters()
+    static constexpr int channelDelayOffset = 23;
+    static constexpr std::array steps{
+        Step::input(),
+        Step::feedbackReturn(),
+        // input 1
+        Step::allpass(8.0f, 0.3f),
+        Step::allpass(12.0f, 0.3f, AllpassGraphModulation::normal),
+        Step::delay(4.0f),
+        Step::outputTap(0.68f), // doubled from given 0.34
+        // segment 2
+        Step::delay(17.0f),
+        // outer 87ms allpass
+        Step::nestedAllpass(25.0f, 0.5f),
+        Step::allpass(62.0f, 0.25f, AllpassGraphModulation::quadPhase),
+        Step::nestedEnd(),
+        Step::delay(31.0f),
+        Step::outputTap(0.28f), // doubled from given 0.14
+        // segment 3
+        Step::delay(3.0f),
+        // outer 120ms allpass
+        Step::nestedAllpass(24.0f, 0.5f),
+        Step::allpass(76.0f, 0.25f),
+        Step::allpass(30.0f, 0.25f),
+        Step::nestedEnd(),
+        Step::outputTap(0.28f), // doubled from given 0.14
+        Step::feedbackSend(),
+    };
+};
+} // namespace
+
+GardnerSmallRoom::GardnerSmallRoom() : AllpassGraphReverb(AllpassGraphKernel<SmallRoomTopology>::getProgram())
 {
-    return parameters;
 }
 
-void GardnerMediumRoom::setParameters(const ReverbProcessorParameters& params)
-{
-    if (!(params == parameters))
-    {
-        parameters = params;
-        parameters.roomSize = scale(parameters.roomSize, 0.0f, 1.0f, 0.25f, 1.75f);
-    }
-}
+GardnerSmallRoom::~GardnerSmallRoom() = default;
 
 //==============================================================================
-GardnerLargeRoom::GardnerLargeRoom() = default;
-
-GardnerLargeRoom::~GardnerLargeRoom() = default;
-
-void GardnerLargeRoom::prepare(const juce::dsp::ProcessSpec& spec)
+GardnerMediumRoom::GardnerMediumRoom() : AllpassGraphReverb(AllpassGraphKernel<MediumRoomTopology>::getProgram())
 {
-    sampleRate = spec.sampleRate;
-
-    delay1.prepare(spec);
-    delay2.prepare(spec);
-    delay3.prepare(spec);
-    delay4.prepare(spec);
-    delay5.prepare(spec);
-    delay6.prepare(spec);
-    delay7.prepare(spec);
-    delay8.prepare(spec);
-    delay9.prepare(spec);
-    delay10.prepare(spec);
-    delay11.prepare(spec);
-
-    dampingFilter.prepare(spec);
-    dampingFilter.setType(juce::dsp::FirstOrderTPTFilterType::lowpass);
-
-    // prepare lfo
-    lfoParameters.frequency_Hz = 0.25;
-    lfoParameters.waveform = generatorWaveform::sin;
-    lfo.resize(spec.numChannels);
-    for (auto& osc : lfo)
-    {
-        osc.setParameters(lfoParameters);
-        osc.reset(spec.sampleRate);
-    }
-
-    reset();
 }
 
-void GardnerLargeRoom::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
-{
-    juce::ScopedNoDenormals noDenormals;
-
-    float samplesPerMs = sampleRate / 1000;
-
-    dampingFilter.setCutoffFrequency(parameters.damping);
-
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
-    {
-        auto* channelData = buffer.getWritePointer(channel);
-
-        lfoParameters = lfo[channel].getParameters();
-        lfoParameters.frequency_Hz = parameters.modRate;
-        lfo[channel].setParameters(lfoParameters);
-
-        // input 1
-        delay1.setDelay(8 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]);
-        float delay2Time = 12 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]; // for modulation
-        delay2.setDelay(delay2Time);
-        delay3.setDelay(4 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]);
-        // segment 2
-        delay4.setDelay(17 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]);
-        float delay5Time = 62 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]; // for modulation
-        delay5.setDelay(delay5Time);
-        delay6.setDelay(25 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]);
-        delay7.setDelay(31 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]);
-        // segment 3
-        delay8.setDelay(3 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]);
-        delay9.setDelay(76 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]);
-        delay10.setDelay(30 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]);
-        delay11.setDelay(24 * samplesPerMs * parameters.roomSize + channelDelayOffset[channel]);
-
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-        {
-            // LFO
-            lfoOutput = lfo[channel].renderAudioOutput();
-
-            channelData[sample] += channelFeedback.at(channel);
-
-            // inner 8ms allpass
-            feedforwardInner = channelData[sample];
-            allpassOutputInner = delay1.popSample(channel);
-            feedbackInner = (allpassOutputInner + (feedforwardInner * -0.3)) * 0.3;
-            delay1.pushSample(channel, channelData[sample] + feedbackInner);
-            channelData[sample] = allpassOutputInner + (feedforwardInner * -0.3);
-
-            // inner 12ms allpass (0.3)
-            feedforwardInner = channelData[sample];
-            allpassOutputInner = delay2.popSample(
-                channel, delay2Time + (lfoOutput.normalOutput * 24.0f * parameters.modDepth)); // modulate
-            feedbackInner = (allpassOutputInner + (feedforwardInner * -0.3)) * 0.3;
-            delay2.pushSample(channel, channelData[sample] + feedbackInner);
-            channelData[sample] = allpassOutputInner + (feedforwardInner * -0.3);
-
-            // 4ms delay
-            delay3.pushSample(channel, channelData[sample]);
-            channelData[sample] = delay3.popSample(channel);
-
-            // output tap 1
-            channelOutput.at(channel) = channelData[sample] * 0.68; // doubled from given 0.34
-
-            // 17ms delay
-            delay4.pushSample(channel, channelData[sample]);
-            channelData[sample] = delay4.popSample(channel);
-
-            // outer 87ms allpass (0.5)
-            feedforwardOuter = channelData[sample];
-            allpassOutputOuter = delay6.popSample(channel);
-            feedbackOuter = (allpassOutputOuter + (feedforwardOuter * -0.5)) * 0.5;
-            channelData[sample] = feedbackOuter;
-
-            // inner 62ms allpass (0.25)
-            feedforwardInner = channelData[sample];
-            allpassOutputInner = delay5.popSample(
-                channel, delay5Time + (lfoOutput.quadPhaseOutput_pos * 24.0f * parameters.modDepth)); // modulate
-            feedbackInner = (allpassOutputInner + (feedforwardInner * -0.25)) * 0.25;
-            delay5.pushSample(channel, channelData[sample] + feedbackInner);
-            channelData[sample] = allpassOutputInner + (feedforwardInner * -0.25);
-
-            // finish outer 87ms allpass
-            delay6.pushSample(channel, channelData[sample]);
-            channelData[sample] = allpassOutputOuter + (feedforwardOuter * -0.5);
-
-            // 31ms delay
-            delay7.pushSample(channel, channelData[sample]);
-            channelData[sample] = delay7.popSample(channel);
-
-            // output tap 2
-            channelOutput.at(channel) += channelData[sample] * 0.28; // doubled from given 0.14
-
-            // 3ms delay
-            delay8.pushSample(channel, channelData[sample]);
-            channelData[sample] = delay8.popSample(channel);
-
-            // outer 120ms allpass (0.5)
-            feedforwardOuter = channelData[sample];
-            allpassOutputOuter = delay11.popSample(channel);
-            feedbackOuter = (allpassOutputOuter + (feedforwardOuter * -0.5)) * 0.5;
-            channelData[sample] = feedbackOuter;
-
-            // inner 76ms allpass (0.25)
-            feedforwardInner = channelData[sample];
-            allpassOutputInner = delay9.popSample(channel);
-            feedbackInner = (allpassOutputInner + (feedforwardInner * -0.25)) * 0.25;
-            delay9.pushSample(channel, channelData[sample] + feedbackInner);
-            channelData[sample] = allpassOutputInner + (feedforwardInner * -0.25);
-
-            // inner 30ms allpass (0.25)
-            feedforwardInner = channelData[sample];
-            allpassOutputInner = delay10.popSample(channel);
-            feedbackInner = (allpassOutputInner + (feedforwardInner * -0.25)) * 0.25;
-            delay10.pushSample(channel, channelData[sample] + feedbackInner);
-            channelData[sample] = allpassOutputInner + (feedforwardInner * -0.25);
-
-            // finish outer 120ms allpass
-            delay11.pushSample(channel, channelData[sample]);
-            channelData[sample] = allpassOutputOuter + (feedforwardOuter * -0.5);
-
-            // output tap 3
-            channelOutput.at(channel) += channelData[sample] * 0.28; // doubled from given 0.14
-
-            // feedback/output
-            channelFeedback.at(channel) =
-                dampingFilter.processSample(channel, channelData[sample] * parameters.decayTime);
-            channelData[sample] = channelOutput.at(channel);
-        }
-    }
-}
-
-void GardnerLargeRoom::reset()
-{
-    delay1.reset();
-    delay2.reset();
-    delay3.reset();
-    delay4.reset();
-    delay5.reset();
-    delay6.reset();
-    delay7.reset();
-    delay8.reset();
-    delay9.reset();
-    delay10.reset();
-    delay11.reset();
-
-    dampingFilter.reset();
-}
+GardnerMediumRoom::~GardnerMediumRoom() = default;
 
-ReverbProcessorParameters& GardnerLargeRoom::getParameters()
+//==============================================================================
+GardnerLargeRoom::GardnerLargeRoom() : AllpassGraphReverb(AllpassGraphKernel<LargeRoomTopology>::getProgram())
 {
-    return parameters;
 }
 
-void GardnerLargeRoom::setParameters(const ReverbProcessorParameters& params)
-{
-    if (!(params == parameters))
-    {
-        parameters = params;
-        parameters.roomSize = scale(parameters.roomSize, 0.0f, 1.0f, 0.25f, 1.75f);
-    }
-}
+GardnerLargeRoom::~GardnerLargeRoom() = default;
 
 ////==============================================================================
 // void GardnerSmallRoom::prepareToPlay(double sampleRate, int samplesPerBlock)
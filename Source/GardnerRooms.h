@@ -4,163 +4,32 @@
 
 #include <JuceHeader.h>
 
-#include "LFO.h"
-#include "ProcessorBase.h"
-#include "Utilities.h"
+#include "AllpassGraph.h"
 
-class GardnerSmallRoom : public ReverbProcessorBase
+class GardnerSmallRoom : public AllpassGraphReverb
 {
   public:
     GardnerSmallRoom();
 
     ~GardnerSmallRoom() override;
-
-    void prepare(const juce::dsp::ProcessSpec& spec) override;
-
-    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override;
-
-    void reset() override;
-
-    ReverbProcessorParameters& getParameters() override;
-
-    void setParameters(const ReverbProcessorParameters& params) override;
-
-  private:
-    // parameter struct
-    ReverbProcessorParameters parameters;
-
-    juce::dsp::DelayLine<float> delay1{22050};
-    juce::dsp::DelayLine<float> delay2{22050};
-    juce::dsp::DelayLine<float> delay3{22050};
-    juce::dsp::DelayLine<float> delay4{22050};
-    juce::dsp::DelayLine<float> delay5{22050};
-    juce::dsp::DelayLine<float> delay6{22050};
-
-    juce::dsp::FirstOrderTPTFilter<float> dampingFilter;
-
-    OscillatorParameters lfoParameters;
-    SignalGenData lfoOutput;
-    std::vector<LFO> lfo;
-
-    float allpassOutputInner = 0;
-    float allpassOutputOuter = 0;
-    float feedforwardInner = 0;
-    float feedforwardOuter = 0;
-    float feedbackInner = 0;
-    float feedbackOuter = 0;
-    std::vector<float> channelFeedback{0, 0};
-    std::vector<float> channelOutput{0, 0};
-
-    std::vector<float> channelDelayOffset{0, 7};
-
-    int sampleRate = 44100;
 };
 
 //==============================================================================
-class GardnerMediumRoom : public ReverbProcessorBase
+class GardnerMediumRoom : public AllpassGraphReverb
 {
   public:
     GardnerMediumRoom();
 
     ~GardnerMediumRoom() override;
-
-    void prepare(const juce::dsp::ProcessSpec& spec) override;
-
-    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override;
-
-    void reset() override;
-
-    ReverbProcessorParameters& getParameters() override;
-
-    void setParameters(const ReverbProcessorParameters& params) override;
-
-  private:
-    // parameter struct
-    ReverbProcessorParameters parameters;
-
-    juce::dsp::DelayLine<float> delay1{22050};
-    juce::dsp::DelayLine<float> delay2{22050};
-    juce::dsp::DelayLine<float> delay3{22050};
-    juce::dsp::DelayLine<float> delay4{22050};
-    juce::dsp::DelayLine<float> delay5{22050};
-    juce::dsp::DelayLine<float> delay6{22050};
-    juce::dsp::DelayLine<float> delay7{22050};
-    juce::dsp::DelayLine<float> delay8{22050};
-    juce::dsp::DelayLine<float> delay9{22050};
-    juce::dsp::DelayLine<float> delay10{22050};
-
-    juce::dsp::FirstOrderTPTFilter<float> dampingFilter;
-
-    OscillatorParameters lfoParameters;
-    SignalGenData lfoOutput;
-    std::vector<LFO> lfo;
-
-    float allpassOutputInner = 0;
-    float allpassOutputOuter = 0;
-    float feedforwardInner = 0;
-    float feedforwardOuter = 0;
-    float feedbackInner = 0;
-    float feedbackOuter = 0;
-    std::vector<float> channelFeedback{0, 0};
-    std::vector<float> channelOutput{0, 0};
-
-    std::vector<float> channelDelayOffset{0, 15};
-
-    int sampleRate = 44100;
 };
 
 //==============================================================================
-class GardnerLargeRoom : public ReverbProcessorBase
+class GardnerLargeRoom : public AllpassGraphReverb
 {
   public:
     GardnerLargeRoom();
 
     ~GardnerLargeRoom() override;
-
-    void prepare(const juce::dsp::ProcessSpec& spec) override;
-
-    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override;
-
-    void reset() override;
-
-    ReverbProcessorParameters& getParameters() override;
-
-    void setParameters(const ReverbProcessorParameters& params) override;
-
-  private:
-    // parameter struct
-    ReverbProcessorParameters parameters;
-
-    juce::dsp::DelayLine<float> delay1{22050};
-    juce::dsp::DelayLine<float> delay2{22050};
-    juce::dsp::DelayLine<float> delay3{22050};
-    juce::dsp::DelayLine<float> delay4{22050};
-    juce::dsp::DelayLine<float> delay5{22050};
-    juce::dsp::DelayLine<float> delay6{22050};
-    juce::dsp::DelayLine<float> delay7{22050};
-    juce::dsp::DelayLine<float> delay8{22050};
-    juce::dsp::DelayLine<float> delay9{22050};
-    juce::dsp::DelayLine<float> delay10{22050};
-    juce::dsp::DelayLine<float> delay11{22050};
-
-    juce::dsp::FirstOrderTPTFilter<float> dampingFilter;
-
-    OscillatorParameters lfoParameters;
-    SignalGenData lfoOutput;
-    std::vector<LFO> lfo;
-
-    float allpassOutputInner = 0;
-    float allpassOutputOuter = 0;
-    float feedforwardInner = 0;
-    float feedforwardOuter = 0;
-    float feedbackInner = 0;
-    float feedbackOuter = 0;
-    std::vector<float> channelFeedback{0, 0};
-    std::vector<float> channelOutput{0, 0};
-
-    std::vector<float> channelDelayOffset{0, 23};
-
-    int sampleRate = 44100;
 };
 
 // class GardnerSmallRoom : public ProcessorBase
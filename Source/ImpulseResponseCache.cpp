@@ -0,0 +1,182 @@
+// Persistent cache of captured impulse responses, stored as memory-mappable files
+
+#include "ImpulseResponseCache.h"
+
+namespace
+{
+const char fileMagic[4] = {'R', 'S', 'I', 'R'};
+const juce::String fileExtension = ".rsir";
+
+// 64-bit FNV-1a
+struct KeyHasher
+{
+    void add(const void* data, size_t numBytes)
+    {
+        auto* bytes = static_cast<const juce::uint8*>(data);
+        for (size_t i = 0; i < numBytes; ++i)
+            hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+
+    template <typename Type> void add(Type value)
+    {
+        add(&value, sizeof(value));
+    }
+
+    juce::uint64 hash = 0xcbf29ce484222325ull;
+};
+} // namespace
+
+ImpulseResponseCache::ImpulseResponseCache(const juce::File& cacheDirectory, const juce::String& pluginVersion)
+    : directory(cacheDirectory), version(pluginVersion)
+{
+}
+
+ImpulseResponseCache::~ImpulseResponseCache() = default;
+
+juce::File ImpulseResponseCache::getDefaultDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("RSAlgorithmicVerb")
+        .getChildFile("IRCache");
+}
+
+bool ImpulseResponseCache::load(const ImpulseResponseSettings& settings,
+                                std::vector<juce::AudioBuffer<float>>& impulseResponses)
+{
+    auto key = getKey(settings);
+    auto file = getFile(key);
+    if (!file.existsAsFile())
+        return false;
+
+    juce::MemoryMappedFile mappedFile(file, juce::MemoryMappedFile::readOnly);
+    if (mappedFile.getData() == nullptr || mappedFile.getSize() < sizeof(FileHeader))
+        return false;
+
+    FileHeader header;
+    std::memcpy(&header, mappedFile.getData(), sizeof(header));
+
+    // the key is checked too, in case two settings ever hash to the same file name
+    if (std::memcmp(header.magic, fileMagic, sizeof(fileMagic)) != 0 || header.formatVersion != formatVersion ||
+        header.key != key || header.numInputChannels != settings.numChannels ||
+        header.numOutputChannels != settings.numChannels || header.numSamples <= 0)
+        return false;
+
+    auto channelBytes = static_cast<size_t>(header.numSamples) * sizeof(float);
+    auto numBlocks = static_cast<size_t>(header.numInputChannels) * static_cast<size_t>(header.numOutputChannels);
+    if (mappedFile.getSize() != sizeof(FileHeader) + numBlocks * channelBytes)
+        return false;
+
+    auto* samples = static_cast<const char*>(mappedFile.getData()) + sizeof(FileHeader);
+
+    impulseResponses.clear();
+    for (int inputChannel = 0; inputChannel < header.numInputChannels; ++inputChannel)
+    {
+        juce::AudioBuffer<float> impulseResponse(header.numOutputChannels, header.numSamples);
+        for (int channel = 0; channel < header.numOutputChannels; ++channel)
+        {
+            std::memcpy(impulseResponse.getWritePointer(channel), samples, channelBytes);
+            samples += channelBytes;
+        }
+
+        impulseResponses.push_back(std::move(impulseResponse));
+    }
+
+    // keeps entries in use from being pruned
+    file.setLastAccessTime(juce::Time::getCurrentTime());
+
+    return true;
+}
+
+bool ImpulseResponseCache::store(const ImpulseResponseSettings& settings,
+                                 const std::vector<juce::AudioBuffer<float>>& impulseResponses)
+{
+    if (impulseResponses.empty() || directory.createDirectory().failed())
+        return false;
+
+    FileHeader header{};
+    std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.formatVersion = formatVersion;
+    header.key = getKey(settings);
+    header.numInputChannels = static_cast<juce::int32>(impulseResponses.size());
+    header.numOutputChannels = impulseResponses.front().getNumChannels();
+    header.numSamples = impulseResponses.front().getNumSamples();
+
+    juce::TemporaryFile temporaryFile(getFile(header.key));
+    {
+        juce::FileOutputStream stream(temporaryFile.getFile());
+        if (!stream.openedOk() || !stream.write(&header, sizeof(header)))
+            return false;
+
+        for (const auto& impulseResponse : impulseResponses)
+        {
+            if (impulseResponse.getNumChannels() != header.numOutputChannels ||
+                impulseResponse.getNumSamples() != header.numSamples)
+                return false;
+
+            for (int channel = 0; channel < header.numOutputChannels; ++channel)
+                if (!stream.write(impulseResponse.getReadPointer(channel),
+                                  static_cast<size_t>(header.numSamples) * sizeof(float)))
+                    return false;
+        }
+
+        stream.flush();
+        if (stream.getStatus().failed())
+            return false;
+    }
+
+    if (!temporaryFile.overwriteTargetFileWithTemporary())
+        return false;
+
+    prune();
+    return true;
+}
+
+juce::uint64 ImpulseResponseCache::getKey(const ImpulseResponseSettings& settings) const
+{
+    // hashed field by field, so struct padding never ends up in the key
+    KeyHasher hasher;
+    hasher.add(formatVersion);
+    hasher.add(static_cast<juce::int32>(settings.algorithmIndex));
+    hasher.add(settings.parameters.damping);
+    hasher.add(settings.parameters.decayTime);
+    hasher.add(settings.parameters.diffusion);
+    hasher.add(settings.parameters.modDepth);
+    hasher.add(settings.parameters.modRate);
+    hasher.add(settings.parameters.roomSize);
+    hasher.add(settings.sampleRate);
+    hasher.add(static_cast<juce::int32>(settings.numChannels));
+    hasher.add(version.toRawUTF8(), version.getNumBytesAsUTF8());
+    return hasher.hash;
+}
+
+juce::File ImpulseResponseCache::getFile(juce::uint64 key) const
+{
+    return directory.getChildFile(juce::String::toHexString(static_cast<juce::int64>(key)).paddedLeft('0', 16) +
+                                  fileExtension);
+}
+
+void ImpulseResponseCache::prune()
+{
+    auto files = directory.findChildFiles(juce::File::findFiles, false, "*" + fileExtension);
+
+    juce::int64 totalBytes = 0;
+    for (const auto& file : files)
+        totalBytes += file.getSize();
+
+    if (totalBytes <= maxCacheBytes)
+        return;
+
+    std::sort(files.begin(), files.end(), [](const juce::File& a, const juce::File& b) {
+        return a.getLastAccessTime() < b.getLastAccessTime();
+    });
+
+    for (const auto& file : files)
+    {
+        if (totalBytes <= maxCacheBytes)
+            break;
+
+        auto size = file.getSize();
+        if (file.deleteFile())
+            totalBytes -= size;
+    }
+}
@@ -0,0 +1,66 @@
+// Persistent cache of captured impulse responses, stored as memory-mappable files
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "Utilities.h"
+
+// everything an impulse response depends on
+struct ImpulseResponseSettings
+{
+    bool operator==(const ImpulseResponseSettings& other) const
+    {
+        return algorithmIndex == other.algorithmIndex && parameters == other.parameters &&
+               sampleRate == other.sampleRate && numChannels == other.numChannels;
+    }
+
+    int algorithmIndex = -1;
+    ReverbProcessorParameters parameters;
+    double sampleRate = 0;
+    int numChannels = 0;
+};
+
+class ImpulseResponseCache
+{
+  public:
+    // pluginVersion is part of every key, so a new build never loads responses captured by an older one
+    ImpulseResponseCache(const juce::File& cacheDirectory, const juce::String& pluginVersion);
+
+    ~ImpulseResponseCache();
+
+    // per-user cache folder shared by every instance of the plugin
+    static juce::File getDefaultDirectory();
+
+    // one impulse response per input channel, each with one channel per output; false if there's no valid entry
+    bool load(const ImpulseResponseSettings& settings, std::vector<juce::AudioBuffer<float>>& impulseResponses);
+
+    // writes to a temporary file first, so other instances never map a half-written entry
+    bool store(const ImpulseResponseSettings& settings, const std::vector<juce::AudioBuffer<float>>& impulseResponses);
+
+  private:
+    // written ahead of the samples, which follow as float32 planar blocks: input channel, then output channel
+    struct FileHeader
+    {
+        char magic[4];
+        juce::uint32 formatVersion;
+        juce::uint64 key;
+        juce::int32 numInputChannels;
+        juce::int32 numOutputChannels;
+        juce::int32 numSamples;
+        juce::int32 reserved;
+    };
+
+    juce::uint64 getKey(const ImpulseResponseSettings& settings) const;
+
+    juce::File getFile(juce::uint64 key) const;
+
+    // deletes the least recently used entries until the folder is back under maxCacheBytes
+    void prune();
+
+    static constexpr juce::uint32 formatVersion = 1;
+    static constexpr juce::int64 maxCacheBytes = 512 * 1024 * 1024;
+
+    juce::File directory;
+    juce::String version;
+};
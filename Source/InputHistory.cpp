@@ -0,0 +1,59 @@
+// The wet path's input, kept long enough for the pre-delay and every early reflection tap to read it at their offsets
+
+#include "InputHistory.h"
+
+void InputHistory::prepare(int numChannels, int maximumDelay, int newMaximumBlockSize)
+{
+    jassert(maximumDelay >= 0);
+
+    maximumBlockSize = newMaximumBlockSize;
+    // the older sample of the longest interpolated read, and the block it's read from
+    size = maximumDelay + 1 + maximumBlockSize;
+    history.setSize(numChannels, size);
+
+    reset();
+}
+
+void InputHistory::reset()
+{
+    history.clear();
+    writePosition = 0;
+    blockStart = 0;
+}
+
+int InputHistory::getNumChannels() const
+{
+    return history.getNumChannels();
+}
+
+void InputHistory::push(const juce::AudioBuffer<float>& input, int numSamples)
+{
+    jassert(numSamples <= maximumBlockSize);
+    numSamples = juce::jmin(numSamples, maximumBlockSize);
+
+    blockStart = writePosition;
+    int firstRun = juce::jmin(numSamples, size - writePosition);
+    for (int channel = 0; channel < juce::jmin(input.getNumChannels(), history.getNumChannels()); ++channel)
+    {
+        history.copyFrom(channel, writePosition, input, channel, 0, firstRun);
+        if (firstRun < numSamples)
+            history.copyFrom(channel, 0, input, channel, firstRun, numSamples - firstRun);
+    }
+    writePosition = (writePosition + numSamples) % size;
+}
+
+void InputHistory::read(juce::AudioBuffer<float>& output, float delay, int numSamples) const
+{
+    numSamples = juce::jmin(numSamples, maximumBlockSize);
+
+    // split as juce::dsp::DelayLine::setDelay() splits it
+    int wholeDelay = static_cast<int>(std::floor(delay));
+    float fraction = delay - static_cast<float>(wholeDelay);
+
+    for (int channel = 0; channel < juce::jmin(output.getNumChannels(), history.getNumChannels()); ++channel)
+    {
+        auto* channelData = output.getWritePointer(channel);
+        for (int sample = 0; sample < numSamples; ++sample)
+            channelData[sample] = getSample(channel, sample, wholeDelay, fraction);
+    }
+}
@@ -0,0 +1,48 @@
+// The wet path's input, kept long enough for the pre-delay and every early reflection tap to read it at their offsets
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*
+Pre-delay is an offset on everything after it, so rather than writing the input into a pre-delay line and the
+pre-delayed signal into the early reflections' line, it's written here once per block and both read it: the reverb's
+input at the pre-delay, and each early tap at the pre-delay plus its own delay. Reads are interpolated as
+juce::dsp::DelayLine's linear reads are, so with a steady pre-delay the output is the same as the two lines in a row.
+Nothing is allocated after prepare(), and blocks can be up to the prepared size.
+*/
+class InputHistory
+{
+  public:
+    // room for reads up to maximumDelay samples behind any sample of a block of up to maximumBlockSize
+    void prepare(int numChannels, int maximumDelay, int maximumBlockSize);
+
+    void reset();
+
+    int getNumChannels() const;
+
+    // appends the block; reads until the next push are relative to its samples
+    void push(const juce::AudioBuffer<float>& input, int numSamples);
+
+    // wholeDelay + fraction samples before sampleInBlock of the last block pushed, interpolated towards the older of
+    // the two samples either side
+    float getSample(int channel, int sampleInBlock, int wholeDelay, float fraction) const
+    {
+        const float* data = history.getReadPointer(channel);
+
+        int index = blockStart + sampleInBlock - wholeDelay;
+        index += index < 0 ? size : (index >= size ? -size : 0);
+        float newer = data[index];
+        return newer + fraction * (data[index == 0 ? size - 1 : index - 1] - newer);
+    }
+
+    // replaces each channel of output with the last block pushed, delayed by delay samples
+    void read(juce::AudioBuffer<float>& output, float delay, int numSamples) const;
+
+  private:
+    juce::AudioBuffer<float> history;
+    int size = 0;
+    int maximumBlockSize = 0;
+    int writePosition = 0;
+    int blockStart = 0;
+};
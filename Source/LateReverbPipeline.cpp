@@ -0,0 +1,157 @@
+// Runs the late reverb a block behind the rest of the wet path, on a worker thread
+
+#include "LateReverbPipeline.h"
+
+LateReverbPipeline::LateReverbPipeline() : juce::Thread("RSAlgorithmicVerb late reverb")
+{
+}
+
+LateReverbPipeline::~LateReverbPipeline()
+{
+    release();
+}
+
+void LateReverbPipeline::setLateStage(LateStage newLateStage)
+{
+    lateStage = std::move(newLateStage);
+}
+
+void LateReverbPipeline::prepare(int maxChannels, int blockSize)
+{
+    finish();
+
+    latencySamples = blockSize;
+    numChannels = maxChannels;
+
+    // room for a block of input beyond the one waiting, and for two blocks of output, the most either holds
+    inputFifo.setSize(maxChannels, 2 * blockSize);
+    outputFifo.setSize(maxChannels, 2 * blockSize);
+    jobBuffer.setSize(maxChannels, blockSize);
+
+    reset();
+
+    if (!isThreadRunning())
+        startThread(juce::Thread::Priority::highest);
+}
+
+void LateReverbPipeline::release()
+{
+    finish();
+
+    signalThreadShouldExit();
+    jobSignal.notify();
+    stopThread(4000);
+}
+
+void LateReverbPipeline::reset()
+{
+    jassert(!jobInFlight);
+
+    inputFifo.clear();
+    outputFifo.clear();
+    numInput = 0;
+    numOutput = latencySamples;
+}
+
+int LateReverbPipeline::getLatencySamples() const
+{
+    return latencySamples;
+}
+
+void LateReverbPipeline::finish()
+{
+    if (!jobInFlight)
+        return;
+
+    // the worker started on the block before the early stage ran, so it's usually done or nearly
+    while (jobReady.load())
+        juce::Thread::yield();
+
+    jobInFlight = false;
+    addJobOutput();
+}
+
+void LateReverbPipeline::process(juce::AudioBuffer<float>& buffer)
+{
+    // the layout only changes with the algorithm, which empties the reverb anyway
+    if (buffer.getNumChannels() != jobBuffer.getNumChannels())
+    {
+        finish();
+        jassert(buffer.getNumChannels() <= numChannels);
+        inputFifo.setSize(buffer.getNumChannels(), 2 * latencySamples, false, false, true);
+        outputFifo.setSize(buffer.getNumChannels(), 2 * latencySamples, false, false, true);
+        jobBuffer.setSize(buffer.getNumChannels(), latencySamples, false, false, true);
+        reset();
+    }
+
+    // blocks longer than the pipeline's go through it a piece at a time
+    for (int start = 0; start < buffer.getNumSamples(); start += latencySamples)
+    {
+        int numSamples = juce::jmin(latencySamples, buffer.getNumSamples() - start);
+
+        finish();
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            inputFifo.copyFrom(channel, numInput, buffer, channel, start, numSamples);
+        numInput += numSamples;
+
+        // the output and the input waiting add up to a block more than is being played, so if the output is short
+        // there's a full block of input to make it up from
+        while (numOutput < numSamples)
+        {
+            takeInputBlock();
+            lateStage(jobBuffer);
+            addJobOutput();
+        }
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            buffer.copyFrom(channel, start, outputFifo, channel, 0, numSamples);
+            auto* output = outputFifo.getWritePointer(channel);
+            std::copy(output + numSamples, output + numOutput, output);
+        }
+        numOutput -= numSamples;
+
+        if (numInput >= latencySamples)
+        {
+            takeInputBlock();
+            jobInFlight = true;
+            jobReady.store(true);
+            jobSignal.notify();
+        }
+    }
+}
+
+void LateReverbPipeline::run()
+{
+    // the audio thread's denormal handling doesn't carry over to other threads
+    juce::ScopedNoDenormals noDenormals;
+
+    while (!threadShouldExit())
+    {
+        jobSignal.waitUntil([this] { return jobReady.load() || threadShouldExit(); });
+        if (!jobReady.load())
+            continue;
+
+        lateStage(jobBuffer);
+        jobReady.store(false);
+    }
+}
+
+void LateReverbPipeline::takeInputBlock()
+{
+    for (int channel = 0; channel < jobBuffer.getNumChannels(); ++channel)
+    {
+        jobBuffer.copyFrom(channel, 0, inputFifo, channel, 0, latencySamples);
+        auto* input = inputFifo.getWritePointer(channel);
+        std::copy(input + latencySamples, input + numInput, input);
+    }
+    numInput -= latencySamples;
+}
+
+void LateReverbPipeline::addJobOutput()
+{
+    for (int channel = 0; channel < jobBuffer.getNumChannels(); ++channel)
+        outputFifo.copyFrom(channel, numOutput, jobBuffer, channel, 0, latencySamples);
+    numOutput += latencySamples;
+}
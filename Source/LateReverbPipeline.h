@@ -0,0 +1,69 @@
+// Runs the late reverb a block behind the rest of the wet path, on a worker thread
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "WorkerSignal.h"
+
+/*
+The late reverb works on fixed blocks of getLatencySamples() samples. Each block is handed to the worker once the early
+stage has filled it, and its output is played a block later, so the worker runs the late reverb for one block while
+the audio thread runs the filters and early reflections for the next. The output starts with a block of silence, so
+the delay is the same whatever size of blocks the host sends: if a smaller block leaves the worker's output short, the
+next block is run on the audio thread instead.
+*/
+class LateReverbPipeline : private juce::Thread
+{
+  public:
+    using LateStage = std::function<void(juce::AudioBuffer<float>&)>;
+
+    LateReverbPipeline();
+
+    ~LateReverbPipeline() override;
+
+    // processes a block in place; on the worker, or on the audio thread when the worker is behind
+    void setLateStage(LateStage newLateStage);
+
+    // starts the worker if it isn't running, and empties the pipeline; not on the audio thread
+    void prepare(int maxChannels, int blockSize);
+
+    void release();
+
+    // empties the pipeline; only once finish() has returned
+    void reset();
+
+    int getLatencySamples() const;
+
+    // waits for the block on the worker; anything the late stage uses can be changed once this returns
+    void finish();
+
+    // swaps the buffer's samples, the late stage's input, for its output from getLatencySamples() earlier, then hands
+    // the worker the next block if there is a full one
+    void process(juce::AudioBuffer<float>& buffer);
+
+  private:
+    void run() override;
+
+    // moves the oldest block of input into jobBuffer
+    void takeInputBlock();
+
+    void addJobOutput();
+
+    LateStage lateStage;
+
+    int latencySamples = 0;
+    int numChannels = 0;
+
+    // input waiting for a full block, and output waiting to be played; each block's first numInput/numOutput samples
+    juce::AudioBuffer<float> inputFifo;
+    juce::AudioBuffer<float> outputFifo;
+    int numInput = 0;
+    int numOutput = 0;
+
+    // the block being processed; only the worker touches it while jobReady is set
+    juce::AudioBuffer<float> jobBuffer;
+    bool jobInFlight = false;
+    std::atomic<bool> jobReady{false};
+    WorkerSignal jobSignal;
+};
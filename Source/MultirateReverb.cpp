@@ -0,0 +1,329 @@
+// Runs a reverb at a half or a quarter of the host sample rate, between polyphase halfband filters
+
+#include "MultirateReverb.h"
+
+namespace
+{
+// zeroth-order modified Bessel function of the first kind, for the Kaiser window
+double besselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 32; ++k)
+    {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+} // namespace
+
+HalfbandStage::HalfbandStage()
+{
+    // Kaiser-windowed sinc with its cutoff at a quarter of the rate. coefficients[k] is the tap 2k - centre from the
+    // centre, which is always an odd distance; the taps an even distance away are zero
+    const int centre = numTaps - 1;
+    double sum = 0.0;
+    for (int k = 0; k < numTaps; ++k)
+    {
+        double distance = 2.0 * k - centre;
+        double sinc = std::sin(juce::MathConstants<double>::pi * distance / 2.0) /
+                      (juce::MathConstants<double>::pi * distance);
+        double position = distance / centre;
+        double window = besselI0(kaiserBeta * std::sqrt(std::max(0.0, 1.0 - position * position))) /
+                        besselI0(kaiserBeta);
+
+        coefficients[static_cast<size_t>(k)] = static_cast<float>(sinc * window);
+        sum += sinc * window;
+    }
+
+    // unity gain at DC, with the centre tap's 1/2 as the other half
+    for (auto& coefficient : coefficients)
+        coefficient = static_cast<float>(coefficient * 0.5 / sum);
+}
+
+void HalfbandStage::prepare(int numChannels, int maxBlockSize)
+{
+    int maxOutputs = maxBlockSize / 2 + 2;
+
+    oddSamples.assign(static_cast<size_t>(numChannels),
+                      std::vector<float>(static_cast<size_t>(numTaps - 1 + maxOutputs)));
+    evenSamples.assign(static_cast<size_t>(numChannels),
+                       std::vector<float>(static_cast<size_t>(numTaps / 2 - 1 + maxOutputs)));
+    interpolatorInput.assign(static_cast<size_t>(numChannels),
+                             std::vector<float>(static_cast<size_t>(numTaps - 1 + maxBlockSize)));
+    pendingSample.assign(static_cast<size_t>(numChannels), 0.0f);
+
+    reset();
+}
+
+void HalfbandStage::reset()
+{
+    for (auto* samples : {&oddSamples, &evenSamples, &interpolatorInput})
+        for (auto& channelSamples : *samples)
+            std::fill(channelSamples.begin(), channelSamples.end(), 0.0f);
+
+    std::fill(pendingSample.begin(), pendingSample.end(), 0.0f);
+    hasPendingSample = false;
+}
+
+int HalfbandStage::decimate(const juce::AudioBuffer<float>& input, int numSamples, juce::AudioBuffer<float>& output)
+{
+    constexpr int oddHistory = numTaps - 1;
+    constexpr int evenHistory = numTaps / 2 - 1;
+
+    int numOutputs = 0;
+    bool endsOnEvenSample = false;
+
+    for (int channel = 0; channel < input.getNumChannels(); ++channel)
+    {
+        const float* in = input.getReadPointer(channel);
+        float* odd = oddSamples[static_cast<size_t>(channel)].data() + oddHistory;
+        float* even = evenSamples[static_cast<size_t>(channel)].data() + evenHistory;
+
+        // split into the even- and odd-numbered samples; an output is due after each odd one
+        bool expectingOdd = hasPendingSample;
+        even[0] = pendingSample[static_cast<size_t>(channel)];
+        int count = 0;
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            if (expectingOdd)
+                odd[count++] = in[sample];
+            else
+                even[count] = in[sample];
+
+            expectingOdd = !expectingOdd;
+        }
+
+        pendingSample[static_cast<size_t>(channel)] = even[count];
+        numOutputs = count;
+        endsOnEvenSample = expectingOdd;
+
+        // the filter is symmetric, so the odd samples are summed in pairs before the multiply; the centre tap lands on
+        // an even sample
+        float* out = output.getWritePointer(channel);
+        for (int index = 0; index < count; ++index)
+        {
+            float sum = 0.5f * even[index - evenHistory];
+            for (int tap = 0; tap < numTaps / 2; ++tap)
+                sum += coefficients[static_cast<size_t>(tap)] * (odd[index - tap] + odd[index - (numTaps - 1 - tap)]);
+            out[index] = sum;
+        }
+
+        // keep the history for the next block
+        auto& oddChannel = oddSamples[static_cast<size_t>(channel)];
+        std::copy(oddChannel.begin() + count, oddChannel.begin() + count + oddHistory, oddChannel.begin());
+        auto& evenChannel = evenSamples[static_cast<size_t>(channel)];
+        std::copy(evenChannel.begin() + count, evenChannel.begin() + count + evenHistory, evenChannel.begin());
+    }
+
+    hasPendingSample = endsOnEvenSample;
+    return numOutputs;
+}
+
+void HalfbandStage::interpolate(const juce::AudioBuffer<float>& input, int numSamples,
+                                juce::AudioBuffer<float>& output, int outputOffset)
+{
+    constexpr int history = numTaps - 1;
+
+    for (int channel = 0; channel < input.getNumChannels(); ++channel)
+    {
+        auto& channelInput = interpolatorInput[static_cast<size_t>(channel)];
+        float* in = channelInput.data() + history;
+        std::copy(input.getReadPointer(channel), input.getReadPointer(channel) + numSamples, in);
+
+        // the zeros stuffed between the input samples halve the level, so the filter runs at twice the gain; the
+        // odd-numbered outputs only see the centre tap
+        float* out = output.getWritePointer(channel, outputOffset);
+        for (int index = 0; index < numSamples; ++index)
+        {
+            float sum = 0.0f;
+            for (int tap = 0; tap < numTaps / 2; ++tap)
+                sum += coefficients[static_cast<size_t>(tap)] * (in[index - tap] + in[index - (numTaps - 1 - tap)]);
+
+            out[2 * index] = 2.0f * sum;
+            out[2 * index + 1] = in[index - (numTaps / 2 - 1)];
+        }
+
+        std::copy(channelInput.begin() + numSamples, channelInput.begin() + numSamples + history, channelInput.begin());
+    }
+}
+
+//============================================================================
+
+MultirateReverb::MultirateReverb(std::unique_ptr<ReverbProcessorBase> processorToWrap, int rateFactor)
+    : processor(std::move(processorToWrap)), factor(rateFactor), numStages(rateFactor == 4 ? 2 : 1)
+{
+    jassert(processor != nullptr);
+    jassert(rateFactor == 2 || rateFactor == 4);
+
+    stages.resize(static_cast<size_t>(numStages));
+    stageBuffers.resize(static_cast<size_t>(numStages));
+}
+
+MultirateReverb::~MultirateReverb() = default;
+
+void MultirateReverb::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = spec.sampleRate;
+    maxBlockSize = static_cast<int>(spec.maximumBlockSize);
+    int numChannels = static_cast<int>(spec.numChannels);
+    int blockSize = static_cast<int>(spec.maximumBlockSize);
+
+    // stage i runs at the host rate over 2^i, and its buffer holds what it decimates to
+    for (int stage = 0; stage < numStages; ++stage)
+    {
+        stages[static_cast<size_t>(stage)].prepare(numChannels, blockSize);
+        blockSize = blockSize / 2 + 1;
+        // room for the interpolated output of the stage below on the way back up
+        stageBuffers[static_cast<size_t>(stage)].setSize(numChannels, 2 * blockSize + 2);
+    }
+
+    outputBuffer.setSize(numChannels, static_cast<int>(spec.maximumBlockSize) + 2 * factor);
+
+    // the wrapped algorithm's lengths in samples are divided by the factor, so they last as long as at the host rate
+    juce::dsp::ProcessSpec internalSpec = spec;
+    internalSpec.sampleRate = spec.sampleRate / factor;
+    internalSpec.maximumBlockSize = static_cast<juce::uint32>(blockSize);
+    processor->setDelayScale(delayScale / static_cast<float>(factor));
+    processor->prepare(internalSpec);
+
+    reset();
+}
+
+void MultirateReverb::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    int numSamples = buffer.getNumSamples();
+    jassert(numSamples <= maxBlockSize);
+
+    // down
+    const juce::AudioBuffer<float>* stageInput = &buffer;
+    int numStageSamples = numSamples;
+    for (int stage = 0; stage < numStages; ++stage)
+    {
+        auto& stageOutput = stageBuffers[static_cast<size_t>(stage)];
+        numStageSamples = stages[static_cast<size_t>(stage)].decimate(*stageInput, numStageSamples, stageOutput);
+        stageInput = &stageOutput;
+    }
+
+    // the reverb sees a buffer of exactly the samples this block decimated to, which may be none
+    auto& internalBuffer = stageBuffers.back();
+    int internalCapacity = internalBuffer.getNumSamples();
+    if (numStageSamples > 0)
+    {
+        internalBuffer.setSize(internalBuffer.getNumChannels(), numStageSamples, true, false, true);
+        processor->processBlock(internalBuffer, midiMessages);
+        internalBuffer.setSize(internalBuffer.getNumChannels(), internalCapacity, true, false, true);
+    }
+
+    // up; each stage's output overwrites the input it decimated, which is no longer needed
+    for (int stage = numStages - 1; stage > 0; --stage)
+    {
+        stages[static_cast<size_t>(stage)].interpolate(stageBuffers[static_cast<size_t>(stage)], numStageSamples,
+                                                       stageBuffers[static_cast<size_t>(stage - 1)], 0);
+        numStageSamples *= 2;
+    }
+    stages[0].interpolate(stageBuffers[0], numStageSamples, outputBuffer, numPendingOutputs);
+    numPendingOutputs += 2 * numStageSamples;
+
+    jassert(numPendingOutputs >= numSamples);
+
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        buffer.copyFrom(channel, 0, outputBuffer, channel, 0, numSamples);
+
+        float* pending = outputBuffer.getWritePointer(channel);
+        std::copy(pending + numSamples, pending + numPendingOutputs, pending);
+    }
+    numPendingOutputs -= numSamples;
+}
+
+void MultirateReverb::reset()
+{
+    for (auto& stage : stages)
+        stage.reset();
+
+    for (auto& stageBuffer : stageBuffers)
+        stageBuffer.clear();
+
+    outputBuffer.clear();
+    numPendingOutputs = factor - 1;
+
+    processor->reset();
+}
+
+ReverbProcessorParameters& MultirateReverb::getParameters()
+{
+    return processor->getParameters();
+}
+
+void MultirateReverb::setParameters(const ReverbProcessorParameters& params)
+{
+    processor->setParameters(params);
+}
+
+double MultirateReverb::getTailLengthSeconds()
+{
+    return processor->getTailLengthSeconds() + getLatencySamples(factor) / sampleRate;
+}
+
+bool MultirateReverb::isTimeInvariant()
+{
+    return processor->isTimeInvariant();
+}
+
+bool MultirateReverb::supportsFoaOutput()
+{
+    return processor->supportsFoaOutput();
+}
+
+void MultirateReverb::setChannelWorkers(ChannelWorkerPool* pool)
+{
+    processor->setChannelWorkers(pool);
+}
+
+int MultirateReverb::getNumQualityTiers()
+{
+    return processor->getNumQualityTiers();
+}
+
+void MultirateReverb::setQualityTier(int tier)
+{
+    ReverbProcessorBase::setQualityTier(tier);
+    processor->setQualityTier(tier);
+}
+
+juce::StringArray MultirateReverb::getRateNames()
+{
+    return {"Host Rate", "Half Rate", "Quarter Rate", "Auto"};
+}
+
+int MultirateReverb::getRateFactor(int rateChoice, double hostSampleRate)
+{
+    switch (rateChoice)
+    {
+    case 1:
+        return 2;
+    case 2:
+        return 4;
+    case 3:
+        // a little under 44.1 kHz, so 88.2 and 176.4 kHz count
+        if (hostSampleRate >= 4 * 44000.0)
+            return 4;
+        if (hostSampleRate >= 2 * 44000.0)
+            return 2;
+        return 1;
+    default:
+        return 1;
+    }
+}
+
+int MultirateReverb::getLatencySamples(int rateFactor)
+{
+    // each stage's delay is in samples at its own rate, plus the output that starts ahead
+    int latency = 0;
+    for (int stageRate = 1; stageRate < rateFactor; stageRate *= 2)
+        latency += HalfbandStage::getLatencySamples() * stageRate;
+
+    return latency + rateFactor - 1;
+}
@@ -0,0 +1,109 @@
+// Runs a reverb at a half or a quarter of the host sample rate, between polyphase halfband filters
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "ProcessorBase.h"
+#include "Utilities.h"
+
+/*
+One octave of decimation and interpolation through the same halfband lowpass. Every other coefficient of a halfband
+filter is zero apart from the centre one, which is 1/2, so each half-rate output of the decimator only filters the
+odd-numbered input samples, and every other output of the interpolator is just a delayed input sample.
+*/
+class HalfbandStage
+{
+  public:
+    HalfbandStage();
+
+    void prepare(int numChannels, int maxBlockSize);
+
+    void reset();
+
+    // writes one output for every two inputs to output, carrying an odd sample over to the next block; returns the
+    // number written
+    int decimate(const juce::AudioBuffer<float>& input, int numSamples, juce::AudioBuffer<float>& output);
+
+    // writes two outputs for every input to output, starting at outputOffset
+    void interpolate(const juce::AudioBuffer<float>& input, int numSamples, juce::AudioBuffer<float>& output,
+                     int outputOffset);
+
+    // delay through decimate() then interpolate(), in samples at the higher rate
+    static constexpr int getLatencySamples()
+    {
+        return 2 * (numTaps - 1) - 1;
+    }
+
+  private:
+    // nonzero coefficients besides the centre; the filter is 2 * numTaps - 1 long, with 80 dB of stopband rejection
+    // from 0.29 of the higher rate, so at 96 kHz everything up to about 20 kHz is kept and aliasing is inaudible
+    static constexpr int numTaps = 32;
+    static constexpr float kaiserBeta = 8.0f;
+
+    std::array<float, numTaps> coefficients{};
+
+    // each holds the history the filter needs, then this block's samples
+    std::vector<std::vector<float>> oddSamples, evenSamples, interpolatorInput;
+    std::vector<float> pendingSample;
+    bool hasPendingSample = false;
+};
+
+//============================================================================
+
+class MultirateReverb : public ReverbProcessorBase
+{
+  public:
+    // rateFactor is 2 or 4
+    MultirateReverb(std::unique_ptr<ReverbProcessorBase> processorToWrap, int rateFactor);
+
+    ~MultirateReverb() override;
+
+    void prepare(const juce::dsp::ProcessSpec& spec) override;
+
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override;
+
+    void reset() override;
+
+    ReverbProcessorParameters& getParameters() override;
+
+    void setParameters(const ReverbProcessorParameters& params) override;
+
+    double getTailLengthSeconds() override;
+
+    bool isTimeInvariant() override;
+
+    bool supportsFoaOutput() override;
+
+    void setChannelWorkers(ChannelWorkerPool* pool) override;
+
+    int getNumQualityTiers() override;
+
+    void setQualityTier(int tier) override;
+
+    // choice names for the internalRate parameter, in index order
+    static juce::StringArray getRateNames();
+
+    // 1, 2 or 4 for the internalRate choice at this host rate; Auto keeps the internal rate at 44.1 kHz or above
+    static int getRateFactor(int rateChoice, double hostSampleRate);
+
+    // delay the filters add at this factor, in host samples
+    static int getLatencySamples(int rateFactor);
+
+  private:
+    std::unique_ptr<ReverbProcessorBase> processor;
+    int factor;
+    int numStages;
+
+    std::vector<HalfbandStage> stages;
+    // input to each stage on the way down, then its output on the way up; the last is the one the reverb runs on
+    std::vector<juce::AudioBuffer<float>> stageBuffers;
+
+    // interpolated output not yet handed back; it starts factor - 1 samples ahead, so a block that doesn't end on a
+    // whole low-rate sample still has all its output
+    juce::AudioBuffer<float> outputBuffer;
+    int numPendingOutputs = 0;
+
+    double sampleRate = 44100.0;
+    int maxBlockSize = 0;
+};
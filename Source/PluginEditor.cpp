@@ -5,7 +5,8 @@
 
 RSAlgorithmicVerbAudioProcessorEditor::RSAlgorithmicVerbAudioProcessorEditor(RSAlgorithmicVerbAudioProcessor& p,
                                                                              juce::AudioProcessorValueTreeState& vts)
-    : AudioProcessorEditor(&p), audioProcessor(p), valueTreeState(vts)
+    : AudioProcessorEditor(&p), audioProcessor(p), valueTreeState(vts), telemetryView(p.getTelemetry()),
+      cpuMeterView(p.getCpuLoadMeter(), [&p] { return p.isProcessingIdle(); })
 {
     // labels
     roomSizeLabel.setText("Room Size", juce::dontSendNotification);
@@ -155,6 +156,10 @@ RSAlgorithmicVerbAudioProcessorEditor::RSAlgorithmicVerbAudioProcessorEditor(RSA
     addAndMakeVisible(dryWetMixSlider);
     dryWetMixAttachment.reset(new SliderAttachment(valueTreeState, "dryWetMix", dryWetMixSlider));
 
+    // profiling
+    addAndMakeVisible(telemetryView);
+    addAndMakeVisible(cpuMeterView);
+
     // interface style
     getLookAndFeel().setDefaultLookAndFeel(&grayBlueLookAndFeel);
 
@@ -280,4 +285,9 @@ void RSAlgorithmicVerbAudioProcessorEditor::resized()
     reverbMenuLabel.setBounds(getWidth() - menuWidth - textLabelWidth - 25, getHeight() - menuHeight - 45,
                               textLabelWidth, menuHeight);
     reverbMenuLabel.setJustificationType(juce::Justification::right);
+
+    // profiling, in the strip left of the menu
+    telemetryView.setBounds(25, getHeight() - 75, getWidth() - menuWidth - textLabelWidth - 75, 70);
+    // load meter, between the title and the version info
+    cpuMeterView.setBounds(400, 15, getWidth() - 800, 50);
 }
@@ -4,8 +4,10 @@
 
 #include <JuceHeader.h>
 
+#include "CpuMeterView.h"
 #include "GuiStyles.h"
 #include "PluginProcessor.h"
+#include "TelemetryView.h"
 
 class RSAlgorithmicVerbAudioProcessorEditor : public juce::AudioProcessorEditor
 {
@@ -110,6 +112,10 @@ class RSAlgorithmicVerbAudioProcessorEditor : public juce::AudioProcessorEditor
 
     std::unique_ptr<ComboBoxAttachment> reverbMenuAttachment;
 
+    // profiling
+    TelemetryView telemetryView;
+    CpuMeterView cpuMeterView;
+
     const int textBoxWidth = 70;
     const int textBoxHeight = 25;
     GrayBlueLookAndFeel grayBlueLookAndFeel;
@@ -57,12 +57,21 @@ RSAlgorithmicVerbAudioProcessor::RSAlgorithmicVerbAudioProcessor()
            std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{"dryWetMix", 1}, "Dry/Wet Mix", 0.0f, 1.0f,
                                                        0.35f),
            std::make_unique<juce::AudioParameterChoice>(
-               juce::ParameterID{"reverbType", 1}, "Reverb Type",
-               juce::StringArray{"DattorroPlate", "DattorroHall", "SmallRoom", "MediumRoom", "LargeRoom", "Freeverb",
-                                 "Anderson8xFDN", "circulant8xFDN", "Hadamard8xFDN", "Householder8xFDN",
-                                 "Constellation", "EventHorizon"},
-               0)})
+               juce::ParameterID{"reverbType", 1}, "Reverb Type", ProcessorFactory::getProcessorNames(), 0),
+           std::make_unique<juce::AudioParameterBool>(juce::ParameterID{"convolutionFastPath", 2},
+                                                      "Convolution Fast Path", false),
+           std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{"internalRate", 3}, "Internal Rate",
+                                                        MultirateReverb::getRateNames(), 0),
+           std::make_unique<juce::AudioParameterBool>(juce::ParameterID{"channelThreads", 4}, "Channel Threads",
+                                                      false),
+           std::make_unique<juce::AudioParameterBool>(juce::ParameterID{"pipelineLate", 5}, "Pipelined Late Reverb",
+                                                      false),
+           std::make_unique<juce::AudioParameterBool>(juce::ParameterID{"adaptiveQuality", 6}, "Adaptive Quality",
+                                                      false)})
 {
+    convolutionFastPath.setCache(std::make_unique<ImpulseResponseCache>(ImpulseResponseCache::getDefaultDirectory(),
+                                                                        JucePlugin_VersionString));
+    lateReverbPipeline.setLateStage([this](juce::AudioBuffer<float>& block) { processLateStage(block); });
 }
 
 RSAlgorithmicVerbAudioProcessor::~RSAlgorithmicVerbAudioProcessor()
@@ -104,7 +113,7 @@ bool RSAlgorithmicVerbAudioProcessor::isMidiEffect() const
 
 double RSAlgorithmicVerbAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return tailLengthSeconds;
 }
 
 int RSAlgorithmicVerbAudioProcessor::getNumPrograms()
@@ -134,33 +143,126 @@ void RSAlgorithmicVerbAudioProcessor::changeProgramName(int index, const juce::S
 //==============================================================================
 void RSAlgorithmicVerbAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
+    // the late reverb may still be on the last block before playback stopped
+    lateReverbPipeline.finish();
+
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = sampleRate;
     spec.maximumBlockSize = samplesPerBlock;
     spec.numChannels = getMainBusNumInputChannels();
 
-    // pre-delay
-    preDelay.prepare(spec);
-    preDelay.setMaximumDelayInSamples((sampleRate / 4) + samplesPerBlock);
+    // surround; everything on the wet path up to the reverb sees the stereo core
+    usingSurroundSpread = spec.numChannels > 2;
+    juce::dsp::ProcessSpec coreSpec = spec;
+    if (usingSurroundSpread)
+    {
+        coreSpec.numChannels = 2;
+        coreBuffer.setSize(2, samplesPerBlock);
+        surroundSpread.prepare(getChannelLayoutOfBus(false, 0), sampleRate);
+    }
+    usingFoa = SurroundSpread::isFoa(getChannelLayoutOfBus(false, 0));
+    if (usingFoa)
+        foaBuffer.setSize(FoaTapEncoder::numChannels, samplesPerBlock);
+
+    // pre-delay and early reflection taps, from one history; the early reflections are prepared with it below
+    auto preDelayRange =
+        static_cast<juce::RangedAudioParameter*>(parameters.getParameter("preDelay"))->getNormalisableRange();
+    int maximumPreDelay = static_cast<int>(std::ceil(preDelayRange.end * sampleRate / 1000));
+    inputHistory.prepare(static_cast<int>(coreSpec.numChannels),
+                         maximumPreDelay + earlyReflections.getMaximumTapDelay(), samplesPerBlock);
+    earlyReflections.setInputHistory(&inputHistory);
     // low-cut
-    lowCutFilter.prepare(spec);
+    lowCutFilter.prepare(coreSpec);
     lowCutFilter.reset();
     *lowCutFilter.state = *juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 20.0f);
     // high-cut
-    highCutFilter.prepare(spec);
+    highCutFilter.prepare(coreSpec);
     highCutFilter.reset();
     *highCutFilter.state = *juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, 20000.0f);
     // early reflections
-    earlyReflections.prepare(spec);
-    // mixers
-    earlyLevelMixer.prepare(spec);
-    earlyLevelMixer.reset();
-    dryWetMixer.prepare(spec);
-    dryWetMixer.reset();
+    earlyReflections.prepare(coreSpec);
+    // mixer; the dry/wet mix is over every channel of the layout, the early/dry mix over the core
+    mixer.prepare(spec, static_cast<int>(coreSpec.numChannels));
+    // reverb; otherwise only prepared when the algorithm changes, so catch sample rate and layout changes here
+    if (reverbProcessor != nullptr)
+        prepareReverbProcessor(coreSpec);
+    // creates the algorithm if there isn't one yet, so the tail length is known before the first block
+    updateReverbProcessor(coreSpec);
+    // channel threads; one per reverb channel beyond the first, which stays on the audio thread. They sleep while the
+    // parameter is off, and are started here so that turning it on never starts a thread on the audio thread
+    channelWorkers.prepare(static_cast<int>(coreSpec.numChannels) - 1);
+    // late reverb pipeline; its blocks are the host's, up to the most the mixer can delay the dry signal by
+    lateReverbPipeline.prepare(usingFoa ? FoaTapEncoder::numChannels : static_cast<int>(coreSpec.numChannels),
+                               juce::jmin(samplesPerBlock, maximumPipelineLatency));
+    setPipelineLate(parameters.getRawParameterValue("pipelineLate")->load() >= 0.5f);
+    // convolution fast path; drops any captured impulse response, and starts on the algorithm
+    convolutionFastPath.prepare(coreSpec);
+    usingConvolution = false;
+    convolutionFade.prepare(sampleRate);
+    convolutionFade.setOn(false);
+    convolutionFade.finishFade();
+    convolutionTail = {};
+    algorithmTail = {};
+    crossfadeBuffer.setSize(static_cast<int>(coreSpec.numChannels), samplesPerBlock);
+    // idle detection
+    silentSamples = 0;
+    processingIdle = false;
+    // load meter, and the quality governor it drives
+    cpuLoadMeter.prepare(sampleRate);
+    qualityGovernor.prepare(sampleRate);
 }
 
 void RSAlgorithmicVerbAudioProcessor::releaseResources()
 {
+    channelWorkers.release();
+    lateReverbPipeline.release();
+}
+
+void RSAlgorithmicVerbAudioProcessor::reset()
+{
+    resetSignalState();
+    mixer.reset();
+
+    silentSamples = 0;
+    processingIdle = false;
+}
+
+void RSAlgorithmicVerbAudioProcessor::resetSignalState()
+{
+    lateReverbPipeline.finish();
+    lateReverbPipeline.reset();
+
+    inputHistory.reset();
+    lowCutFilter.reset();
+    highCutFilter.reset();
+    earlyReflections.reset();
+
+    if (reverbProcessor != nullptr)
+        reverbProcessor->reset();
+
+    convolutionFastPath.reset();
+    convolutionFade.finishFade();
+    convolutionTail = {};
+    algorithmTail = {};
+    surroundSpread.reset();
+
+    // the late stage doesn't run again until there's input, so its last load no longer says anything
+    cpuLoadMeter.resetLateStageLoad();
+}
+
+bool RSAlgorithmicVerbAudioProcessor::isProcessingIdle() const
+{
+    return processingIdle;
+}
+
+Telemetry& RSAlgorithmicVerbAudioProcessor::getTelemetry()
+{
+    return telemetry;
+}
+
+CpuLoadMeter& RSAlgorithmicVerbAudioProcessor::getCpuLoadMeter()
+{
+    return cpuLoadMeter;
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -171,11 +273,10 @@ bool RSAlgorithmicVerbAudioProcessor::isBusesLayoutSupported(const BusesLayout&
     return true;
 #else
     // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
+    // Mono and stereo, and named surround and immersive layouts up to 7.1.4, which share one stereo reverb.
     // Some plugin hosts, such as certain GarageBand versions, will only
     // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono() &&
-        layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    if (!SurroundSpread::isLayoutSupported(layouts.getMainOutputChannelSet()))
         return false;
 
     // This checks if the input layout matches the output layout
@@ -192,7 +293,10 @@ bool RSAlgorithmicVerbAudioProcessor::isBusesLayoutSupported(const BusesLayout&
 void RSAlgorithmicVerbAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     //============ housekeeping ============
+    // the only flush-to-zero scope on the audio thread; the algorithms rely on it (see Denormals.h)
     juce::ScopedNoDenormals noDenormals;
+    CpuLoadMeter::ScopedCallback cpuLoadCallback(cpuLoadMeter, buffer.getNumSamples());
+    Telemetry::ScopedBlock telemetryBlock(telemetry, buffer.getNumSamples());
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -202,31 +306,104 @@ void RSAlgorithmicVerbAudioProcessor::processBlock(juce::AudioBuffer<float>& buf
     //    auto numChannels = buffer.getNumChannels();
     //    auto numSamples = buffer.getNumSamples();
 
+    //================ idle detection ================
+    // any input wakes the reverb straight away; its state was cleared on going idle, so it starts from silence
+    bool inputSilent = buffer.getMagnitude(0, buffer.getNumSamples()) < silenceThreshold;
+    if (!inputSilent)
+    {
+        silentSamples = 0;
+        processingIdle = false;
+    }
+
     //================ mixer settings + dry ================
     // settings to mix btwn early/dry into reverb processor
-    earlyLevelMixer.setWetMixProportion(parameters.getRawParameterValue("earlyLateMix")->load());
+    mixer.setEarlyMixProportion(parameters.getRawParameterValue("earlyLateMix")->load());
     // dry/wet mixer settings
-    dryWetMixer.setWetMixProportion(parameters.getRawParameterValue("dryWetMix")->load());
+    mixer.setWetMixProportion(parameters.getRawParameterValue("dryWetMix")->load());
+    // switching the late reverb pipeline on or off empties it, and changes the latency and the dry path's delay
+    bool shouldPipelineLate = parameters.getRawParameterValue("pipelineLate")->load() >= 0.5f;
+    if (shouldPipelineLate != pipelineLate)
+    {
+        lateReverbPipeline.finish();
+        lateReverbPipeline.reset();
+        setPipelineLate(shouldPipelineLate);
+    }
+
+    {
+        Telemetry::ScopedProbe probe(telemetry, Telemetry::Stage::mixers);
+        mixer.pushDrySamples(buffer, buffer.getNumSamples());
+    }
+
+    //=============== reverb processor ================
+    juce::dsp::ProcessSpec reverbSpec;
+    reverbSpec.sampleRate = getSampleRate();
+    // the prepared size rather than this block's, since an algorithm created here keeps it as its maximum
+    reverbSpec.maximumBlockSize = static_cast<juce::uint32>(juce::jmax(getBlockSize(), buffer.getNumSamples()));
+    reverbSpec.numChannels = usingSurroundSpread ? 2 : buffer.getNumChannels();
+
+    // adaptive quality, judged on the last callback or the last late stage, whichever came closer to its budget, as a
+    // pipelined late stage misses its deadline without the callback showing it; rendering offline there's no deadline,
+    // so it stays at the top tier
+    if (parameters.getRawParameterValue("adaptiveQuality")->load() >= 0.5f && !isNonRealtime())
+        qualityGovernor.update(std::max(cpuLoadMeter.getLastLoad(), cpuLoadMeter.getLastLateStageLoad()),
+                               buffer.getNumSamples(),
+                               reverbProcessor != nullptr ? reverbProcessor->getNumQualityTiers() : 1);
+    else
+        qualityGovernor.reset();
+
+    // keeps the algorithm and tail length current even while idle; when pipelined, the late reverb may still be running
+    // on the last block, so that waits until the early stage below is done
+    if (!pipelineLate || processingIdle)
+        updateReverbProcessor(reverbSpec);
+
+    if (processingIdle)
+    {
+        // nothing to hear from the wet path, so skip the filters, early reflections and reverb; the mixer still runs so
+        // its smoothing carries on
+        Telemetry::ScopedProbe probe(telemetry, Telemetry::Stage::mixers);
+        buffer.clear();
+        mixer.mixWetSamples(buffer, buffer.getNumSamples());
+        return;
+    }
 
-    juce::dsp::AudioBlock<float> dryBlock{buffer};
-    earlyLevelMixer.pushDrySamples(dryBlock);
-    dryWetMixer.pushDrySamples(dryBlock);
+    // in surround layouts everything from here to the reverb runs once, on the stereo downmix; elsewhere the mixer
+    // already has the core's dry signal, from the input
+    auto& wetBuffer = usingSurroundSpread ? coreBuffer : buffer;
+    if (usingSurroundSpread)
+    {
+        Telemetry::ScopedProbe probe(telemetry, Telemetry::Stage::mixers);
+        coreBuffer.setSize(2, buffer.getNumSamples(), false, false, true);
+        surroundSpread.downmix(buffer, coreBuffer, buffer.getNumSamples());
+        mixer.pushCoreDrySamples(coreBuffer, buffer.getNumSamples());
+    }
 
     //================ filters, pre-delay ================
     // context
-    juce::dsp::AudioBlock<float> preBlock{buffer};
+    juce::dsp::AudioBlock<float> preBlock{wetBuffer};
 
     // filters
     *lowCutFilter.state = *juce::dsp::IIR::Coefficients<float>::makeHighPass(
         getSampleRate(), parameters.getRawParameterValue("lowCut")->load());
     *highCutFilter.state = *juce::dsp::IIR::Coefficients<float>::makeLowPass(
         getSampleRate(), parameters.getRawParameterValue("highCut")->load());
-    lowCutFilter.process(juce::dsp::ProcessContextReplacing<float>(preBlock));
-    highCutFilter.process(juce::dsp::ProcessContextReplacing<float>(preBlock));
+    {
+        Telemetry::ScopedProbe probe(telemetry, Telemetry::Stage::filters);
+        lowCutFilter.process(juce::dsp::ProcessContextReplacing<float>(preBlock));
+        highCutFilter.process(juce::dsp::ProcessContextReplacing<float>(preBlock));
+    }
+    telemetry.countNearSubnormals(Telemetry::Stage::filters, wetBuffer, buffer.getNumSamples());
 
-    // pre-delay
-    preDelay.setDelay(parameters.getRawParameterValue("preDelay")->load() * (getSampleRate() / 1000));
-    preDelay.process(juce::dsp::ProcessContextReplacing<float>(preBlock));
+    // pre-delay, less the latency of running the reverb at a lower rate; below that the reverb comes in late. The
+    // filtered input goes into the history once; the early reflections read their taps from there too
+    float preDelaySamples = parameters.getRawParameterValue("preDelay")->load() * (getSampleRate() / 1000);
+    float preDelay = std::max(0.0f, preDelaySamples - reverbLatencySamples);
+    earlyReflections.setPreDelay(preDelay);
+    {
+        Telemetry::ScopedProbe probe(telemetry, Telemetry::Stage::preDelay);
+        inputHistory.push(wetBuffer, buffer.getNumSamples());
+        inputHistory.read(wetBuffer, preDelay, buffer.getNumSamples());
+    }
+    telemetry.countNearSubnormals(Telemetry::Stage::preDelay, wetBuffer, buffer.getNumSamples());
 
     //================ early reflections processor ================
     // early reflections parameters
@@ -242,32 +419,148 @@ void RSAlgorithmicVerbAudioProcessor::processBlock(juce::AudioBuffer<float>& buf
                                        ->getIndex()]);
 
     //================ process early reflections ================
-    earlyReflections.processBlock(buffer, midiMessages);
-    juce::dsp::AudioBlock<float> earlyBlock{buffer};
-    earlyLevelMixer.mixWetSamples(earlyBlock);
+    {
+        Telemetry::ScopedProbe probe(telemetry, Telemetry::Stage::earlyReflections);
+        earlyReflections.processBlock(wetBuffer, midiMessages);
+    }
+    telemetry.countNearSubnormals(Telemetry::Stage::earlyReflections, wetBuffer, buffer.getNumSamples());
+    {
+        Telemetry::ScopedProbe probe(telemetry, Telemetry::Stage::mixers);
+        mixer.mixEarlySamples(wetBuffer, buffer.getNumSamples());
+    }
 
-    //=============== reverb processor ================
+    //============ run processor ============
+    if (pipelineLate)
+    {
+        Telemetry::ScopedProbe probe(telemetry, Telemetry::Stage::reverb);
+        lateReverbPipeline.finish();
+        updateReverbProcessor(reverbSpec);
+    }
+
+    // the wet output, from here on; with an algorithm rendering FOA, the core goes into the first two of its channels
+    bool renderFoa = reverbProcessor != nullptr && reverbRendersFoa;
+    auto& reverbBuffer = renderFoa ? foaBuffer : wetBuffer;
+    if (renderFoa)
+    {
+        foaBuffer.setSize(FoaTapEncoder::numChannels, buffer.getNumSamples(), false, false, true);
+        for (int channel = 0; channel < foaBuffer.getNumChannels(); ++channel)
+        {
+            if (channel < wetBuffer.getNumChannels())
+                foaBuffer.copyFrom(channel, 0, wetBuffer, channel, 0, buffer.getNumSamples());
+            else
+                foaBuffer.clear(channel, 0, buffer.getNumSamples());
+        }
+    }
+
+    if (reverbProcessor != nullptr)
+    {
+        //============ process reverb ============
+        // with static settings, convolve with the captured impulse response of exactly these settings once it's
+        // ready, and run the algorithm while it isn't; captures are at the host rate and in stereo, so not when the
+        // reverb runs at a lower rate or renders FOA. Rendering offline the algorithm runs throughout, so the output
+        // doesn't depend on when a capture finishes
+        bool canConvolve = parameters.getRawParameterValue("convolutionFastPath")->load() >= 0.5f &&
+                           reverbProcessor->isTimeInvariant() && rateFactor == 1 && !renderFoa && !isNonRealtime();
+        if (canConvolve)
+            convolutionFastPath.requestImpulseResponse(slotProcessor, reverbParameters);
+
+        // processLateStage() crossfades to whichever this picks
+        usingConvolution = canConvolve && convolutionFastPath.isReadyFor(slotProcessor, reverbParameters);
+
+        // channels on worker threads for blocks long enough to cover handing them over; processBlock returns once
+        // every channel is done, so the mixers below see the whole block
+        int lateBlockSize = pipelineLate ? lateReverbPipeline.getLatencySamples() : buffer.getNumSamples();
+        bool useChannelThreads = parameters.getRawParameterValue("channelThreads")->load() >= 0.5f &&
+                                 lateBlockSize >= ChannelWorkerPool::minimumBlockSize;
+        reverbProcessor->setChannelWorkers(useChannelThreads ? &channelWorkers : nullptr);
+
+        // pipelined, this block goes in and the output of the last comes out
+        Telemetry::ScopedProbe probe(telemetry, Telemetry::Stage::reverb);
+        if (pipelineLate)
+            lateReverbPipeline.process(reverbBuffer);
+        else
+            processLateStage(reverbBuffer);
+    }
+    telemetry.countNearSubnormals(Telemetry::Stage::reverb, reverbBuffer, buffer.getNumSamples());
+
+    //============ idle detection ============
+    // go idle once the input and the wet output have both stayed silent for the hold time
+    if (inputSilent && reverbBuffer.getMagnitude(0, buffer.getNumSamples()) < silenceThreshold)
+        silentSamples += buffer.getNumSamples();
+    else
+        silentSamples = 0;
+
+    double holdSeconds = parameters.getRawParameterValue("preDelay")->load() / 1000.0 + silenceHoldSeconds;
+    if (pipelineLate)
+        holdSeconds += lateReverbPipeline.getLatencySamples() / getSampleRate();
+    if (silentSamples >= holdSeconds * getSampleRate())
+    {
+        resetSignalState();
+        processingIdle = true;
+    }
+
+    //============ mix in reverb wet ============
+    {
+        Telemetry::ScopedProbe probe(telemetry, Telemetry::Stage::mixers);
+        if (renderFoa)
+        {
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                buffer.copyFrom(channel, 0, foaBuffer, channel, 0, buffer.getNumSamples());
+        }
+        else if (usingSurroundSpread)
+        {
+            surroundSpread.upmix(coreBuffer, buffer, buffer.getNumSamples());
+        }
+
+        mixer.mixWetSamples(buffer, buffer.getNumSamples());
+    }
+    telemetry.countNearSubnormals(Telemetry::Stage::mixers, buffer, buffer.getNumSamples());
+
+    //	updateGraph();
+
+    // get processors to set parameters
+    //	ProcessorBase* currentProcessorNode = static_cast<ProcessorBase*>(reverbNode->getProcessor());
+
+    // reverb node parameters
+    //	currentProcessorNode->setSize(size);
+    //	currentProcessorNode->setDecay(feedback);
+    //	currentProcessorNode->setDampingCutoff(damping);
+    //	currentProcessorNode->setDiffusion(diffusion);
+    //	currentProcessorNode->setPreDelay(preDelay);
+    //	currentProcessorNode->setEarlyLateMix(earlyLateMix);
+    //	currentProcessorNode->setDryWetMix(dryWetMix);
+
+    // processing
+    //	mainProcessor->processBlock(buffer, midiMessages);
+}
+
+void RSAlgorithmicVerbAudioProcessor::updateReverbProcessor(const juce::dsp::ProcessSpec& spec)
+{
     slotProcessor = static_cast<juce::AudioParameterChoice*>(parameters.getParameter("reverbType"))->getIndex();
+    rateFactor = MultirateReverb::getRateFactor(
+        static_cast<juce::AudioParameterChoice*>(parameters.getParameter("internalRate"))->getIndex(),
+        spec.sampleRate);
 
     //============ update processor ============
-    if (slotProcessor != prevSlotProcessor)
+    if (slotProcessor != prevSlotProcessor || rateFactor != prevRateFactor)
     {
         reverbProcessor = processorFactory.create(slotProcessor);
 
+        if (reverbProcessor != nullptr && rateFactor > 1)
+            reverbProcessor = std::make_unique<MultirateReverb>(std::move(reverbProcessor), rateFactor);
+
         if (reverbProcessor != nullptr)
-        {
-            juce::dsp::ProcessSpec spec;
-            spec.sampleRate = getSampleRate();
-            spec.maximumBlockSize = buffer.getNumSamples();
-            spec.numChannels = buffer.getNumChannels();
+            prepareReverbProcessor(spec);
 
-            reverbProcessor->prepare(spec);
-        }
+        reverbLatencySamples = rateFactor > 1 ? MultirateReverb::getLatencySamples(rateFactor) : 0;
+
+        // a new algorithm's tiers cost something else, so the governor starts over from the top
+        qualityGovernor.reset();
 
         prevSlotProcessor = slotProcessor;
+        prevRateFactor = rateFactor;
     }
 
-    //============ run processor ============
     if (reverbProcessor != nullptr)
     {
         //============ get parameters ============
@@ -284,31 +577,139 @@ void RSAlgorithmicVerbAudioProcessor::processBlock(juce::AudioBuffer<float>& buf
 
         //============ set parameters ============
         reverbProcessor->setParameters(reverbParameters);
+        reverbProcessor->setQualityTier(qualityGovernor.getTier());
+    }
 
-        //============ process reverb ============
-        reverbProcessor->processBlock(buffer, midiMessages);
+    updateTailLength();
+}
+
+void RSAlgorithmicVerbAudioProcessor::processLateStage(juce::AudioBuffer<float>& block)
+{
+    int numSamples = block.getNumSamples();
+    CpuLoadMeter::ScopedLateStage lateStageTimer(cpuLoadMeter, numSamples);
+
+    // a switch fades the input over from one path to the other, so the incoming one ramps in while the outgoing one
+    // plays on from its tail; both are linear, so their outputs just add
+    convolutionFade.setOn(usingConvolution);
+    // with FOA the block is foaBuffer, which convolution never gets, so an algorithm rendering it cuts convolution off
+    if (reverbRendersFoa)
+    {
+        convolutionFade.finishFade();
+        if (convolutionTail.ringing)
+            convolutionFastPath.reset();
+        convolutionTail = {};
     }
+    convolutionFade.advance(numSamples);
 
-    //============ mix in reverb wet ============
-    juce::dsp::AudioBlock<float> wetBlock{buffer};
-    dryWetMixer.mixWetSamples(wetBlock);
+    bool convolutionFed = convolutionFade.isActive();
+    bool algorithmFed = !convolutionFade.isFullyOn();
+    bool runConvolution = convolutionFed || convolutionTail.ringing;
+    bool runAlgorithm = algorithmFed || algorithmTail.ringing;
 
-    //	updateGraph();
+    // both paths read the input, so convolution gets a copy before the algorithm writes over the block
+    auto& convolutionBlock = runAlgorithm ? crossfadeBuffer : block;
+    if (runConvolution && runAlgorithm)
+    {
+        crossfadeBuffer.setSize(block.getNumChannels(), numSamples, false, false, true);
+        for (int channel = 0; channel < block.getNumChannels(); ++channel)
+            crossfadeBuffer.copyFrom(channel, 0, block, channel, 0, numSamples);
+    }
 
-    // get processors to set parameters
-    //	ProcessorBase* currentProcessorNode = static_cast<ProcessorBase*>(reverbNode->getProcessor());
+    if (runAlgorithm)
+    {
+        fadeLatePathInput(block, false);
+        addDenormalNoise(block, numSamples);
+        reverbProcessor->processBlock(block, lateMidiMessages);
+        if (updateLatePathTail(algorithmTail, algorithmFed, block))
+            reverbProcessor->reset();
+    }
 
-    // reverb node parameters
-    //	currentProcessorNode->setSize(size);
-    //	currentProcessorNode->setDecay(feedback);
-    //	currentProcessorNode->setDampingCutoff(damping);
-    //	currentProcessorNode->setDiffusion(diffusion);
-    //	currentProcessorNode->setPreDelay(preDelay);
-    //	currentProcessorNode->setEarlyLateMix(earlyLateMix);
-    //	currentProcessorNode->setDryWetMix(dryWetMix);
+    if (runConvolution)
+    {
+        fadeLatePathInput(convolutionBlock, true);
+        convolutionFastPath.process(convolutionBlock);
+        if (updateLatePathTail(convolutionTail, convolutionFed, convolutionBlock))
+            convolutionFastPath.reset();
+
+        if (runAlgorithm)
+            for (int channel = 0; channel < block.getNumChannels(); ++channel)
+                block.addFrom(channel, 0, crossfadeBuffer, channel, 0, numSamples);
+    }
+}
 
-    // processing
-    //	mainProcessor->processBlock(buffer, midiMessages);
+void RSAlgorithmicVerbAudioProcessor::fadeLatePathInput(juce::AudioBuffer<float>& input, bool forConvolution) const
+{
+    int numSamples = input.getNumSamples();
+
+    // outside a fade the path either gets the input as it is or nothing
+    if (convolutionFade.isFullyOn() || !convolutionFade.isActive())
+    {
+        if (convolutionFade.isFullyOn() != forConvolution)
+            input.clear();
+        return;
+    }
+
+    for (int channel = 0; channel < input.getNumChannels(); ++channel)
+    {
+        auto* channelData = input.getWritePointer(channel);
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            float gain = convolutionFade.getGain(sample, numSamples);
+            channelData[sample] *= forConvolution ? gain : 1.0f - gain;
+        }
+    }
+}
+
+bool RSAlgorithmicVerbAudioProcessor::updateLatePathTail(LatePathTail& tail, bool fed,
+                                                         const juce::AudioBuffer<float>& output)
+{
+    int numSamples = output.getNumSamples();
+
+    // held as idle detection holds, so nothing still on its way through the longer delays is cut off
+    if (fed || output.getMagnitude(0, numSamples) >= silenceThreshold)
+    {
+        tail.ringing = true;
+        tail.silentSamples = 0;
+        return false;
+    }
+
+    tail.silentSamples += numSamples;
+    if (tail.silentSamples < silenceHoldSeconds * getSampleRate())
+        return false;
+
+    tail = {};
+    return true;
+}
+
+void RSAlgorithmicVerbAudioProcessor::setPipelineLate(bool shouldPipelineLate)
+{
+    pipelineLate = shouldPipelineLate;
+
+    int latencySamples = pipelineLate ? lateReverbPipeline.getLatencySamples() : 0;
+    mixer.setWetLatency(latencySamples);
+    setLatencySamples(latencySamples);
+}
+
+void RSAlgorithmicVerbAudioProcessor::prepareReverbProcessor(const juce::dsp::ProcessSpec& spec)
+{
+    reverbRendersFoa = usingFoa && reverbProcessor->supportsFoaOutput();
+
+    juce::dsp::ProcessSpec reverbSpec = spec;
+    if (reverbRendersFoa)
+        reverbSpec.numChannels = FoaTapEncoder::numChannels;
+
+    reverbProcessor->prepare(reverbSpec);
+}
+
+void RSAlgorithmicVerbAudioProcessor::updateTailLength()
+{
+    double seconds = parameters.getRawParameterValue("preDelay")->load() / 1000.0;
+    seconds += earlyReflections.getTailLengthSeconds();
+
+    if (reverbProcessor != nullptr)
+        seconds += reverbProcessor->getTailLengthSeconds();
+
+    tailLengthSeconds = seconds;
 }
 
 //==============================================================================
@@ -4,43 +4,23 @@
 
 #include <JuceHeader.h>
 
-#include "ConcertHallB.h"
 // #include "CustomDelays.h"
-#include "DattorroVerb.h"
+#include "ConvolutionFastPath.h"
+#include "CpuLoadMeter.h"
+#include "Denormals.h"
 #include "EarlyReflections.h"
-#include "FDNs.h"
-#include "Freeverb.h"
-#include "GardnerRooms.h"
+#include "FusedMixer.h"
+#include "InputHistory.h"
+#include "LateReverbPipeline.h"
+#include "MultirateReverb.h"
 #include "ProcessorBase.h"
-#include "SpecialFX.h"
+#include "ProcessorFactory.h"
+#include "QualityGovernor.h"
+#include "QualityTiers.h"
+#include "SurroundSpread.h"
+#include "Telemetry.h"
 #include "Utilities.h"
 
-struct ProcessorFactory
-{
-    std::unique_ptr<ReverbProcessorBase> create(int type)
-    {
-        auto iter = processorMapping.find(type);
-        if (iter != processorMapping.end())
-            return iter->second();
-
-        return nullptr;
-    }
-
-    std::map<int, std::function<std::unique_ptr<ReverbProcessorBase>()>> processorMapping{
-        {0, []() { return std::make_unique<DattorroPlate>(); }},
-        {1, []() { return std::make_unique<LargeConcertHallB>(); }},
-        {2, []() { return std::make_unique<GardnerSmallRoom>(); }},
-        {3, []() { return std::make_unique<GardnerMediumRoom>(); }},
-        {4, []() { return std::make_unique<GardnerLargeRoom>(); }},
-        {5, []() { return std::make_unique<Freeverb>(); }},
-        {6, []() { return std::make_unique<GeneralizedFDN>(8, "Anderson"); }},
-        {7, []() { return std::make_unique<GeneralizedFDN>(8, "circulant"); }},
-        {8, []() { return std::make_unique<GeneralizedFDN>(8, "Hadamard"); }},
-        {9, []() { return std::make_unique<GeneralizedFDN>(8, "Householder"); }},
-        {10, []() { return std::make_unique<Constellation>(); }},
-        {11, []() { return std::make_unique<EventHorizon>(); }}};
-};
-
 class RSAlgorithmicVerbAudioProcessor : public juce::AudioProcessor
 #if JucePlugin_Enable_ARA
     ,
@@ -59,6 +39,7 @@ class RSAlgorithmicVerbAudioProcessor : public juce::AudioProcessor
     //==============================================================================
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
+    void reset() override;
 
 #ifndef JucePlugin_PreferredChannelConfigurations
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
@@ -89,6 +70,17 @@ class RSAlgorithmicVerbAudioProcessor : public juce::AudioProcessor
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
+    //==============================================================================
+    // true while the input and the tail have both been silent long enough that the reverb isn't being run; safe to call
+    // from any thread
+    bool isProcessingIdle() const;
+
+    // per-stage timing of processBlock, off until enabled from the editor
+    Telemetry& getTelemetry();
+
+    // load of each processBlock call against its real-time budget
+    CpuLoadMeter& getCpuLoadMeter();
+
   private:
     //==============================================================================
     //	void initialiseGraph();
@@ -110,9 +102,43 @@ class RSAlgorithmicVerbAudioProcessor : public juce::AudioProcessor
     //
     //	Node::Ptr reverbNode = nullptr;
 
+    // swaps in the algorithm chosen by reverbType if it has changed, and passes it the current parameters
+    void updateReverbProcessor(const juce::dsp::ProcessSpec& spec);
+
+    // prepares the algorithm for the stereo core, or for the FOA bus if it can render it itself
+    void prepareReverbProcessor(const juce::dsp::ProcessSpec& spec);
+
+    // the algorithm, or convolution in its place, on one block of the wet path; a switch between them crossfades
+    void processLateStage(juce::AudioBuffer<float>& block);
+
+    // whether a path of the late stage still has a tail to play once its input has been faded out
+    struct LatePathTail
+    {
+        bool ringing = false;
+        int silentSamples = 0;
+    };
+
+    // scales one path's copy of the late stage's input by its side of convolutionFade
+    void fadeLatePathInput(juce::AudioBuffer<float>& input, bool forConvolution) const;
+
+    // after a block of one path; true once it has been fed nothing and played silence for the hold time, when it can
+    // stop running and be cleared
+    bool updateLatePathTail(LatePathTail& tail, bool fed, const juce::AudioBuffer<float>& output);
+
+    // reports the pipeline's latency to the host when it's on, and delays the dry path to match
+    void setPipelineLate(bool shouldPipelineLate);
+
+    // pre-delay, then the early reflections, then the late reverb fed by both
+    void updateTailLength();
+
+    // clears everything that holds signal from before going idle, so processing resumes from silence
+    void resetSignalState();
+
     juce::AudioProcessorValueTreeState parameters;
 
-    juce::dsp::DelayLine<float> preDelay{22050};
+    // the filtered input; the reverb's input is read from it at the pre-delay, and the early reflections at the
+    // pre-delay plus each of their taps
+    InputHistory inputHistory;
     juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>> lowCutFilter;
     juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>> highCutFilter;
 
@@ -123,12 +149,65 @@ class RSAlgorithmicVerbAudioProcessor : public juce::AudioProcessor
     std::unique_ptr<ReverbProcessorBase> reverbProcessor = std::unique_ptr<ReverbProcessorBase>{};
     ReverbProcessorParameters reverbParameters;
 
-    juce::dsp::DryWetMixer<float> earlyLevelMixer;
-    juce::dsp::DryWetMixer<float> dryWetMixer;
+    ConvolutionFastPath convolutionFastPath;
+    bool usingConvolution{false};
+    // the late stage's input is faded from the algorithm to convolution and back; the path switched away from keeps
+    // running on silence until its tail has died away, and both write into the block, through crossfadeBuffer
+    TierFade convolutionFade;
+    LatePathTail convolutionTail;
+    LatePathTail algorithmTail;
+    juce::AudioBuffer<float> crossfadeBuffer;
+
+    // runs the reverb's channels in parallel when channelThreads is on
+    ChannelWorkerPool channelWorkers;
+
+    // runs the late stage a block behind on its own thread when pipelineLate is on; after everything it uses, so it
+    // stops first
+    LateReverbPipeline lateReverbPipeline;
+    static constexpr int maximumPipelineLatency = 8192;
+    bool pipelineLate{false};
+    juce::MidiBuffer lateMidiMessages;
+
+    // with more than two channels, the wet path from the filters to the reverb runs once in stereo in coreBuffer, and
+    // surroundSpread fits it to the layout
+    SurroundSpread surroundSpread;
+    juce::AudioBuffer<float> coreBuffer;
+    bool usingSurroundSpread{false};
+
+    // on an FOA bus, algorithms that support it render all four channels from their own delays, in foaBuffer
+    juce::AudioBuffer<float> foaBuffer;
+    bool usingFoa{false};
+    bool reverbRendersFoa{false};
+
+    // the early/dry mix into the reverb and the dry/wet mix out of the plugin, from one copy of the input; the dry
+    // signal is delayed to match the late reverb pipeline
+    FusedMixer mixer{maximumPipelineLatency};
 
     int slotProcessor{-1};
     int prevSlotProcessor{-1};
 
+    // internal rate of the late reverb, as a fraction of the host rate, and the delay its resampling adds, which comes
+    // off the pre-delay
+    int rateFactor{1};
+    int prevRateFactor{1};
+    int reverbLatencySamples{0};
+
+    // read by the host from any thread
+    std::atomic<double> tailLengthSeconds{0.0};
+
+    // idle detection; -100 dB, and held for a second past the pre-delay so nothing still on its way to the output through
+    // the early taps or the longer delays is cut off
+    static constexpr float silenceThreshold = 0.00001f;
+    static constexpr double silenceHoldSeconds = 1.0;
+    int silentSamples{0};
+    std::atomic<bool> processingIdle{false};
+
+    Telemetry telemetry;
+    CpuLoadMeter cpuLoadMeter;
+
+    // steps the algorithm's quality tiers down and up with the load when adaptiveQuality is on
+    QualityGovernor qualityGovernor;
+
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RSAlgorithmicVerbAudioProcessor)
 };
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "ChannelWorkerPool.h"
 #include "Utilities.h"
 #include <JuceHeader.h>
 
@@ -25,6 +26,88 @@ class ReverbProcessorBase
     virtual ReverbProcessorParameters& getParameters() = 0;
 
     virtual void setParameters(const ReverbProcessorParameters& params) = 0;
+
+    // estimated time for the output to fall by 60 dB once the input stops, at the current parameters; the damping
+    // filters are lowpasses with unity gain at DC, so the low end sets the tail and they're left out
+    virtual double getTailLengthSeconds() = 0;
+
+    // true when the output is a fixed linear function of the input at the current parameters, so the processor can be
+    // replaced by its impulse response; most algorithms only move their delays with the LFO by modDepth
+    virtual bool isTimeInvariant()
+    {
+        return getParameters().modDepth == 0.0f;
+    }
+
+    // true when the algorithm can render first-order ambisonics (AmbiX) from its own delay taps; prepared with 4
+    // channels, processBlock then takes a stereo input in the first two and writes W, Y, Z and X
+    virtual bool supportsFoaOutput()
+    {
+        return false;
+    }
+
+    // lets the algorithm run its channels on the pool's threads, or stops it with nullptr; only algorithms whose
+    // channels share no mutable state use the pool
+    virtual void setChannelWorkers(ChannelWorkerPool* pool)
+    {
+        channelWorkers = pool;
+    }
+
+    // quality tiers for when the CPU is short of time; 0 is the algorithm as designed, and each one after it is cheaper
+    // and less dense. Changing tier fades the parts being switched on or off rather than cutting them
+    virtual int getNumQualityTiers()
+    {
+        return 1;
+    }
+
+    virtual void setQualityTier(int tier)
+    {
+        qualityTier = juce::jlimit(0, getNumQualityTiers() - 1, tier);
+    }
+
+    int getQualityTier() const
+    {
+        return qualityTier;
+    }
+
+    // the algorithms' delay lengths, taps and modulation depths are given in samples at the host rate and scaled by this,
+    // so a processor run at a fraction of the host rate is given that fraction before prepare() and keeps the room it has
+    // at the host rate
+    void setDelayScale(float newDelayScale)
+    {
+        delayScale = newDelayScale;
+    }
+
+    float getDelayScale() const
+    {
+        return delayScale;
+    }
+
+  protected:
+    // a length in samples at the host rate, in samples at the rate the processor runs at; below the host rate it's
+    // rounded to whole samples, as reading between samples would take more off the top of the spectrum there
+    float scaleDelay(float hostSamples) const
+    {
+        return delayScale == 1.0f ? hostSamples : std::round(hostSamples * delayScale);
+    }
+
+    // processChannel(channel) for each channel, on the channel workers when there are some
+    template <typename Callback> void forEachChannel(int numChannels, Callback&& processChannel)
+    {
+        if (channelWorkers != nullptr)
+        {
+            channelWorkers->forEachChannel(numChannels, processChannel);
+            return;
+        }
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            processChannel(channel);
+    }
+
+    ChannelWorkerPool* channelWorkers = nullptr;
+
+    int qualityTier = 0;
+
+    float delayScale = 1.0f;
 };
 
 // class ProcessorBase : public juce::AudioProcessor
@@ -0,0 +1,51 @@
+// Creates reverb processors by their index in the reverbType parameter
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "ConcertHallB.h"
+#include "DattorroVerb.h"
+#include "FDNs.h"
+#include "Freeverb.h"
+#include "GardnerRooms.h"
+#include "ProcessorBase.h"
+#include "SpecialFX.h"
+
+struct ProcessorFactory
+{
+    std::unique_ptr<ReverbProcessorBase> create(int type)
+    {
+        auto iter = processorMapping.find(type);
+        if (iter != processorMapping.end())
+            return iter->second();
+
+        return nullptr;
+    }
+
+    int getNumProcessors() const
+    {
+        return static_cast<int>(processorMapping.size());
+    }
+
+    // choice names for the reverbType parameter, in index order
+    static juce::StringArray getProcessorNames()
+    {
+        return {"DattorroPlate",  "DattorroHall",   "SmallRoom",     "MediumRoom",       "LargeRoom",     "Freeverb",
+                "Anderson8xFDN",  "circulant8xFDN", "Hadamard8xFDN", "Householder8xFDN", "Constellation", "EventHorizon"};
+    }
+
+    std::map<int, std::function<std::unique_ptr<ReverbProcessorBase>()>> processorMapping{
+        {0, []() { return std::make_unique<DattorroPlate>(); }},
+        {1, []() { return std::make_unique<LargeConcertHallB>(); }},
+        {2, []() { return std::make_unique<GardnerSmallRoom>(); }},
+        {3, []() { return std::make_unique<GardnerMediumRoom>(); }},
+        {4, []() { return std::make_unique<GardnerLargeRoom>(); }},
+        {5, []() { return std::make_unique<Freeverb>(); }},
+        {6, []() { return std::make_unique<GeneralizedFDN>(8, "Anderson"); }},
+        {7, []() { return std::make_unique<GeneralizedFDN>(8, "circulant"); }},
+        {8, []() { return std::make_unique<GeneralizedFDN>(8, "Hadamard"); }},
+        {9, []() { return std::make_unique<GeneralizedFDN>(8, "Householder"); }},
+        {10, []() { return std::make_unique<Constellation>(); }},
+        {11, []() { return std::make_unique<EventHorizon>(); }}};
+};
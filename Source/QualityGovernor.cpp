@@ -0,0 +1,72 @@
+// Steps the reverb's quality tier down when processBlock or the late reverb runs short of its real-time budget, and up
+// when both have room
+
+#include "QualityGovernor.h"
+#include "QualityTiers.h"
+
+void QualityGovernor::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    reset();
+}
+
+void QualityGovernor::reset()
+{
+    tier = 0;
+    smoothedLoad = 0;
+    samplesOver = 0;
+    samplesUnder = 0;
+    samplesSinceStep = 0;
+    lastStepWasUp = false;
+    stepUpHold = stepUpHoldSeconds;
+}
+
+int QualityGovernor::update(float load, int numSamples, int numTiers)
+{
+    tier = juce::jmin(tier, numTiers - 1);
+
+    float smoothing = 1.0f - std::exp(static_cast<float>(-numSamples / (smoothingSeconds * sampleRate)));
+    smoothedLoad += smoothing * (load - smoothedLoad);
+
+    // held at the limits, so a stretch spent at either end doesn't count towards a step that can't be taken
+    samplesOver = smoothedLoad > stepDownLoad && tier < numTiers - 1 ? samplesOver + numSamples : 0;
+    samplesUnder = smoothedLoad < stepUpLoad && tier > 0 ? samplesUnder + numSamples : 0;
+    // only compared with the holds, so it stops at the longest of them
+    samplesSinceStep =
+        juce::jmin(samplesSinceStep + numSamples, static_cast<int>(maximumStepUpHoldSeconds * sampleRate));
+
+    // the tiers fade between each other, so a step is only heard in full, and only shows in the load, once it's over
+    if (samplesSinceStep < TierFade::fadeSeconds * sampleRate)
+        return tier;
+
+    bool overran = load > 1.0f && tier < numTiers - 1;
+    if (overran || samplesOver >= stepDownHoldSeconds * sampleRate)
+    {
+        // a step up that couldn't be kept; wait longer before trying again
+        if (lastStepWasUp && samplesSinceStep < stepUpHold * sampleRate)
+            stepUpHold = juce::jmin(stepUpHold * 2.0, maximumStepUpHoldSeconds);
+
+        step(tier + 1);
+        lastStepWasUp = false;
+    }
+    else if (samplesUnder >= stepUpHold * sampleRate)
+    {
+        step(tier - 1);
+        lastStepWasUp = true;
+    }
+
+    return tier;
+}
+
+int QualityGovernor::getTier() const
+{
+    return tier;
+}
+
+void QualityGovernor::step(int newTier)
+{
+    tier = newTier;
+    samplesOver = 0;
+    samplesUnder = 0;
+    samplesSinceStep = 0;
+}
@@ -0,0 +1,48 @@
+// Steps the reverb's quality tier down when processBlock or the late reverb runs short of its real-time budget, and up
+// when both have room
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*
+Judged on the load of each callback, or of the late reverb stage when that's higher, 1.0 being its whole budget,
+smoothed over smoothingSeconds. A tier down takes the load staying above stepDownLoad for stepDownHoldSeconds, or a
+callback or late stage that overran; a tier up takes it staying below stepUpLoad for the step-up hold, which starts at
+stepUpHoldSeconds and doubles, up to maximumStepUpHoldSeconds, each time a step up has to be taken back within that
+hold. Only one tier moves at a time, and never again until the last step's fade is over.
+*/
+class QualityGovernor
+{
+  public:
+    static constexpr float stepDownLoad = 0.75f;
+    static constexpr float stepUpLoad = 0.45f;
+    static constexpr double smoothingSeconds = 0.1;
+    static constexpr double stepDownHoldSeconds = 0.2;
+    static constexpr double stepUpHoldSeconds = 4.0;
+    static constexpr double maximumStepUpHoldSeconds = 60.0;
+
+    void prepare(double newSampleRate);
+
+    // back to the top tier, with the load and holds forgotten
+    void reset();
+
+    // once per block on the audio thread, with the higher of the last callback's and the last late stage's loads;
+    // returns the tier to run at
+    int update(float load, int numSamples, int numTiers);
+
+    int getTier() const;
+
+  private:
+    void step(int newTier);
+
+    double sampleRate = 44100;
+
+    int tier = 0;
+    float smoothedLoad = 0;
+    int samplesOver = 0;
+    int samplesUnder = 0;
+    int samplesSinceStep = 0;
+    bool lastStepWasUp = false;
+    double stepUpHold = stepUpHoldSeconds;
+};
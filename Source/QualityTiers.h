@@ -0,0 +1,96 @@
+// Fades for the parts of an algorithm that its cheaper quality tiers switch off
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "LFO.h"
+
+/*
+A part of an algorithm (its modulation, some of its delays) that a quality tier turns off is faded out over fadeSeconds
+and only then skipped, and faded back in when the tier comes back up, so stepping between tiers doesn't click. The fade
+moves once per block, before the channels are processed, and is only read while they are, so channels on separate
+threads all see the same gains.
+*/
+class TierFade
+{
+  public:
+    static constexpr double fadeSeconds = 0.05;
+
+    // starts fully on
+    void prepare(double sampleRate)
+    {
+        fade.reset(sampleRate, fadeSeconds);
+        fade.setCurrentAndTargetValue(1.0f);
+        startGain = 1.0f;
+        endGain = 1.0f;
+    }
+
+    // true when the part was fully off, so whatever it held from before is stale and should be cleared
+    bool setOn(bool shouldBeOn)
+    {
+        bool wasOff = !isActive() && !fade.isSmoothing();
+        fade.setTargetValue(shouldBeOn ? 1.0f : 0.0f);
+        return shouldBeOn && wasOff;
+    }
+
+    // skips the rest of the fade, e.g. when the algorithm is reset
+    void finishFade()
+    {
+        fade.setCurrentAndTargetValue(fade.getTargetValue());
+        startGain = fade.getCurrentValue();
+        endGain = startGain;
+    }
+
+    // moves the fade on by a block; once per block, before the channels are processed
+    void advance(int numSamples)
+    {
+        startGain = fade.getCurrentValue();
+        fade.skip(numSamples);
+        endGain = fade.getCurrentValue();
+    }
+
+    // heard at all in this block
+    bool isActive() const
+    {
+        return startGain > 0.0f || endGain > 0.0f;
+    }
+
+    // fully on for the whole block, so the gain is 1 throughout
+    bool isFullyOn() const
+    {
+        return startGain == 1.0f && endGain == 1.0f;
+    }
+
+    // at a sample of this block, ramping on from where the last one ended
+    float getGain(int sample, int numSamples) const
+    {
+        return startGain + (endGain - startGain) * static_cast<float>(sample + 1) / static_cast<float>(numSamples);
+    }
+
+  private:
+    juce::SmoothedValue<float> fade;
+    float startGain = 1.0f;
+    float endGain = 1.0f;
+};
+
+// the LFO's next output scaled by the modulation fade; once that's faded out the LFO isn't run at all, which saves its
+// two sines per sample, and the delays are read unmodulated
+inline SignalGenData renderModulation(LFO& lfo, const TierFade& modulationFade, int sample, int numSamples)
+{
+    SignalGenData output;
+    if (!modulationFade.isActive())
+        return output;
+
+    output = lfo.renderAudioOutput();
+    if (!modulationFade.isFullyOn())
+    {
+        double gain = modulationFade.getGain(sample, numSamples);
+        output.normalOutput *= gain;
+        output.invertedOutput *= gain;
+        output.quadPhaseOutput_pos *= gain;
+        output.quadPhaseOutput_neg *= gain;
+    }
+
+    return output;
+}
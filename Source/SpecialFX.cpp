@@ -16,12 +16,25 @@ void Constellation::prepare(const juce::dsp::ProcessSpec& spec)
     channelFeedback.resize(spec.numChannels);
     std::fill(channelFeedback.begin(), channelFeedback.end(), 0.0f);
 
-    delay.prepare(spec);
-    dampingFilter.prepare(spec);
-    dcFilter.prepare(spec);
+    juce::dsp::ProcessSpec monoSpec = spec;
+    monoSpec.numChannels = 1;
+
+    // the length the taps wrap around is in samples at the host rate
+    delays.assign(spec.numChannels,
+                  DelayLineWithSampleAccess<float, ReverbDelayStorage>(static_cast<int>(22050 * delayScale)));
+    dampingFilters.resize(spec.numChannels);
+    dcFilters.resize(spec.numChannels);
+    for (size_t channel = 0; channel < spec.numChannels; ++channel)
+    {
+        delays[channel].prepare(monoSpec);
+        dampingFilters[channel].prepare(monoSpec);
+        dcFilters[channel].prepare(monoSpec);
+
+        dcFilters[channel].setType(juce::dsp::FirstOrderTPTFilterType::highpass);
+        dcFilters[channel].setCutoffFrequency(20.0f);
+    }
 
-    dcFilter.setType(juce::dsp::FirstOrderTPTFilterType::highpass);
-    dcFilter.setCutoffFrequency(20.0f);
+    outputTapDelays.resize(spec.numChannels);
 
     // prepare lfo; 1 per channel
     lfoParameters.frequency_Hz = 0.25;
@@ -33,13 +46,13 @@ void Constellation::prepare(const juce::dsp::ProcessSpec& spec)
         osc.reset(spec.sampleRate);
     }
 
+    extraTapFade.prepare(spec.sampleRate);
+
     reset();
 }
 
 void Constellation::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
-    juce::ScopedNoDenormals noDenormals;
-
     int numSamples = buffer.getNumSamples();
     int numChannels = buffer.getNumChannels();
 
@@ -51,63 +64,105 @@ void Constellation::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuf
         osc.setParameters(lfoParameters);
     }
 
-    dampingFilter.setCutoffFrequency(parameters.damping);
+    for (auto& filter : dampingFilters)
+        filter.setCutoffFrequency(parameters.damping);
+
+    // tap lengths are fixed for the block; wrap them into the buffer once here (long rooms wrap around the
+    // delay, as they always have) so the per-sample positions only need a single-step wrap
+    float bufferLength = static_cast<float>(delays[0].getNumSamples());
+    for (int tap = 0; tap < numFeedbackTaps; ++tap)
+        feedbackTapDelays[tap] = std::fmod(feedbackDelayTimes[tap] * samplesPerMs * parameters.roomSize, bufferLength);
 
     for (int channel = 0; channel < numChannels; ++channel)
-    {
+        for (int tap = 0; tap < numOutputTaps; ++tap)
+            outputTapDelays[channel][tap] =
+                std::fmod(channelOutDelayTimes[channel % 2][tap] * samplesPerMs, bufferLength);
+
+    // modulate from +/- 32 to +/- 64; does not turn fully off to allow for longer tails
+    float modulationDepth = (parameters.modDepth * 32.0f + 32.0f) * delayScale;
+
+    // quality tier; the taps all read the one delay, so dropped ones have nothing to clear when they come back
+    extraTapFade.setOn(qualityTier < 1);
+    extraTapFade.advance(numSamples);
+    int activeFeedbackTaps = extraTapFade.isActive() ? numFeedbackTaps : lowTierFeedbackTaps;
+
+    auto processChannel = [&](int channel) {
         auto* channelData = buffer.getWritePointer(channel);
+        auto& delay = delays[channel];
+        auto& dampingFilter = dampingFilters[channel];
+        auto& dcFilter = dcFilters[channel];
+        // kept locally for the block, as the channels' values share cache lines
+        float feedback = channelFeedback[channel];
 
         for (int sample = 0; sample < numSamples; ++sample)
         {
-            lfoOutput = lfo[channel].renderAudioOutput();
+            SignalGenData lfoOutput = lfo[channel].renderAudioOutput();
 
             // input + damped feedback into delay
-            delay.pushSample(channel, channelData[sample] +
-                                          dcFilter.processSample(
-                                              channel, dampingFilter.processSample(channel, channelFeedback[channel]) *
-                                                           parameters.decayTime));
-            dampingFilter.snapToZero();
-            dcFilter.snapToZero();
-
-            // reset channelData, then sum outputs to channel
-            channelData[sample] = 0.0f;
-            for (int delOut = 0; delOut < 4; ++delOut)
+            delay.pushSample(0, channelData[sample] +
+                                    dcFilter.processSample(0, dampingFilter.processSample(0, feedback) *
+                                                                  parameters.decayTime));
+
+            // sum output taps to channel
+            channelData[sample] = delay.getInterpolatedSum(0, outputTapDelays[channel].data(), numOutputTaps, 0.5f);
+
+            // cycle through 4 quadrature phases every 4 delays
+            const float lfoPhases[4] = {static_cast<float>(lfoOutput.normalOutput),
+                                        static_cast<float>(lfoOutput.quadPhaseOutput_pos),
+                                        static_cast<float>(lfoOutput.invertedOutput),
+                                        static_cast<float>(lfoOutput.quadPhaseOutput_neg)};
+
+            alignas(32) float tapDelays[numFeedbackTaps];
+            for (int tap = 0; tap < activeFeedbackTaps; ++tap)
             {
-                channelData[sample] +=
-                    delay.getSampleAtDelay(channel, channelOutDelayTimes[channel][delOut] * samplesPerMs) / 2.0f;
+                float tapDelay = feedbackTapDelays[tap] + lfoPhases[tap % 4] * modulationDepth;
+                tapDelay += tapDelay < 0.0f ? bufferLength : 0.0f;
+                tapDelay -= tapDelay >= bufferLength ? bufferLength : 0.0f;
+                tapDelays[tap] = tapDelay;
             }
 
-            // reset feedback, then add delay taps
-            channelFeedback[channel] = 0.0f;
-            for (int delTime = 0; delTime < 16; ++delTime)
+            // over most of the band the taps add up incoherently, so as the extra ones fade out the rest come up by as
+            // much as sqrt(2) to keep the loop gain
+            if (extraTapFade.isFullyOn())
+            {
+                feedback = delay.getInterpolatedSum(0, tapDelays, numFeedbackTaps, 1.0f / 7.0f);
+            }
+            else
             {
-                float selectedLfo{0.0f};
-
-                // cycle through 4 quadrature phases every 4 delays
-                int lfoPhase = delTime % 4;
-                if (lfoPhase == 3)
-                    selectedLfo = lfoOutput.quadPhaseOutput_neg;
-                else if (lfoPhase == 2)
-                    selectedLfo = lfoOutput.invertedOutput;
-                else if (lfoPhase == 1)
-                    selectedLfo = lfoOutput.quadPhaseOutput_pos;
-                else
-                    selectedLfo = lfoOutput.normalOutput;
-
-                // modulate from +/- 32 to +/- 64; does not turn fully off to allow for longer tails
-                channelFeedback[channel] +=
-                    delay.getSampleAtDelay(channel, (feedbackDelayTimes[delTime] * samplesPerMs * parameters.roomSize) +
-                                                        (selectedLfo * (parameters.modDepth * 32.0f + 32.0f))) /
-                    7.0f;
+                float extraTapGain = extraTapFade.getGain(sample, numSamples);
+                float keptTapGain = 1.0f + (juce::MathConstants<float>::sqrt2 - 1.0f) * (1.0f - extraTapGain);
+                feedback = delay.getInterpolatedSum(0, tapDelays, lowTierFeedbackTaps, keptTapGain / 7.0f);
+                if (extraTapFade.isActive())
+                    feedback += delay.getInterpolatedSum(0, tapDelays + lowTierFeedbackTaps,
+                                                         numFeedbackTaps - lowTierFeedbackTaps, extraTapGain / 7.0f);
             }
         }
-    }
+
+        channelFeedback[channel] = feedback;
+
+        // the filters' state is the last thing left once the tail has died away; clear it below -160 dB, once a block
+        // rather than every sample, where it also cut into the signal whenever it crossed zero
+        dampingFilter.snapToZero();
+        dcFilter.snapToZero();
+    };
+
+    forEachChannel(numChannels, processChannel);
 }
 
 void Constellation::reset()
 {
-    delay.reset();
-    dampingFilter.reset();
+    for (auto& delay : delays)
+        delay.reset();
+
+    for (auto& filter : dampingFilters)
+        filter.reset();
+
+    for (auto& filter : dcFilters)
+        filter.reset();
+
+    std::fill(channelFeedback.begin(), channelFeedback.end(), 0.0f);
+
+    extraTapFade.finishFade();
 }
 
 ReverbProcessorParameters& Constellation::getParameters()
@@ -125,6 +180,36 @@ void Constellation::setParameters(const ReverbProcessorParameters& params)
     }
 }
 
+double Constellation::getTailLengthSeconds()
+{
+    // the feedback taps add up in phase at low frequencies, and wherever their whole-millisecond lengths line up, so
+    // together they can send 16 / 7 of the signal round the loop. From decayTime 7 / 16 up, only the modulation keeps
+    // the loop from ringing on (without it, it doesn't decay at all), so the tail is as long as loopDecayTime gives.
+    // Below that, taps whose gains add up to less than 1 die away at least as fast as a single tap of that gain on the
+    // longest delay. Treating the taps as incoherent had the tail short by as much as a factor of 4
+    float longestTapMs = *std::max_element(feedbackDelayTimes.begin(), feedbackDelayTimes.end());
+    double modulationSeconds = (parameters.modDepth * 32.0 + 32.0) * delayScale / sampleRate;
+    double loopSeconds = longestTapMs * parameters.roomSize / 1000.0 + modulationSeconds;
+
+    float latestOutputMs = 0;
+    for (const auto& channelDelayTimes : channelOutDelayTimes)
+        latestOutputMs =
+            std::max(latestOutputMs, *std::max_element(channelDelayTimes.begin(), channelDelayTimes.end()));
+
+    double loopGain = parameters.decayTime * numFeedbackTaps / 7.0;
+    return latestOutputMs / 1000.0 + loopSeconds + loopDecayTime(loopGain, loopSeconds);
+}
+
+bool Constellation::isTimeInvariant()
+{
+    return false;
+}
+
+int Constellation::getNumQualityTiers()
+{
+    return 2;
+}
+
 //=====================================================================================
 
 EventHorizon::EventHorizon() = default;
@@ -160,9 +245,8 @@ void EventHorizon::prepare(const juce::dsp::ProcessSpec& spec)
         }
     }
 
-    // resize output allpass storage to num channels, fill w/ 0.0f
-    outputAllpassValues.resize(spec.numChannels);
-    std::fill(outputAllpassValues.begin(), outputAllpassValues.end(), 0.0f);
+    monoBuffer.setSize(1, spec.maximumBlockSize);
+    lfoBuffer.setSize(4, spec.maximumBlockSize);
 
     // damping filters - 1 per channel
     dampingFilters.resize(numSeriesAllpasses);
@@ -177,14 +261,13 @@ void EventHorizon::prepare(const juce::dsp::ProcessSpec& spec)
     lfoParameters.waveform = generatorWaveform::sin;
     lfo.setParameters(lfoParameters);
     lfo.reset(spec.sampleRate);
+    modulationFade.prepare(spec.sampleRate);
 
     reset();
 }
 
 void EventHorizon::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
-    juce::ScopedNoDenormals noDenormals;
-
     int numSamples = buffer.getNumSamples();
     int numChannels = buffer.getNumChannels();
 
@@ -192,10 +275,14 @@ void EventHorizon::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuff
     lfoParameters.frequency_Hz = parameters.modRate;
     lfo.setParameters(lfoParameters);
 
-    // delay times for main allpasses
+    // quality tier
+    modulationFade.setOn(qualityTier < 1);
+    modulationFade.advance(numSamples);
+
+    // delay times for main allpasses, from their lengths in samples at the host rate
     for (int apf = 0; apf < numSeriesAllpasses; ++apf)
     {
-        mainAllpasses[apf].setDelay(delayTimes[apf] * parameters.roomSize);
+        mainAllpasses[apf].setDelay(scaleDelay(delayTimes[apf] * parameters.roomSize));
         mainAllpasses[apf].setGain(parameters.decayTime);
     }
 
@@ -205,7 +292,7 @@ void EventHorizon::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuff
         for (int apf = 0; apf < numOutputAllpasses; ++apf)
         {
             // assumes stereo, but if more, alternates between two output delay lists
-            outAllpasses[channel][apf].setDelay(outDelayTimes[channel % 2][apf] * parameters.roomSize);
+            outAllpasses[channel][apf].setDelay(scaleDelay(outDelayTimes[channel % 2][apf] * parameters.roomSize));
             outAllpasses[channel][apf].setGain(parameters.decayTime);
         }
     }
@@ -214,9 +301,9 @@ void EventHorizon::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuff
     for (auto& filter : dampingFilters)
         filter.setCutoffFrequency(parameters.damping);
 
-    // mono buffer for single chain of allpasses
-    juce::AudioBuffer<float> monoBuffer(1, numSamples);
-    monoBuffer.clear();
+    // grows only if the host sends a block larger than prepared for
+    monoBuffer.setSize(1, numSamples, false, false, true);
+    lfoBuffer.setSize(4, numSamples, false, false, true);
 
     // if stereo, copy in R channel. If more, ignore channels other than 0/1
     monoBuffer.copyFrom(0, 0, buffer, 0, 0, numSamples);
@@ -228,63 +315,49 @@ void EventHorizon::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuff
 
     auto* monoData = monoBuffer.getWritePointer(0);
 
-    // through samples 1 time - only 1 channel of main allpasses
+    // render the LFO once per block; phases in the order they're cycled through every 4 delays
+    auto* lfoNormal = lfoBuffer.getWritePointer(0);
+    auto* lfoQuadPhasePos = lfoBuffer.getWritePointer(1);
+    auto* lfoInverted = lfoBuffer.getWritePointer(2);
+    auto* lfoQuadPhaseNeg = lfoBuffer.getWritePointer(3);
     for (int sample = 0; sample < numSamples; ++sample)
     {
-        // LFO
-        lfoOutput = lfo.renderAudioOutput();
+        lfoOutput = renderModulation(lfo, modulationFade, sample, numSamples);
+        lfoNormal[sample] = lfoOutput.normalOutput;
+        lfoQuadPhasePos[sample] = lfoOutput.quadPhaseOutput_pos;
+        lfoInverted[sample] = lfoOutput.invertedOutput;
+        lfoQuadPhaseNeg[sample] = lfoOutput.quadPhaseOutput_neg;
+    }
 
-        //        monoData[sample] *= mInputScalar;
+    float modulationDepth = 32.0f * delayScale * parameters.modDepth;
 
-        // pass sample through each main allpass in series
-        for (int apf = 0; apf < numSeriesAllpasses; ++apf)
-        {
-            float selectedLfo{0.0f};
+    // the allpasses are in series with no feedback around the chain, so each stage can run over the whole
+    // block before the next one starts; this keeps one delay line hot in cache at a time
+    for (int apf = 0; apf < numSeriesAllpasses; ++apf)
+    {
+        mainAllpasses[apf].processBlock(0, monoData, numSamples, scaleDelay(delayTimes[apf]),
+                                        lfoBuffer.getReadPointer(apf % 4), modulationDepth);
 
-            // cycle through 4 quadrature phases every 4 delays
-            int lfoPhase = apf % 4;
-            if (lfoPhase == 3)
-                selectedLfo = lfoOutput.quadPhaseOutput_neg;
-            else if (lfoPhase == 2)
-                selectedLfo = lfoOutput.invertedOutput;
-            else if (lfoPhase == 1)
-                selectedLfo = lfoOutput.quadPhaseOutput_pos;
-            else
-                selectedLfo = lfoOutput.normalOutput;
+        for (int sample = 0; sample < numSamples; ++sample)
+            monoData[sample] = dampingFilters[apf].processSample(0, monoData[sample]);
+    }
 
-            mainAllpasses[apf].pushSample(0, monoData[sample]);
-            monoData[sample] = dampingFilters[apf].processSample(
-                0, mainAllpasses[apf].popSample(0, delayTimes[apf] + selectedLfo * 32.0f * parameters.modDepth));
-        }
+    // output allpasses in series, channel by channel
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* channelData = buffer.getWritePointer(channel);
+        juce::FloatVectorOperations::copy(channelData, monoData, numSamples);
 
-        // pass sample through each output allpass, channel by channel
-        for (int channel = 0; channel < numChannels; ++channel)
+        for (int apf = 0; apf < numOutputAllpasses; ++apf)
         {
-            outputAllpassValues[channel] = monoData[sample];
-            // pass output values through allpasses in series
-            for (int apf = 0; apf < numOutputAllpasses; ++apf)
-            {
-                float selectedLfo{0.0f};
-
-                // cycle through 4 quadrature phases every 4 delays
-                int lfoPhase = apf % 4;
-                if (lfoPhase == 3)
-                    selectedLfo = lfoOutput.quadPhaseOutput_neg;
-                else if (lfoPhase == 2)
-                    selectedLfo = lfoOutput.invertedOutput;
-                else if (lfoPhase == 1)
-                    selectedLfo = lfoOutput.quadPhaseOutput_pos;
-                else
-                    selectedLfo = lfoOutput.normalOutput;
-
-                outAllpasses[channel][apf].pushSample(channel, outputAllpassValues[channel]);
-                outputAllpassValues[channel] = outAllpasses[channel][apf].popSample(
-                    channel, outDelayTimes[channel][apf] + selectedLfo * 32.0f * parameters.modDepth);
-            }
-            // output of final allpass into correct channel of main buffer
-            auto* channelData = buffer.getWritePointer(channel);
-            channelData[sample] = outputAllpassValues[channel] * outputScalar;
+            // assumes stereo, but if more, alternates between two output delay lists
+            outAllpasses[channel][apf].processBlock(channel, channelData, numSamples,
+                                                    scaleDelay(outDelayTimes[channel % 2][apf]),
+                                                    lfoBuffer.getReadPointer(apf % 4), modulationDepth);
         }
+
+        // output of final allpass into correct channel of main buffer
+        juce::FloatVectorOperations::multiply(channelData, outputScalar, numSamples);
     }
 }
 
@@ -296,6 +369,16 @@ void EventHorizon::reset()
     for (auto& channel : outAllpasses)
         for (auto& apf : channel)
             apf.reset();
+
+    for (auto& filter : dampingFilters)
+        filter.reset();
+
+    modulationFade.finishFade();
+}
+
+int EventHorizon::getNumQualityTiers()
+{
+    return 2;
 }
 
 ReverbProcessorParameters& EventHorizon::getParameters()
@@ -303,6 +386,34 @@ ReverbProcessorParameters& EventHorizon::getParameters()
     return parameters;
 }
 
+double EventHorizon::getTailLengthSeconds()
+{
+    // every allpass rings at a gain of decayTime, the longest ringing on after the signal has passed through the whole
+    // series; the delays are read at their unscaled lengths, so roomSize doesn't enter into it
+    double hostSampleRate = sampleRate / delayScale;
+    double seriesSeconds = 0;
+    double allpassDecay = 0;
+    for (auto delayTime : delayTimes)
+    {
+        seriesSeconds += delayTime / hostSampleRate;
+        allpassDecay = std::max(allpassDecay, loopDecayTime(parameters.decayTime, delayTime / hostSampleRate));
+    }
+
+    double outputSeconds = 0;
+    for (const auto& channelDelayTimes : outDelayTimes)
+    {
+        double channelSeconds = 0;
+        for (auto delayTime : channelDelayTimes)
+        {
+            channelSeconds += delayTime / hostSampleRate;
+            allpassDecay = std::max(allpassDecay, loopDecayTime(parameters.decayTime, delayTime / hostSampleRate));
+        }
+        outputSeconds = std::max(outputSeconds, channelSeconds);
+    }
+
+    return seriesSeconds + outputSeconds + allpassDecay;
+}
+
 void EventHorizon::setParameters(const ReverbProcessorParameters& params)
 {
     if (!(params == parameters))
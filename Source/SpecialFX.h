@@ -8,6 +8,7 @@
 #include "CustomDelays.h"
 #include "LFO.h"
 #include "ProcessorBase.h"
+#include "QualityTiers.h"
 #include "Utilities.h"
 
 class Constellation : public ReverbProcessorBase
@@ -27,17 +28,25 @@ class Constellation : public ReverbProcessorBase
 
     void setParameters(const ReverbProcessorParameters& params) override;
 
+    double getTailLengthSeconds() override;
+
+    // the feedback taps are always modulated, whatever modDepth is
+    bool isTimeInvariant() override;
+
+    // 0: as designed; 1: half the feedback taps. The modulation is part of the sound, so no tier turns it off
+    int getNumQualityTiers() override;
+
   private:
     // parameter struct
     ReverbProcessorParameters parameters;
 
-    DelayLineWithSampleAccess<float> delay{22050};
+    // one delay and pair of filters per channel; the channels share no state, so they can run on separate threads
+    std::vector<DelayLineWithSampleAccess<float, ReverbDelayStorage>> delays{};
 
-    juce::dsp::FirstOrderTPTFilter<float> dampingFilter;
-    juce::dsp::FirstOrderTPTFilter<float> dcFilter;
+    std::vector<juce::dsp::FirstOrderTPTFilter<float>> dampingFilters{};
+    std::vector<juce::dsp::FirstOrderTPTFilter<float>> dcFilters{};
 
     OscillatorParameters lfoParameters;
-    SignalGenData lfoOutput;
     std::vector<LFO> lfo;
 
     std::vector<float> channelFeedback{};
@@ -45,6 +54,16 @@ class Constellation : public ReverbProcessorBase
     std::vector<float> feedbackDelayTimes{47,  158, 200, 233, 120, 169, 209, 240,
                                           134, 180, 217, 244, 146, 190, 225, 247};
 
+    static constexpr int numOutputTaps = 4;
+    static constexpr int numFeedbackTaps = 16;
+    // the lower tier only reads the first lowTierFeedbackTaps; they cover every LFO phase twice
+    static constexpr int lowTierFeedbackTaps = 8;
+    TierFade extraTapFade;
+
+    // tap lengths in samples for the current block, wrapped into the delay buffer
+    std::vector<std::array<float, numOutputTaps>> outputTapDelays{};
+    std::array<float, numFeedbackTaps> feedbackTapDelays{};
+
     float sampleRate = 44100;
     float samplesPerMs = 44.1f;
 };
@@ -68,18 +87,24 @@ class EventHorizon : public ReverbProcessorBase
 
     void setParameters(const ReverbProcessorParameters& params) override;
 
+    double getTailLengthSeconds() override;
+
+    // 0: as designed; 1: unmodulated
+    int getNumQualityTiers() override;
+
   private:
     // parameter struct
     ReverbProcessorParameters parameters;
 
-    std::vector<Allpass<float>> mainAllpasses{};
-    std::vector<std::vector<Allpass<float>>> outAllpasses{};
+    std::vector<Allpass<float, ReverbDelayStorage>> mainAllpasses{};
+    std::vector<std::vector<Allpass<float, ReverbDelayStorage>>> outAllpasses{};
 
     std::vector<juce::dsp::FirstOrderTPTFilter<float>> dampingFilters{};
 
     OscillatorParameters lfoParameters;
     SignalGenData lfoOutput;
     LFO lfo;
+    TierFade modulationFade;
 
     std::vector<float> delayTimes = {271,  2003, 337,  1487, 2719, 1109, 3121, 541, 3923, 1609, 701,  1303,
                                      2549, 439,  3583, 977,  1877, 211,  2251, 487, 823,  2917, 3307, 3767};
@@ -89,7 +114,9 @@ class EventHorizon : public ReverbProcessorBase
     int numSeriesAllpasses = 24;
     int numOutputAllpasses = 4;
 
-    std::vector<float> outputAllpassValues{};
+    // whole-block scratch: mono sum through the main chain, and the 4 quadrature LFO phases per sample
+    juce::AudioBuffer<float> monoBuffer;
+    juce::AudioBuffer<float> lfoBuffer;
 
     float outputScalar = 0.5f;
     float sampleRate = 44100;
@@ -0,0 +1,218 @@
+// Fits surround, immersive and FOA layouts around one stereo reverb: a downmix into it, and decorrelated taps out of it
+
+#include "SurroundSpread.h"
+
+namespace
+{
+// allpass delays in samples at 48 kHz, all prime and different for every channel
+constexpr int decorrelationDelays[SurroundSpread::maxChannels][3]{
+    {113, 337, 547}, {127, 353, 571}, {149, 383, 601}, {163, 409, 631}, {179, 433, 659}, {191, 457, 683},
+    {211, 479, 709}, {227, 503, 733}, {241, 521, 757}, {257, 541, 787}, {271, 563, 797}, {283, 587, 809}};
+
+constexpr float decorrelationGain = 0.5f;
+
+// Schroeder allpass round one of the decorrelation delays
+float processAllpass(FixedDelay<4096, 1>& delay, float input)
+{
+    float delayOutput = delay.read(0);
+    float delayInput = input + decorrelationGain * delayOutput;
+    delay.write(0, delayInput);
+    return delayOutput - decorrelationGain * delayInput;
+}
+
+enum class Side
+{
+    left,
+    right,
+    centre,
+    lfe
+};
+
+Side getSide(juce::AudioChannelSet::ChannelType type)
+{
+    using Type = juce::AudioChannelSet::ChannelType;
+
+    switch (type)
+    {
+    case Type::left:
+    case Type::leftCentre:
+    case Type::leftSurround:
+    case Type::leftSurroundSide:
+    case Type::leftSurroundRear:
+    case Type::wideLeft:
+    case Type::topFrontLeft:
+    case Type::topSideLeft:
+    case Type::topRearLeft:
+        return Side::left;
+    case Type::right:
+    case Type::rightCentre:
+    case Type::rightSurround:
+    case Type::rightSurroundSide:
+    case Type::rightSurroundRear:
+    case Type::wideRight:
+    case Type::topFrontRight:
+    case Type::topSideRight:
+    case Type::topRearRight:
+        return Side::right;
+    case Type::LFE:
+    case Type::LFE2:
+        return Side::lfe;
+    default:
+        return Side::centre;
+    }
+}
+} // namespace
+
+bool SurroundSpread::isLayoutSupported(const juce::AudioChannelSet& layout)
+{
+    if (layout == juce::AudioChannelSet::mono() || layout == juce::AudioChannelSet::stereo() || isFoa(layout))
+        return true;
+
+    // named surround and immersive layouts only; discrete channels have no positions to spread over, and higher-order
+    // ambisonics aren't handled
+    return layout.size() <= maxChannels && !layout.isDiscreteLayout() && layout.getAmbisonicOrder() < 0;
+}
+
+void SurroundSpread::prepare(const juce::AudioChannelSet& newLayout, double sampleRate)
+{
+    foa = isFoa(newLayout);
+    if (foa)
+    {
+        // direct and allpassed, for each side
+        foaEncoder.prepare(4);
+        taps.resize(2);
+        for (size_t side = 0; side < taps.size(); ++side)
+        {
+            taps[side].decorrelate = true;
+            for (size_t stage = 0; stage < taps[side].allpassDelays.size(); ++stage)
+            {
+                auto delay = std::round(decorrelationDelays[side][stage] * sampleRate / 48000.0);
+                taps[side].allpassDelays[stage].setDelay(static_cast<float>(delay));
+            }
+        }
+
+        reset();
+        return;
+    }
+
+    taps.resize(static_cast<size_t>(newLayout.size()));
+
+    constexpr float centreGain = juce::MathConstants<float>::sqrt2 / 2.0f;
+
+    for (int channel = 0; channel < newLayout.size(); ++channel)
+    {
+        auto type = newLayout.getTypeOfChannel(channel);
+        auto& tap = taps[static_cast<size_t>(channel)];
+
+        switch (getSide(type))
+        {
+        case Side::left:
+            tap.leftGain = 1.0f;
+            tap.rightGain = 0.0f;
+            break;
+        case Side::right:
+            tap.leftGain = 0.0f;
+            tap.rightGain = 1.0f;
+            break;
+        case Side::centre:
+            tap.leftGain = centreGain;
+            tap.rightGain = centreGain;
+            break;
+        case Side::lfe:
+            tap.leftGain = 0.0f;
+            tap.rightGain = 0.0f;
+            break;
+        }
+
+        // the front pair carries the stereo image as it is
+        tap.decorrelate = type != juce::AudioChannelSet::left && type != juce::AudioChannelSet::right;
+
+        for (size_t stage = 0; stage < tap.allpassDelays.size(); ++stage)
+        {
+            auto delay = std::round(decorrelationDelays[channel % maxChannels][stage] * sampleRate / 48000.0);
+            tap.allpassDelays[stage].setDelay(static_cast<float>(delay));
+        }
+    }
+
+    reset();
+}
+
+void SurroundSpread::reset()
+{
+    for (auto& tap : taps)
+        for (auto& delay : tap.allpassDelays)
+            delay.reset();
+}
+
+void SurroundSpread::downmix(const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& core,
+                             int numSamples) const
+{
+    if (foa)
+    {
+        // SN3D cardioids: half of W, plus or minus half of Y
+        for (int side = 0; side < 2; ++side)
+        {
+            float sign = side == 0 ? 0.5f : -0.5f;
+            core.copyFrom(side, 0, input, 0, 0, numSamples);
+            core.applyGain(side, 0, numSamples, 0.5f);
+            core.addFrom(side, 0, input, 1, 0, numSamples, sign);
+        }
+        return;
+    }
+
+    core.clear(0, numSamples);
+
+    for (int channel = 0; channel < input.getNumChannels() && channel < static_cast<int>(taps.size()); ++channel)
+    {
+        const auto& tap = taps[static_cast<size_t>(channel)];
+        if (tap.leftGain != 0.0f)
+            core.addFrom(0, 0, input, channel, 0, numSamples, tap.leftGain);
+        if (tap.rightGain != 0.0f)
+            core.addFrom(core.getNumChannels() - 1, 0, input, channel, 0, numSamples, tap.rightGain);
+    }
+}
+
+void SurroundSpread::upmix(const juce::AudioBuffer<float>& core, juce::AudioBuffer<float>& output, int numSamples)
+{
+    const float* coreLeft = core.getReadPointer(0);
+    const float* coreRight = core.getReadPointer(core.getNumChannels() - 1);
+
+    if (foa)
+    {
+        output.clear(0, numSamples);
+        float* const* foaOutput = output.getArrayOfWritePointers();
+
+        for (int side = 0; side < 2; ++side)
+        {
+            const float* input = side == 0 ? coreLeft : coreRight;
+            auto& delays = taps[static_cast<size_t>(side)].allpassDelays;
+
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                float value = input[sample];
+                foaEncoder.addTap(2 * side, value, foaOutput, sample);
+
+                for (auto& delay : delays)
+                    value = processAllpass(delay, value);
+                foaEncoder.addTap(2 * side + 1, value, foaOutput, sample);
+            }
+        }
+        return;
+    }
+
+    for (int channel = 0; channel < output.getNumChannels() && channel < static_cast<int>(taps.size()); ++channel)
+    {
+        auto& tap = taps[static_cast<size_t>(channel)];
+        float* out = output.getWritePointer(channel);
+
+        for (int sample = 0; sample < numSamples; ++sample)
+            out[sample] = tap.leftGain * coreLeft[sample] + tap.rightGain * coreRight[sample];
+
+        if (!tap.decorrelate)
+            continue;
+
+        for (auto& delay : tap.allpassDelays)
+            for (int sample = 0; sample < numSamples; ++sample)
+                out[sample] = processAllpass(delay, out[sample]);
+    }
+}
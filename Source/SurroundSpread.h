@@ -0,0 +1,60 @@
+// Fits surround, immersive and FOA layouts around one stereo reverb: a downmix into it, and decorrelated taps out of it
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "CustomDelays.h"
+#include "FoaTapEncoder.h"
+
+/*
+The reverb runs once, in stereo, whatever the bus layout, so its cost doesn't grow with the channel count. Each
+output channel is fed from the side of the stereo core it's on; the front left and right take it as it is and every
+other channel goes through a short allpass chain of its own, so that no two speakers play the same tail. Only the
+allpasses are per channel.
+For first-order ambisonics (AmbiX), virtual cardioids pointing left and right make the core's input. Algorithms that
+can render FOA from their own delays are given the bus directly; for the rest, each side of the core is encoded with an
+allpassed copy of itself, so the field is diffuse.
+*/
+class SurroundSpread
+{
+  public:
+    // largest layout handled; 7.1.4
+    static constexpr int maxChannels = 12;
+
+    // true for the named layouts, mono to 7.1.4, and first-order ambisonics, that this can fit around a stereo reverb
+    static bool isLayoutSupported(const juce::AudioChannelSet& layout);
+
+    static bool isFoa(const juce::AudioChannelSet& layout)
+    {
+        return layout == juce::AudioChannelSet::ambisonic(1);
+    }
+
+    void prepare(const juce::AudioChannelSet& newLayout, double sampleRate);
+
+    void reset();
+
+    // left-side channels go to the left of the core and right-side ones to the right; centre channels go to both at
+    // -3 dB, and LFE isn't sent to the reverb. FOA is picked up with left and right cardioids
+    void downmix(const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& core, int numSamples) const;
+
+    // replaces output with the core spread over the layout; LFE channels are silent
+    void upmix(const juce::AudioBuffer<float>& core, juce::AudioBuffer<float>& output, int numSamples);
+
+  private:
+    struct OutputTap
+    {
+        float leftGain = 0;
+        float rightGain = 0;
+        bool decorrelate = false;
+        // delays of 3 unit-gain allpasses, up to 800 samples at 48 kHz, at up to 192 kHz; FixedAllpass's arrangement
+        // doesn't pass every frequency at the same level, which would colour the tail in these channels
+        std::array<FixedDelay<4096, 1>, 3> allpassDelays;
+    };
+
+    std::vector<OutputTap> taps;
+
+    // for FOA, taps holds one allpassed copy per side of the core
+    bool foa = false;
+    FoaTapEncoder foaEncoder;
+};
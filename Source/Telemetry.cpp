@@ -0,0 +1,205 @@
+// Opt-in per-stage timing of processBlock, passed from the audio thread through a lock-free FIFO
+
+#include <numeric>
+
+#include "Denormals.h"
+#include "Telemetry.h"
+
+juce::String Telemetry::getStageName(Stage stage)
+{
+    switch (stage)
+    {
+    case Stage::filters:
+        return "Filters";
+    case Stage::preDelay:
+        return "Pre-Delay";
+    case Stage::earlyReflections:
+        return "Early Reflections";
+    case Stage::reverb:
+        return "Reverb";
+    case Stage::mixers:
+        return "Mixers";
+    case Stage::total:
+        return "Total";
+    case Stage::numStages:
+        break;
+    }
+
+    return {};
+}
+
+//==============================================================================
+Telemetry::ScopedBlock::ScopedBlock(Telemetry& owner, int numSamples) : telemetry(owner)
+{
+    telemetry.blockEnabled = telemetry.enabled;
+    if (!telemetry.blockEnabled)
+        return;
+
+    telemetry.currentBlock = {};
+    telemetry.currentBlock.numSamples = numSamples;
+    startTicks = juce::Time::getHighResolutionTicks();
+}
+
+Telemetry::ScopedBlock::~ScopedBlock()
+{
+    if (!telemetry.blockEnabled)
+        return;
+
+    auto& block = telemetry.currentBlock;
+    block.ticks[static_cast<size_t>(Stage::total)] = juce::Time::getHighResolutionTicks() - startTicks;
+
+    // never waits on the collecting thread; a full FIFO drops the block
+    const auto scope = telemetry.fifo.write(1);
+    if (scope.blockSize1 > 0)
+        telemetry.fifoBuffer[static_cast<size_t>(scope.startIndex1)] = block;
+    else
+        ++telemetry.numDroppedBlocks;
+}
+
+Telemetry::ScopedProbe::ScopedProbe(Telemetry& owner, Stage probeStage) : telemetry(owner), stage(probeStage)
+{
+    if (telemetry.blockEnabled)
+        startTicks = juce::Time::getHighResolutionTicks();
+}
+
+Telemetry::ScopedProbe::~ScopedProbe()
+{
+    if (telemetry.blockEnabled)
+        telemetry.currentBlock.ticks[static_cast<size_t>(stage)] += juce::Time::getHighResolutionTicks() - startTicks;
+}
+
+void Telemetry::countNearSubnormals(Stage stage, const juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    if (blockEnabled)
+        currentBlock.nearSubnormals[static_cast<size_t>(stage)] += ::countNearSubnormals(buffer, numSamples);
+}
+
+//==============================================================================
+Telemetry::Telemetry() : juce::Thread("RSAlgorithmicVerb telemetry")
+{
+    fifoBuffer.resize(fifoSize);
+    for (auto& window : windows)
+        window.resize(windowSize);
+}
+
+Telemetry::~Telemetry()
+{
+    stopThread(1000);
+}
+
+void Telemetry::setEnabled(bool shouldBeEnabled)
+{
+    if (shouldBeEnabled == enabled)
+        return;
+
+    enabled = shouldBeEnabled;
+
+    if (shouldBeEnabled)
+    {
+        // start from an empty window, so the statistics only cover this session
+        {
+            const juce::ScopedLock lock(windowLock);
+            windowPosition = 0;
+            windowCount = 0;
+            nearSubnormalTotals.fill(0);
+        }
+        numDroppedBlocks = 0;
+        startThread();
+    }
+    else
+    {
+        stopThread(1000);
+    }
+}
+
+bool Telemetry::isEnabled() const
+{
+    return enabled;
+}
+
+Telemetry::Statistics Telemetry::getStatistics() const
+{
+    Statistics statistics;
+    std::vector<double> sorted;
+
+    const juce::ScopedLock lock(windowLock);
+
+    if (windowCount == 0)
+        return statistics;
+
+    for (int stage = 0; stage < numStages; ++stage)
+    {
+        const auto& window = windows[static_cast<size_t>(stage)];
+        sorted.assign(window.begin(), window.begin() + windowCount);
+        std::sort(sorted.begin(), sorted.end());
+
+        auto& stageStatistics = statistics[static_cast<size_t>(stage)];
+        stageStatistics.minMicroseconds = sorted.front();
+        stageStatistics.meanMicroseconds = std::accumulate(sorted.begin(), sorted.end(), 0.0) / windowCount;
+        stageStatistics.p99Microseconds = sorted[static_cast<size_t>((windowCount - 1) * 99 / 100)];
+        stageStatistics.numBlocks = windowCount;
+        stageStatistics.numNearSubnormals = nearSubnormalTotals[static_cast<size_t>(stage)];
+    }
+
+    return statistics;
+}
+
+int Telemetry::getNumDroppedBlocks() const
+{
+    return numDroppedBlocks;
+}
+
+bool Telemetry::dumpStatistics(const juce::File& file) const
+{
+    auto statistics = getStatistics();
+
+    juce::String text;
+    text << "stage,min_us,mean_us,p99_us,blocks,near_subnormals" << juce::newLine;
+    for (int stage = 0; stage < numStages; ++stage)
+    {
+        const auto& stageStatistics = statistics[static_cast<size_t>(stage)];
+        text << getStageName(static_cast<Stage>(stage)) << "," << juce::String(stageStatistics.minMicroseconds, 2)
+             << "," << juce::String(stageStatistics.meanMicroseconds, 2) << ","
+             << juce::String(stageStatistics.p99Microseconds, 2) << "," << stageStatistics.numBlocks << ","
+             << stageStatistics.numNearSubnormals << juce::newLine;
+    }
+    text << "dropped," << getNumDroppedBlocks() << juce::newLine;
+
+    return file.replaceWithText(text);
+}
+
+//==============================================================================
+void Telemetry::run()
+{
+    while (!threadShouldExit())
+    {
+        drain();
+        wait(drainIntervalMs);
+    }
+
+    drain();
+}
+
+void Telemetry::drain()
+{
+    const auto numReady = fifo.getNumReady();
+    if (numReady == 0)
+        return;
+
+    const double microsecondsPerTick = 1.0e6 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+
+    const juce::ScopedLock lock(windowLock);
+
+    const auto scope = fifo.read(numReady);
+    scope.forEach([this, microsecondsPerTick](int index) {
+        const auto& block = fifoBuffer[static_cast<size_t>(index)];
+        for (size_t stage = 0; stage < static_cast<size_t>(numStages); ++stage)
+        {
+            windows[stage][static_cast<size_t>(windowPosition)] = block.ticks[stage] * microsecondsPerTick;
+            nearSubnormalTotals[stage] += block.nearSubnormals[stage];
+        }
+
+        windowPosition = (windowPosition + 1) % windowSize;
+        windowCount = std::min(windowCount + 1, windowSize);
+    });
+}
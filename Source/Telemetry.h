@@ -0,0 +1,125 @@
+// Opt-in per-stage timing of processBlock, passed from the audio thread through a lock-free FIFO
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class Telemetry : private juce::Thread
+{
+  public:
+    enum class Stage
+    {
+        filters,
+        preDelay,
+        earlyReflections,
+        reverb,
+        mixers,
+        total,
+        numStages
+    };
+
+    static constexpr int numStages = static_cast<int>(Stage::numStages);
+
+    static juce::String getStageName(Stage stage);
+
+    // per-block times over the rolling window, in microseconds
+    struct StageStatistics
+    {
+        double minMicroseconds = 0;
+        double meanMicroseconds = 0;
+        double p99Microseconds = 0;
+        int numBlocks = 0;
+        // samples in the stage's output within nearSubnormalLimit of zero since telemetry was enabled (see Denormals.h)
+        juce::int64 numNearSubnormals = 0;
+    };
+
+    using Statistics = std::array<StageStatistics, numStages>;
+
+    //==============================================================================
+    // times one processBlock call; create at the top of processBlock, before any probes. Nothing is timed or pushed
+    // unless telemetry was enabled when the block started
+    class ScopedBlock
+    {
+      public:
+        ScopedBlock(Telemetry& owner, int numSamples);
+        ~ScopedBlock();
+
+      private:
+        Telemetry& telemetry;
+        juce::int64 startTicks = 0;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedBlock)
+    };
+
+    // adds the time until it goes out of scope to a stage of the current block; a stage can be probed more than once
+    class ScopedProbe
+    {
+      public:
+        ScopedProbe(Telemetry& owner, Stage probeStage);
+        ~ScopedProbe();
+
+      private:
+        Telemetry& telemetry;
+        Stage stage;
+        juce::int64 startTicks = 0;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedProbe)
+    };
+
+    // adds up the near-subnormal samples a stage left in the buffer; audio thread, and only while telemetry is enabled
+    void countNearSubnormals(Stage stage, const juce::AudioBuffer<float>& buffer, int numSamples);
+
+    //==============================================================================
+    Telemetry();
+
+    ~Telemetry() override;
+
+    // message thread only; starts or stops the thread that collects the timings
+    void setEnabled(bool shouldBeEnabled);
+
+    bool isEnabled() const;
+
+    // any thread except the audio thread
+    Statistics getStatistics() const;
+
+    // blocks lost because the FIFO was full
+    int getNumDroppedBlocks() const;
+
+    // writes the current statistics as a table; false if the file couldn't be written
+    bool dumpStatistics(const juce::File& file) const;
+
+  private:
+    struct BlockTimings
+    {
+        std::array<juce::int64, numStages> ticks{};
+        std::array<int, numStages> nearSubnormals{};
+        int numSamples = 0;
+    };
+
+    void run() override;
+
+    // moves everything waiting in the FIFO into the rolling windows
+    void drain();
+
+    static constexpr int fifoSize = 1024;
+    static constexpr int windowSize = 2048;
+    static constexpr int drainIntervalMs = 50;
+
+    std::atomic<bool> enabled{false};
+
+    // audio thread only
+    bool blockEnabled = false;
+    BlockTimings currentBlock;
+
+    // single producer, the audio thread; single consumer, the collecting thread
+    juce::AbstractFifo fifo{fifoSize};
+    std::vector<BlockTimings> fifoBuffer;
+    std::atomic<int> numDroppedBlocks{0};
+
+    // most recent block times per stage, in microseconds
+    juce::CriticalSection windowLock;
+    std::array<std::vector<double>, numStages> windows;
+    int windowPosition = 0;
+    int windowCount = 0;
+    std::array<juce::int64, numStages> nearSubnormalTotals{};
+};
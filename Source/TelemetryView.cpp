@@ -0,0 +1,87 @@
+// Editor strip showing the per-stage processBlock timings
+
+#include "TelemetryView.h"
+
+TelemetryView::TelemetryView(Telemetry& telemetryToShow) : telemetry(telemetryToShow)
+{
+    enableButton.setToggleState(telemetry.isEnabled(), juce::dontSendNotification);
+    enableButton.onClick = [this] {
+        telemetry.setEnabled(enableButton.getToggleState());
+        saveButton.setEnabled(telemetry.isEnabled());
+        repaint();
+    };
+    addAndMakeVisible(enableButton);
+
+    saveButton.setEnabled(telemetry.isEnabled());
+    saveButton.onClick = [this] { saveStatistics(); };
+    addAndMakeVisible(saveButton);
+
+    startTimerHz(refreshRateHz);
+}
+
+TelemetryView::~TelemetryView()
+{
+    stopTimer();
+}
+
+void TelemetryView::paint(juce::Graphics& g)
+{
+    if (!telemetry.isEnabled())
+        return;
+
+    // one column per stage: name above min / mean / p99 in microseconds, and any near-subnormals in its output
+    auto area = getLocalBounds().withTrimmedLeft(buttonWidth + 10);
+    const int columnWidth = area.getWidth() / Telemetry::numStages;
+
+    g.setColour(juce::Colours::aliceblue);
+    for (int stage = 0; stage < Telemetry::numStages; ++stage)
+    {
+        auto column = area.removeFromLeft(columnWidth);
+        const auto& stageStatistics = statistics[static_cast<size_t>(stage)];
+
+        g.setFont(14.0f);
+        g.drawFittedText(Telemetry::getStageName(static_cast<Telemetry::Stage>(stage)),
+                         column.removeFromTop(column.getHeight() / 2), juce::Justification::centredBottom, 1);
+
+        g.setFont(12.0f);
+        auto text = juce::String(stageStatistics.minMicroseconds, 1) + " / " +
+                    juce::String(stageStatistics.meanMicroseconds, 1) + " / " +
+                    juce::String(stageStatistics.p99Microseconds, 1) + " us";
+        if (stageStatistics.numNearSubnormals > 0)
+            text << ", " << stageStatistics.numNearSubnormals << " near-subnormal";
+        g.drawFittedText(text, column, juce::Justification::centredTop, 1);
+    }
+}
+
+void TelemetryView::resized()
+{
+    auto area = getLocalBounds().removeFromLeft(buttonWidth);
+    enableButton.setBounds(area.removeFromTop(area.getHeight() / 2).withSizeKeepingCentre(buttonWidth, buttonHeight));
+    saveButton.setBounds(area.withSizeKeepingCentre(buttonWidth, buttonHeight));
+}
+
+void TelemetryView::timerCallback()
+{
+    if (!telemetry.isEnabled())
+        return;
+
+    statistics = telemetry.getStatistics();
+    repaint();
+}
+
+void TelemetryView::saveStatistics()
+{
+    fileChooser = std::make_unique<juce::FileChooser>(
+        "Save profiling statistics",
+        juce::File::getSpecialLocation(juce::File::userDocumentsDirectory).getChildFile("RSAlgorithmicVerbStats.csv"),
+        "*.csv");
+
+    auto flags = juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::canSelectFiles |
+                 juce::FileBrowserComponent::warnAboutOverwriting;
+
+    fileChooser->launchAsync(flags, [this](const juce::FileChooser& chooser) {
+        auto file = chooser.getResult();
+        if (file != juce::File())
+            telemetry.dumpStatistics(file);
+    });
+}
@@ -0,0 +1,36 @@
+// Editor strip showing the per-stage processBlock timings
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "Telemetry.h"
+
+class TelemetryView : public juce::Component, private juce::Timer
+{
+  public:
+    explicit TelemetryView(Telemetry& telemetryToShow);
+
+    ~TelemetryView() override;
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+  private:
+    void timerCallback() override;
+
+    void saveStatistics();
+
+    static constexpr int refreshRateHz = 4;
+    static constexpr int buttonWidth = 110;
+    static constexpr int buttonHeight = 20;
+
+    Telemetry& telemetry;
+    Telemetry::Statistics statistics;
+
+    juce::ToggleButton enableButton{"Profiling"};
+    juce::TextButton saveButton{"Save Stats..."};
+    std::unique_ptr<juce::FileChooser> fileChooser;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TelemetryView)
+};
@@ -17,6 +17,21 @@ inline int wrapInt(int a, int b)
     return (c < 0) ? c + b : c;
 }
 
+// time for a recirculating loop to decay by 60 dB, from its gain per trip and the time one trip takes; capped, since a
+// loop gain of 1 never decays
+inline double loopDecayTime(double loopGain, double loopSeconds)
+{
+    constexpr double maxDecaySeconds = 60.0;
+
+    loopGain = std::abs(loopGain);
+    if (loopGain <= 0.0)
+        return 0.0;
+    if (loopGain >= 1.0)
+        return maxDecaySeconds;
+
+    return std::min(loopSeconds * -3.0 / std::log10(loopGain), maxDecaySeconds);
+}
+
 struct ReverbProcessorParameters
 {
     ReverbProcessorParameters()
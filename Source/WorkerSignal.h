@@ -0,0 +1,56 @@
+// Hands work from the audio thread to a worker that spins for a while before it sleeps
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*
+The worker waits in waitUntil() for a condition the audio thread makes true, such as a flag or a counter moving on,
+then calls notify(). The worker spins for a while first in case the work comes soon, then sleeps until notified;
+notify() is only a system call when the worker has gone to sleep, and nothing else here allocates or locks. The
+worker says it's going to sleep before checking the condition a last time, and the audio thread makes the condition
+true before checking whether it's asleep, so work handed over in between is never missed: either the worker's check
+sees it or notify() sees the worker asleep. A thread asked to exit needs its exit check in the condition, and a
+notify() once it has been asked.
+*/
+class WorkerSignal
+{
+  public:
+    static constexpr int defaultSpinIterations = 2000;
+
+    explicit WorkerSignal(int numSpinIterations = defaultSpinIterations) : spinIterations(numSpinIterations)
+    {
+    }
+
+    // on the worker; returns once condition() is true
+    template <typename Condition> void waitUntil(Condition&& condition)
+    {
+        for (int spin = 0; spin < spinIterations; ++spin)
+        {
+            if (condition())
+                return;
+            juce::Thread::yield();
+        }
+
+        sleeping.store(true);
+        // a notify() that came after the last wait returned can leave the event set, so it's waited on again if the
+        // condition still isn't true
+        while (!condition())
+            wakeEvent.wait(-1);
+        sleeping.store(false);
+    }
+
+    // on the audio thread, once the condition is true
+    void notify()
+    {
+        if (sleeping.load())
+            wakeEvent.signal();
+    }
+
+  private:
+    const int spinIterations;
+    std::atomic<bool> sleeping{false};
+    juce::WaitableEvent wakeEvent;
+
+    JUCE_DECLARE_NON_COPYABLE(WorkerSignal)
+};
@@ -0,0 +1,208 @@
+// Checks every reverb algorithm's renders against fingerprints of references from a known-good build
+
+#include "GoldenOutputTest.h"
+#include "GoldenRenders.h"
+
+#include <map>
+
+namespace
+{
+/*
+What's kept of each reference render: a few hundred numbers rather than the samples, so the references are small
+enough to commit, and loose enough to hold across compilers and CPUs whose floating point rounds differently. A change
+to the sound moves them by far more than that does.
+*/
+struct Fingerprint
+{
+    double rt60 = -1.0;
+    std::vector<double> bandLevels;
+    std::vector<std::vector<double>> envelopes;
+};
+
+struct Tolerances
+{
+    // largest difference in any octave band level, for bands within bandRangeDb of the loudest
+    double bandDb = 0.25;
+    double bandRangeDb = 60.0;
+    // largest difference in the T30 estimate, relative or in seconds, whichever is larger; the early reflections'
+    // can be a few milliseconds
+    double rt60Ratio = 0.02;
+    double rt60Seconds = 0.001;
+    // largest difference in any envelope window, for windows within envelopeRangeDb of the loudest
+    double envelopeDb = 0.5;
+    double envelopeRangeDb = 80.0;
+};
+
+Fingerprint makeFingerprint(const juce::AudioBuffer<float>& buffer)
+{
+    Fingerprint fingerprint;
+    fingerprint.rt60 = GoldenRenders::getRT60(buffer);
+    fingerprint.bandLevels = GoldenRenders::getOctaveBandLevels(buffer);
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        fingerprint.envelopes.push_back(GoldenRenders::getEnvelope(buffer, channel));
+
+    return fingerprint;
+}
+
+// fn(name, render) for every golden render, in a fixed order
+template <typename Callback> void forEachRender(Callback&& fn)
+{
+    auto processorNames = GoldenRenders::getProcessorNames();
+    for (int index = 0; index < processorNames.size(); ++index)
+    {
+        for (const auto& setting : GoldenRenders::getSettings())
+        {
+            for (const auto& inputName : GoldenRenders::getInputNames())
+            {
+                auto processor = GoldenRenders::createProcessor(index);
+                auto output =
+                    GoldenRenders::render(*processor, setting.params, GoldenRenders::makeInput(inputName));
+                fn(processorNames[index] + "_" + setting.name + "_" + inputName, output);
+            }
+        }
+    }
+}
+
+//==============================================================================
+// one line per measurement, "<render> <measurement> <values...>"; # starts a comment
+juce::String formatValues(const std::vector<double>& values)
+{
+    juce::StringArray formatted;
+    for (auto value : values)
+        formatted.add(juce::String(value, 2));
+
+    return formatted.joinIntoString(" ");
+}
+
+std::map<juce::String, Fingerprint> readFingerprints(const juce::File& file)
+{
+    std::map<juce::String, Fingerprint> fingerprints;
+
+    juce::StringArray lines;
+    file.readLines(lines);
+
+    for (const auto& line : lines)
+    {
+        auto tokens = juce::StringArray::fromTokens(line.trim(), " ", "");
+        tokens.removeEmptyStrings();
+        if (tokens.size() < 3 || tokens[0].startsWith("#"))
+            continue;
+
+        std::vector<double> values;
+        for (int token = 2; token < tokens.size(); ++token)
+            values.push_back(tokens[token].getDoubleValue());
+
+        auto& fingerprint = fingerprints[tokens[0]];
+        if (tokens[1] == "rt60")
+            fingerprint.rt60 = values.front();
+        else if (tokens[1] == "bands")
+            fingerprint.bandLevels = values;
+        else if (tokens[1].startsWith("envelope"))
+            fingerprint.envelopes.push_back(values);
+    }
+
+    return fingerprints;
+}
+
+//==============================================================================
+// largest difference from the reference, over its entries within rangeDb of its loudest
+double getLevelDifferenceDb(const std::vector<double>& reference, const std::vector<double>& output, double rangeDb)
+{
+    if (reference.size() != output.size())
+        return std::numeric_limits<double>::infinity();
+
+    double loudest = *std::max_element(reference.begin(), reference.end());
+
+    double maxDifference = 0;
+    for (size_t index = 0; index < reference.size(); ++index)
+        if (reference[index] > loudest - rangeDb)
+            maxDifference = std::max(maxDifference, std::abs(reference[index] - output[index]));
+
+    return maxDifference;
+}
+
+class GoldenOutputTest : public juce::UnitTest
+{
+  public:
+    GoldenOutputTest() : juce::UnitTest("GoldenOutput", "DSP")
+    {
+    }
+
+    void runTest() override
+    {
+        beginTest("Renders match the reference fingerprints");
+
+        auto file = getGoldenOutputReferenceFile();
+        auto references = readFingerprints(file);
+        expect(!references.empty(), "No references in " + file.getFullPathName());
+
+        Tolerances tolerances;
+
+        forEachRender([&](const juce::String& name, const juce::AudioBuffer<float>& output) {
+            auto reference = references.find(name);
+            if (reference == references.end())
+            {
+                expect(false, "No reference for " + name);
+                return;
+            }
+
+            auto fingerprint = makeFingerprint(output);
+
+            double bandDb = getLevelDifferenceDb(reference->second.bandLevels, fingerprint.bandLevels,
+                                                 tolerances.bandRangeDb);
+            expect(bandDb <= tolerances.bandDb, name + ": octave bands differ by " + juce::String(bandDb, 2) + " dB");
+
+            // a render that decays by 35 dB must still do so, and at about the same rate
+            double referenceRT60 = reference->second.rt60;
+            bool rt60Matches = referenceRT60 < 0.0 ? fingerprint.rt60 < 0.0
+                                                   : fingerprint.rt60 >= 0.0 &&
+                                                         std::abs(fingerprint.rt60 - referenceRT60) <=
+                                                             std::max(tolerances.rt60Ratio * referenceRT60,
+                                                                      tolerances.rt60Seconds);
+            expect(rt60Matches, name + ": RT60 " + juce::String(referenceRT60, 3) + " -> " +
+                                    juce::String(fingerprint.rt60, 3) + " s");
+
+            expect(reference->second.envelopes.size() == fingerprint.envelopes.size(),
+                   name + ": reference has a different number of channels");
+            for (size_t channel = 0; channel < juce::jmin(reference->second.envelopes.size(),
+                                                          fingerprint.envelopes.size());
+                 ++channel)
+            {
+                double envelopeDb = getLevelDifferenceDb(reference->second.envelopes[channel],
+                                                         fingerprint.envelopes[channel], tolerances.envelopeRangeDb);
+                expect(envelopeDb <= tolerances.envelopeDb, name + ": channel " + juce::String(channel) +
+                                                                " envelope differs by " +
+                                                                juce::String(envelopeDb, 2) + " dB");
+            }
+        });
+    }
+};
+
+GoldenOutputTest goldenOutputTest;
+} // namespace
+
+juce::File getGoldenOutputReferenceFile()
+{
+    return juce::File(RSAV_TEST_REFERENCES_DIR).getChildFile("GoldenOutput.txt");
+}
+
+bool writeGoldenOutputReferences(const juce::File& file)
+{
+    juce::String text;
+    text << "# Fingerprints of the golden renders (see Tests/GoldenRenders.h): RT60 in seconds, octave band levels "
+            "and per-channel "
+         << juce::String(GoldenRenders::envelopeSeconds, 1)
+         << " s envelopes in dB. Rewrite with RSAlgorithmicVerbTests --write-references\n";
+
+    forEachRender([&](const juce::String& name, const juce::AudioBuffer<float>& output) {
+        auto fingerprint = makeFingerprint(output);
+
+        text << name << " rt60 " << juce::String(fingerprint.rt60, 4) << "\n";
+        text << name << " bands " << formatValues(fingerprint.bandLevels) << "\n";
+        for (size_t channel = 0; channel < fingerprint.envelopes.size(); ++channel)
+            text << name << " envelope" << juce::String(channel) << " " << formatValues(fingerprint.envelopes[channel])
+                 << "\n";
+    });
+
+    return file.getParentDirectory().createDirectory().wasOk() && file.replaceWithText(text, false, false, "\n");
+}
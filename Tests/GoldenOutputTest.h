@@ -0,0 +1,11 @@
+// Checks every reverb algorithm's renders against fingerprints of references from a known-good build
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// the committed references, under RSAV_TEST_REFERENCES_DIR
+juce::File getGoldenOutputReferenceFile();
+
+// renders everything again and replaces the references with their fingerprints; false if the file can't be written
+bool writeGoldenOutputReferences(const juce::File& file);
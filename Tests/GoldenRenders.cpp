@@ -0,0 +1,197 @@
+// Fixed inputs rendered through every reverb algorithm, and the measurements the golden output checks compare
+
+#include "GoldenRenders.h"
+#include "EarlyReflections.h"
+#include "ProcessorFactory.h"
+#include "Utilities.h"
+
+#include <random>
+
+namespace
+{
+constexpr double noiseBurstSeconds = 0.1;
+constexpr int fftOrder = 12;
+constexpr int fftSize = 1 << fftOrder;
+
+// unscaled, as the plugin passes them to setParameters; damping is the knob value mapped as in processBlock
+ReverbProcessorParameters makeParameters(float roomSize, float decayTime, float damping, float diffusion,
+                                         float modRate, float modDepth)
+{
+    ReverbProcessorParameters params;
+    params.roomSize = roomSize;
+    params.decayTime = decayTime;
+    params.damping = scale(damping * -1.0f + 1.0f, 0.0f, 1.0f, 200.0f, 20000.0f);
+    params.diffusion = diffusion;
+    params.modRate = modRate;
+    params.modDepth = modDepth;
+    return params;
+}
+} // namespace
+
+juce::StringArray GoldenRenders::getProcessorNames()
+{
+    auto names = ProcessorFactory::getProcessorNames();
+    names.add("EarlyReflections");
+    return names;
+}
+
+std::unique_ptr<ReverbProcessorBase> GoldenRenders::createProcessor(int index)
+{
+    ProcessorFactory processorFactory;
+    if (index >= processorFactory.getNumProcessors())
+        return std::make_unique<EarlyReflections>();
+
+    return processorFactory.create(index);
+}
+
+std::vector<GoldenSetting> GoldenRenders::getSettings()
+{
+    return {{"default", makeParameters(0.5f, 0.35f, 0.5f, 0.67f, 2.25f, 0.5f)},
+            {"small", makeParameters(0.1f, 0.2f, 0.2f, 0.3f, 0.5f, 0.0f)},
+            {"large", makeParameters(0.9f, 0.85f, 0.7f, 0.8f, 4.0f, 1.0f)}};
+}
+
+juce::StringArray GoldenRenders::getInputNames()
+{
+    return {"impulse", "noise"};
+}
+
+juce::AudioBuffer<float> GoldenRenders::makeInput(const juce::String& inputName, double rate)
+{
+    juce::AudioBuffer<float> input(numChannels, static_cast<int>(renderSeconds * rate));
+    input.clear();
+
+    if (inputName == "impulse")
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            input.setSample(channel, 0, 1.0f);
+    }
+    else
+    {
+        // independent white noise per channel, then silence so the tail is rendered too; minstd_rand's sequence is
+        // fixed by the standard, so committed references hold on every platform
+        std::minstd_rand random(1);
+        int burstSamples = static_cast<int>(noiseBurstSeconds * rate);
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            for (int sample = 0; sample < burstSamples; ++sample)
+            {
+                float unit = static_cast<float>(random() - std::minstd_rand::min()) /
+                             static_cast<float>(std::minstd_rand::max() - std::minstd_rand::min());
+                input.setSample(channel, sample, unit * 0.5f - 0.25f);
+            }
+        }
+    }
+
+    return input;
+}
+
+juce::AudioBuffer<float> GoldenRenders::render(ReverbProcessorBase& processor, const ReverbProcessorParameters& params,
+                                               const juce::AudioBuffer<float>& input, double rate)
+{
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate = rate;
+    spec.maximumBlockSize = static_cast<juce::uint32>(blockSize);
+    spec.numChannels = static_cast<juce::uint32>(numChannels);
+
+    processor.prepare(spec);
+    processor.setParameters(params);
+
+    // the plugin's callback runs the algorithms with flush-to-zero on
+    juce::ScopedNoDenormals noDenormals;
+
+    juce::AudioBuffer<float> output(numChannels, input.getNumSamples());
+    juce::AudioBuffer<float> block(numChannels, blockSize);
+    juce::MidiBuffer midiMessages;
+
+    for (int start = 0; start < input.getNumSamples(); start += blockSize)
+    {
+        int numSamples = juce::jmin(blockSize, input.getNumSamples() - start);
+        block.setSize(numChannels, numSamples, false, false, true);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            block.copyFrom(channel, 0, input, channel, start, numSamples);
+
+        processor.processBlock(block, midiMessages);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            output.copyFrom(channel, start, block, channel, 0, numSamples);
+    }
+
+    return output;
+}
+
+std::vector<double> GoldenRenders::getOctaveBandLevels(const juce::AudioBuffer<float>& buffer, double rate)
+{
+    juce::dsp::FFT fft(fftOrder);
+    std::vector<float> frame(2 * fftSize);
+    std::vector<double> power(fftSize / 2 + 1, 0.0);
+
+    for (int start = 0; start + fftSize <= buffer.getNumSamples(); start += fftSize)
+    {
+        std::fill(frame.begin(), frame.end(), 0.0f);
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            juce::FloatVectorOperations::add(frame.data(), buffer.getReadPointer(channel, start), fftSize);
+
+        fft.performFrequencyOnlyForwardTransform(frame.data());
+        for (size_t bin = 0; bin < power.size(); ++bin)
+            power[bin] += static_cast<double>(frame[bin]) * frame[bin];
+    }
+
+    std::vector<double> levels;
+    double binHz = rate / fftSize;
+    for (double centreHz = 31.25; centreHz < rate / 2; centreHz *= 2.0)
+    {
+        auto lowBin = static_cast<size_t>(std::ceil(centreHz / std::sqrt(2.0) / binHz));
+        auto highBin = std::min(power.size(), static_cast<size_t>(std::ceil(centreHz * std::sqrt(2.0) / binHz)));
+
+        double energy = 0;
+        for (size_t bin = lowBin; bin < highBin; ++bin)
+            energy += power[bin];
+
+        levels.push_back(10.0 * std::log10(energy + 1.0e-20));
+    }
+
+    return levels;
+}
+
+double GoldenRenders::getRT60(const juce::AudioBuffer<float>& buffer, double rate)
+{
+    int numSamples = buffer.getNumSamples();
+    std::vector<double> decayCurve(static_cast<size_t>(numSamples) + 1, 0.0);
+
+    for (int sample = numSamples - 1; sample >= 0; --sample)
+    {
+        double sum = 0;
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            sum += buffer.getSample(channel, sample);
+        decayCurve[static_cast<size_t>(sample)] = decayCurve[static_cast<size_t>(sample) + 1] + sum * sum;
+    }
+
+    if (decayCurve[0] <= 0.0)
+        return -1.0;
+
+    int start = -1;
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        double levelDb = 10.0 * std::log10(decayCurve[static_cast<size_t>(sample)] / decayCurve[0] + 1.0e-30);
+        if (start < 0 && levelDb <= -5.0)
+            start = sample;
+        if (levelDb <= -35.0)
+            return 2.0 * (sample - start) / rate;
+    }
+
+    return -1.0;
+}
+
+std::vector<double> GoldenRenders::getEnvelope(const juce::AudioBuffer<float>& buffer, int channel)
+{
+    int windowSamples = static_cast<int>(envelopeSeconds * sampleRate);
+
+    std::vector<double> envelope;
+    for (int start = 0; start + windowSamples <= buffer.getNumSamples(); start += windowSamples)
+        envelope.push_back(juce::Decibels::gainToDecibels(
+            static_cast<double>(buffer.getRMSLevel(channel, start, windowSamples)), -200.0));
+
+    return envelope;
+}
@@ -0,0 +1,55 @@
+// Fixed inputs rendered through every reverb algorithm, and the measurements the golden output checks compare
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "ProcessorBase.h"
+
+struct GoldenSetting
+{
+    juce::String name;
+    ReverbProcessorParameters params;
+};
+
+/*
+The renders that guard against changes to the sound: an impulse and a burst of noise through every algorithm and the
+early reflections, at three settings. Everything here is fixed so that renders from different builds stay comparable;
+the odd block size puts block boundaries at different points in every delay.
+*/
+struct GoldenRenders
+{
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 237;
+    static constexpr int numChannels = 2;
+    static constexpr double renderSeconds = 3.0;
+
+    // every factory algorithm, then the early reflections
+    static juce::StringArray getProcessorNames();
+
+    // by index into getProcessorNames()
+    static std::unique_ptr<ReverbProcessorBase> createProcessor(int index);
+
+    static std::vector<GoldenSetting> getSettings();
+
+    static juce::StringArray getInputNames();
+
+    // renderSeconds of the named input, the same on every platform
+    static juce::AudioBuffer<float> makeInput(const juce::String& inputName, double rate = sampleRate);
+
+    // processor's output for the input, in blocks of blockSize with flush-to-zero on, as the plugin runs it
+    static juce::AudioBuffer<float> render(ReverbProcessorBase& processor, const ReverbProcessorParameters& params,
+                                           const juce::AudioBuffer<float>& input, double rate = sampleRate);
+
+    // energy of the channel sum in octave bands centred on 31.25 Hz up to the highest below Nyquist, in dB
+    static std::vector<double> getOctaveBandLevels(const juce::AudioBuffer<float>& buffer, double rate = sampleRate);
+
+    // T30 from the Schroeder backward integral of the channel sum, in seconds; negative if the render doesn't decay by
+    // 35 dB
+    static double getRT60(const juce::AudioBuffer<float>& buffer, double rate = sampleRate);
+
+    // RMS of one channel over consecutive windows of envelopeSeconds, in dB
+    static std::vector<double> getEnvelope(const juce::AudioBuffer<float>& buffer, int channel);
+
+    static constexpr double envelopeSeconds = 0.1;
+};
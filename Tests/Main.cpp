@@ -0,0 +1,49 @@
+// Runs the DSP tests; CTest runs each one on its own, and any failure makes the exit code non-zero
+
+#include <JuceHeader.h>
+
+#include "GoldenOutputTest.h"
+
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    // after a deliberate change to the sound, from a build known to be good
+    if (args.containsOption("--write-references"))
+    {
+        auto file = getGoldenOutputReferenceFile();
+        if (!writeGoldenOutputReferences(file))
+        {
+            std::cerr << "Couldn't write " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        std::cout << "wrote " << file.getFullPathName() << std::endl;
+        return 0;
+    }
+
+    // every test, or the one named by --test
+    auto testName = args.getValueForOption("--test");
+    juce::Array<juce::UnitTest*> tests;
+    for (auto* test : juce::UnitTest::getAllTests())
+        if (testName.isEmpty() || test->getName() == testName)
+            tests.add(test);
+
+    if (tests.isEmpty())
+    {
+        std::cerr << "No test named " << testName << std::endl;
+        return 1;
+    }
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    runner.runTests(tests);
+
+    int numFailures = 0;
+    for (int result = 0; result < runner.getNumResults(); ++result)
+        numFailures += runner.getResult(result)->failures;
+
+    return numFailures > 0 ? 1 : 0;
+}
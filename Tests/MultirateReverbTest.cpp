@@ -0,0 +1,133 @@
+// Checks that an algorithm run at a lower internal rate keeps the room it has at the host rate
+
+#include "GoldenRenders.h"
+#include "MultirateReverb.h"
+#include "ProcessorFactory.h"
+
+namespace
+{
+/*
+The host rate's render is passed through the same halfband filters as the lower rate's, with nothing in between, so
+that what they take off the top by design isn't counted as a difference. The bands compared stop an octave below the
+internal rate's Nyquist, where the damping filters' bilinear warping would differ anyway.
+*/
+struct Tolerances
+{
+    // largest difference in any octave band level, for bands centred at or below highestBandHz and within bandRangeDb of
+    // the loudest
+    double bandDb = 2.0;
+    double bandRangeDb = 40.0;
+    double highestBandHz = 8000.0;
+    // largest relative difference in the T30 estimate; a room the wrong size is out by the rate factor
+    double rt60Ratio = 0.1;
+};
+
+// a processor that leaves its input as it is, to run through the halfband filters alone
+class PassThrough : public ReverbProcessorBase
+{
+  public:
+    void prepare(const juce::dsp::ProcessSpec&) override
+    {
+    }
+
+    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override
+    {
+    }
+
+    void reset() override
+    {
+    }
+
+    ReverbProcessorParameters& getParameters() override
+    {
+        return parameters;
+    }
+
+    void setParameters(const ReverbProcessorParameters& params) override
+    {
+        parameters = params;
+    }
+
+    double getTailLengthSeconds() override
+    {
+        return 0.0;
+    }
+
+  private:
+    ReverbProcessorParameters parameters;
+};
+
+class MultirateReverbTest : public juce::UnitTest
+{
+  public:
+    MultirateReverbTest() : juce::UnitTest("MultirateReverb", "DSP")
+    {
+    }
+
+    void runTest() override
+    {
+        Tolerances tolerances;
+        auto processorNames = ProcessorFactory::getProcessorNames();
+
+        // the rates Auto runs at: half of 96 kHz and a quarter of 192 kHz, both 48 kHz inside
+        for (int factor : {2, 4})
+        {
+            double hostRate = 48000.0 * factor;
+            beginTest("Every algorithm at 1/" + juce::String(factor) + " of " + juce::String(hostRate / 1000.0, 0) +
+                      " kHz matches the host rate");
+
+            auto input = GoldenRenders::makeInput("noise", hostRate);
+
+            for (int index = 0; index < processorNames.size(); ++index)
+            {
+                for (const auto& setting : GoldenRenders::getSettings())
+                {
+                    // the small setting's damping is close to the internal rate's Nyquist
+                    if (setting.name == "small")
+                        continue;
+
+                    ProcessorFactory processorFactory;
+                    auto hostProcessor = processorFactory.create(index);
+                    MultirateReverb multirateProcessor(processorFactory.create(index), factor);
+                    MultirateReverb filtersOnly(std::make_unique<PassThrough>(), factor);
+
+                    auto hostOutput = GoldenRenders::render(
+                        filtersOnly, setting.params, GoldenRenders::render(*hostProcessor, setting.params, input, hostRate),
+                        hostRate);
+                    auto multirateOutput = GoldenRenders::render(multirateProcessor, setting.params, input, hostRate);
+
+                    auto name = processorNames[index] + "_" + setting.name;
+                    checkBands(name, GoldenRenders::getOctaveBandLevels(hostOutput, hostRate),
+                               GoldenRenders::getOctaveBandLevels(multirateOutput, hostRate), tolerances);
+
+                    double hostRT60 = GoldenRenders::getRT60(hostOutput, hostRate);
+                    double multirateRT60 = GoldenRenders::getRT60(multirateOutput, hostRate);
+                    expect(hostRT60 > 0.0 && std::abs(multirateRT60 - hostRT60) <= tolerances.rt60Ratio * hostRT60,
+                           name + ": RT60 " + juce::String(hostRT60, 3) + " s at the host rate, " +
+                               juce::String(multirateRT60, 3) + " s at 1/" + juce::String(factor));
+                }
+            }
+        }
+    }
+
+  private:
+    void checkBands(const juce::String& name, const std::vector<double>& hostBands,
+                    const std::vector<double>& multirateBands, const Tolerances& tolerances)
+    {
+        double loudest = *std::max_element(hostBands.begin(), hostBands.end());
+
+        double centreHz = 31.25;
+        for (size_t band = 0; band < hostBands.size() && centreHz <= tolerances.highestBandHz; ++band, centreHz *= 2.0)
+        {
+            if (hostBands[band] <= loudest - tolerances.bandRangeDb)
+                continue;
+
+            double difference = std::abs(multirateBands[band] - hostBands[band]);
+            expect(difference <= tolerances.bandDb, name + ": " + juce::String(centreHz, 0) + " Hz band differs by " +
+                                                        juce::String(difference, 2) + " dB");
+        }
+    }
+};
+
+MultirateReverbTest multirateReverbTest;
+} // namespace
@@ -0,0 +1,64 @@
+// Checks that no algorithm reports a shorter tail than its renders measure
+
+#include "GoldenRenders.h"
+
+namespace
+{
+/*
+Hosts stop calling the plugin once the reported tail has passed, so an estimate that runs short cuts the reverb off;
+one that runs long only costs a little processing. The impulse is rendered for twice the estimate, so that a tail
+longer than that shows up in the T30, but no longer than maxRenderSeconds; an estimate past that (the longest loops
+report loopDecayTime's cap) only has to be longer than whatever the render measures.
+*/
+constexpr double minRenderSeconds = GoldenRenders::renderSeconds;
+constexpr double maxRenderSeconds = 30.0;
+
+juce::AudioBuffer<float> makeImpulse(double seconds)
+{
+    juce::AudioBuffer<float> impulse(GoldenRenders::numChannels, static_cast<int>(seconds * GoldenRenders::sampleRate));
+    impulse.clear();
+    for (int channel = 0; channel < impulse.getNumChannels(); ++channel)
+        impulse.setSample(channel, 0, 1.0f);
+
+    return impulse;
+}
+
+class TailLengthTest : public juce::UnitTest
+{
+  public:
+    TailLengthTest() : juce::UnitTest("TailLength", "DSP")
+    {
+    }
+
+    void runTest() override
+    {
+        beginTest("Every algorithm's tail estimate covers its measured RT60");
+
+        auto processorNames = GoldenRenders::getProcessorNames();
+        for (int index = 0; index < processorNames.size(); ++index)
+        {
+            for (const auto& setting : GoldenRenders::getSettings())
+            {
+                auto processor = GoldenRenders::createProcessor(index);
+
+                // some estimates depend on the rate, so the processor is prepared by a first render
+                GoldenRenders::render(*processor, setting.params, makeImpulse(minRenderSeconds));
+                double estimate = processor->getTailLengthSeconds();
+
+                double renderSeconds = juce::jlimit(minRenderSeconds, maxRenderSeconds, 2.0 * estimate);
+                double rt60 = GoldenRenders::getRT60(
+                    GoldenRenders::render(*processor, setting.params, makeImpulse(renderSeconds)));
+
+                auto name = processorNames[index] + "_" + setting.name;
+                expect(rt60 > 0.0 || estimate >= renderSeconds,
+                       name + ": no 35 dB decay in " + juce::String(renderSeconds, 1) + " s, tail estimate " +
+                           juce::String(estimate, 3) + " s");
+                expect(rt60 <= estimate, name + ": RT60 " + juce::String(rt60, 3) + " s, tail estimate " +
+                                             juce::String(estimate, 3) + " s");
+            }
+        }
+    }
+};
+
+TailLengthTest tailLengthTest;
+} // namespace
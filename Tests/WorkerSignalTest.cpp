@@ -0,0 +1,83 @@
+// Checks that a worker waiting on a WorkerSignal never misses the work it's handed
+
+#include "WorkerSignal.h"
+
+#include <thread>
+
+namespace
+{
+/*
+A worker thread waits for a counter to move on and acknowledges each step. The test hands over numRounds steps, and a
+step that isn't acknowledged within timeoutMs is a lost wakeup: the worker went to sleep with the step already handed
+over, and nothing woke it. With no spinning every wait ends in sleep, so each handover races the worker's last check
+before it sleeps; the random gaps between handovers put them at every point of the worker's wait.
+*/
+constexpr int numRounds = 5000;
+constexpr double timeoutMs = 1000.0;
+constexpr int maxGapYields = 200;
+
+class WorkerSignalTest : public juce::UnitTest
+{
+  public:
+    WorkerSignalTest() : juce::UnitTest("WorkerSignal", "Threads")
+    {
+    }
+
+    void runTest() override
+    {
+        beginTest("No handover is missed by a worker that always sleeps");
+        checkHandovers(0);
+
+        beginTest("No handover is missed by a worker that spins first");
+        checkHandovers(WorkerSignal::defaultSpinIterations);
+    }
+
+  private:
+    void checkHandovers(int spinIterations)
+    {
+        WorkerSignal signal(spinIterations);
+        std::atomic<int> requested{0};
+        std::atomic<int> acknowledged{0};
+        std::atomic<bool> shouldExit{false};
+
+        std::thread worker([&] {
+            int seen = 0;
+            while (!shouldExit.load())
+            {
+                signal.waitUntil([&] { return requested.load() != seen || shouldExit.load(); });
+                seen = requested.load();
+                acknowledged.store(seen);
+            }
+        });
+
+        juce::Random random(1);
+        int missedRound = 0;
+        for (int round = 1; round <= numRounds && missedRound == 0; ++round)
+        {
+            for (int gap = random.nextInt(maxGapYields); gap > 0; --gap)
+                juce::Thread::yield();
+
+            requested.store(round);
+            signal.notify();
+
+            double start = juce::Time::getMillisecondCounterHiRes();
+            while (acknowledged.load() != round && missedRound == 0)
+            {
+                if (juce::Time::getMillisecondCounterHiRes() - start > timeoutMs)
+                    missedRound = round;
+                juce::Thread::yield();
+            }
+        }
+
+        // wakes the worker even if it missed a round and is still asleep
+        shouldExit.store(true);
+        signal.notify();
+        worker.join();
+
+        expect(missedRound == 0, "handover " + juce::String(missedRound) + " of " + juce::String(numRounds) +
+                                     " not picked up within " + juce::String(timeoutMs, 0) + " ms");
+    }
+};
+
+WorkerSignalTest workerSignalTest;
+} // namespace